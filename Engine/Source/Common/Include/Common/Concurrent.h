@@ -6,12 +6,16 @@
 
 #include <string>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <mutex>
+#include <atomic>
+#include <latch>
 #include <thread>
 #include <future>
+#include <cstddef>
 #include <functional>
 #include <type_traits>
+#include <condition_variable>
 
 #include <Common/Debug.h>
 #include <Common/Memory.h>
@@ -27,29 +31,116 @@ namespace Common {
         template <typename F> explicit NamedThread(const std::string& name, F&& task);
 
         void Join();
+        // names the calling thread, for threads not created by NamedThread, e.g. workers of a third party executor
+        static void SetCurrentThreadName(const std::string& name);
 
     private:
-        void SetThreadName(const std::string& name);
-
         std::thread thread;
     };
 
+    // move-only void() callable, callables not larger than inlineSize are stored inplace without heap allocation
+    class Task {
+    public:
+        static constexpr size_t inlineSize = 40;
+
+        Task();
+        template <typename F> explicit Task(F&& inFunc);
+        Task(Task&& inOther) noexcept;
+        Task& operator=(Task&& inOther) noexcept;
+        ~Task();
+        NonCopyable(Task)
+
+        explicit operator bool() const;
+        void operator()();
+
+    private:
+        struct Ops {
+            void(*invoke)(void*);
+            void(*moveConstruct)(void*, void*);
+            void(*destruct)(void*);
+        };
+
+        template <typename F> static constexpr bool storeInplace = sizeof(F) <= inlineSize && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>;
+        template <typename F> static const Ops* GetOps();
+        void Reset();
+
+        alignas(std::max_align_t) std::byte storage[inlineSize];
+        const Ops* ops;
+    };
+
+    // bounded lock-free multi-producer multi-consumer queue (Vyukov), each cell carries a sequence number,
+    // so producers and consumers only contend on one atomic index each, capacity must be a power of two
+    template <typename T>
+    class BoundedConcurrentQueue {
+    public:
+        explicit BoundedConcurrentQueue(size_t inCapacity);
+        NonCopyable(BoundedConcurrentQueue)
+        NonMovable(BoundedConcurrentQueue)
+
+        // inValue is only moved from when returning true
+        bool TryPush(T&& inValue);
+        bool TryPop(T& outValue);
+        // checks the published sequence of the head cell, a value claimed by a producer but not published yet is not
+        // counted, so a consumer seeing false has something to pop unless another consumer takes it first
+        bool Empty() const;
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        static constexpr size_t cacheLineSize = 64;
+
+        const size_t mask;
+        std::vector<Cell> cells;
+        alignas(cacheLineSize) std::atomic<size_t> enqueuePos;
+        alignas(cacheLineSize) std::atomic<size_t> dequeuePos;
+    };
+
+    // task queue shared by producers and the threads executing tasks, pushing a task only takes a lock when the ring is
+    // full, consumers only lock when going to sleep, producers only lock to wake sleeping consumers up
+    class TaskQueue {
+    public:
+        static constexpr size_t defaultCapacity = 8192;
+
+        explicit TaskQueue(size_t inCapacity = defaultCapacity);
+        NonCopyable(TaskQueue)
+        NonMovable(TaskQueue)
+
+        // never waits for consumers, a task executed by a consumer may push to its own full queue, tasks pushed while the
+        // ring is full go to an overflow list, and later tasks are queued behind them to keep the FIFO order
+        void Push(Task&& inTask);
+        // blocks until a task is popped, or returns false when queue is stopped and empty
+        bool Pop(Task& outTask);
+        void Stop();
+
+    private:
+        bool TryPopOverflow(Task& outTask);
+
+        BoundedConcurrentQueue<Task> tasks;
+        std::atomic<size_t> overflowNum;
+        std::mutex overflowMutex;
+        std::deque<Task> overflowTasks;
+        std::atomic<bool> stop;
+        std::atomic<uint32_t> sleepingNum;
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
     class ThreadPool {
     public:
         ThreadPool(const std::string& name, uint8_t threadNum);
         ~ThreadPool();
 
         template <typename F> auto EmplaceTask(F&& task);
+        // fire-and-forget, no future is created, small tasks are queued without any heap allocation
+        template <typename F> void EmplaceDetachedTask(F&& task);
         template <typename F> void ExecuteTasks(size_t taskNum, F&& task);
 
     private:
-        template <typename Ret> auto EmplaceTaskInternal(Common::SharedPtr<std::packaged_task<Ret()>> packedTask);
-
-        bool stop;
-        std::mutex mutex;
-        std::condition_variable condition;
+        TaskQueue tasks;
         std::vector<NamedThread> threads;
-        std::queue<std::function<void()>> tasks;
     };
 
     class WorkerThread {
@@ -60,15 +151,12 @@ namespace Common {
         void Flush();
 
         template <typename F> auto EmplaceTask(F&& task);
+        // fire-and-forget, no future is created, small tasks are queued without any heap allocation
+        template <typename F> void EmplaceDetachedTask(F&& task);
 
     private:
-        bool stop;
-        bool flush;
-        std::mutex mutex;
-        std::condition_variable taskCondition;
-        std::condition_variable flushCondition;
+        TaskQueue tasks;
         NamedThread thread;
-        std::queue<std::function<void()>> tasks;
     };
 }
 
@@ -77,59 +165,158 @@ namespace Common {
     NamedThread::NamedThread(const std::string& name, F&& task)
     {
         thread = std::thread([this, task, name]() -> void {
-            SetThreadName(name);
+            SetCurrentThreadName(name);
             task();
         });
     }
 
     template <typename F>
-    auto ThreadPool::EmplaceTask(F&& task)
+    Task::Task(F&& inFunc)
+        : ops(GetOps<std::decay_t<F>>())
     {
-        using RetType = std::invoke_result_t<F>;
-        return EmplaceTaskInternal<RetType>(Common::MakeShared<std::packaged_task<RetType()>>(task));
+        using FuncType = std::decay_t<F>;
+        if constexpr (storeInplace<FuncType>) {
+            new (storage) FuncType(std::forward<F>(inFunc));
+        } else {
+            new (storage) FuncType*(new FuncType(std::forward<F>(inFunc)));
+        }
     }
 
     template <typename F>
-    void ThreadPool::ExecuteTasks(size_t taskNum, F&& task)
+    const Task::Ops* Task::GetOps()
     {
-        using RetType = std::invoke_result_t<F, size_t>;
+        if constexpr (storeInplace<F>) {
+            static constexpr Ops ops = {
+                [](void* inStorage) -> void { (*static_cast<F*>(inStorage))(); },
+                [](void* inDst, void* inSrc) -> void {
+                    new (inDst) F(std::move(*static_cast<F*>(inSrc)));
+                    static_cast<F*>(inSrc)->~F();
+                },
+                [](void* inStorage) -> void { static_cast<F*>(inStorage)->~F(); }
+            };
+            return &ops;
+        } else {
+            static constexpr Ops ops = {
+                [](void* inStorage) -> void { (**static_cast<F**>(inStorage))(); },
+                [](void* inDst, void* inSrc) -> void { new (inDst) F*(*static_cast<F**>(inSrc)); },
+                [](void* inStorage) -> void { delete *static_cast<F**>(inStorage); }
+            };
+            return &ops;
+        }
+    }
 
-        std::vector<std::future<RetType>> futures;
-        futures.reserve(taskNum);
-        for (size_t i = 0; i < taskNum; i++) {
-            futures.emplace_back(EmplaceTaskInternal<RetType>(Common::MakeShared<std::packaged_task<RetType()>>(std::bind(std::forward<F>(task), i))));
+    template <typename T>
+    BoundedConcurrentQueue<T>::BoundedConcurrentQueue(size_t inCapacity)
+        : mask(inCapacity - 1)
+        , cells(inCapacity)
+        , enqueuePos(0)
+        , dequeuePos(0)
+    {
+        Assert(inCapacity >= 2 && (inCapacity & mask) == 0);
+        for (size_t i = 0; i < inCapacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
         }
+    }
 
-        for (const auto& future : futures) {
-            future.wait();
+    template <typename T>
+    bool BoundedConcurrentQueue<T>::TryPush(T&& inValue)
+    {
+        Cell* cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
         }
+        cell->value = std::move(inValue);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
     }
 
-    template <typename Ret>
-    auto ThreadPool::EmplaceTaskInternal(Common::SharedPtr<std::packaged_task<Ret()>> packedTask)
+    template <typename T>
+    bool BoundedConcurrentQueue<T>::TryPop(T& outValue)
     {
-        auto result = packedTask->get_future();
-        {
-            std::unique_lock lock(mutex);
-            Assert(!stop);
-            tasks.emplace([packedTask]() -> void { (*packedTask)(); });
+        Cell* cell;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        while (true) {
+            cell = &cells[pos & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
         }
-        condition.notify_one();
+        outValue = std::move(cell->value);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool BoundedConcurrentQueue<T>::Empty() const
+    {
+        // seq_cst loads, they pair with the fence TaskQueue::Push() issues after publishing before checking sleepers
+        const size_t pos = dequeuePos.load();
+        const size_t sequence = cells[pos & mask].sequence.load();
+        return static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1) < 0;
+    }
+
+    template <typename F>
+    auto ThreadPool::EmplaceTask(F&& task)
+    {
+        using RetType = std::invoke_result_t<F>;
+        std::packaged_task<RetType()> packagedTask(std::forward<F>(task));
+        auto result = packagedTask.get_future();
+        tasks.Push(Task(std::move(packagedTask)));
         return result;
     }
 
+    template <typename F>
+    void ThreadPool::EmplaceDetachedTask(F&& task)
+    {
+        tasks.Push(Task(std::forward<F>(task)));
+    }
+
+    template <typename F>
+    void ThreadPool::ExecuteTasks(size_t taskNum, F&& task)
+    {
+        std::latch latch(static_cast<std::ptrdiff_t>(taskNum));
+        for (size_t i = 0; i < taskNum; i++) {
+            tasks.Push(Task([&task, &latch, i]() -> void {
+                task(i);
+                latch.count_down();
+            }));
+        }
+        latch.wait();
+    }
+
     template <typename F>
     auto WorkerThread::EmplaceTask(F&& task)
     {
         using RetType = std::invoke_result_t<F>;
-        auto packagedTask = Common::MakeShared<std::packaged_task<RetType()>>(task);
-        auto result = packagedTask->get_future();
-        {
-            std::unique_lock lock(mutex);
-            Assert(!stop);
-            tasks.emplace([packagedTask]() -> void { (*packagedTask)(); });
-        }
-        taskCondition.notify_one();
+        std::packaged_task<RetType()> packagedTask(std::forward<F>(task));
+        auto result = packagedTask.get_future();
+        tasks.Push(Task(std::move(packagedTask)));
         return result;
     }
+
+    template <typename F>
+    void WorkerThread::EmplaceDetachedTask(F&& task)
+    {
+        tasks.Push(Task(std::forward<F>(task)));
+    }
 }
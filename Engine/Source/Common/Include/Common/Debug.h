@@ -16,7 +16,11 @@
 namespace Common {
     class Debug {
     public:
+        using AssertFailHandler = void(*)();
+
         static void AssertImpl(bool expression, const std::string& name, const std::string& file, uint32_t line, const std::string& reason = "");
+        // called when an assert fails before breaking, e.g. to flush logs that have not been written yet
+        static void SetAssertFailHandler(AssertFailHandler inHandler);
 
         ~Debug();
 
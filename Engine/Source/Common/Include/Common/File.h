@@ -5,9 +5,12 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 
 #include <rapidjson/document.h>
 
+#include <Common/Utility.h>
+
 namespace Common {
     class FileUtils {
     public:
@@ -15,4 +18,21 @@ namespace Common {
         static rapidjson::Document ReadJsonFile(const std::string& inFileName);
         static void WriteJsonFile(const std::string& inFileName, const rapidjson::Document& inJsonDocument, bool inPretty = true);
     };
+
+    // whole file mapped read-only into address space, pages are loaded by os on first touch
+    class MappedFile {
+    public:
+        NonCopyable(MappedFile)
+        explicit MappedFile(const std::string& inFileName);
+        ~MappedFile();
+
+        bool Valid() const;
+        const uint8_t* Data() const;
+        size_t Size() const;
+
+    private:
+        bool valid;
+        const uint8_t* data;
+        size_t size;
+    };
 }
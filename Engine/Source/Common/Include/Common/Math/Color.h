@@ -69,6 +69,18 @@ namespace Common {
 }
 
 namespace Common {
+    template <>
+    struct BulkSerializeTraits<Color> {
+        static constexpr bool bulk = sizeof(Color) == sizeof(uint8_t) * 4;
+        using Scalar = uint8_t;
+    };
+
+    template <>
+    struct BulkSerializeTraits<LinearColor> {
+        static constexpr bool bulk = sizeof(LinearColor) == sizeof(float) * 4;
+        using Scalar = float;
+    };
+
     template <>
     struct Serializer<Color> {
         static constexpr size_t typeId = HashUtils::StrCrc32("Common::Color");
@@ -302,6 +302,12 @@ namespace Common {
 }
 
 namespace Common { // NOLINT
+    template <CppArithmeticNonBool T, uint8_t R, uint8_t C>
+    struct BulkSerializeTraits<Mat<T, R, C>> {
+        static constexpr bool bulk = sizeof(Mat<T, R, C>) == sizeof(T) * R * C;
+        using Scalar = T;
+    };
+
     template <Serializable T, uint8_t R, uint8_t C>
     struct Serializer<Mat<T, R, C>> {
         static constexpr size_t typeId
@@ -214,6 +214,12 @@ namespace Common::Internal {
 }
 
 namespace Common {
+    template <CppArithmeticNonBool T, uint8_t L>
+    struct BulkSerializeTraits<Vec<T, L>> {
+        static constexpr bool bulk = sizeof(Vec<T, L>) == sizeof(T) * L;
+        using Scalar = T;
+    };
+
     template <Serializable T, uint8_t L>
     struct Serializer<Vec<T, L>> {
         static constexpr size_t typeId
@@ -16,10 +16,12 @@
 #include <set>
 #include <map>
 #include <variant>
+#include <typeinfo>
 
 #include <rapidjson/document.h>
 
 #include <Common/Utility.h>
+#include <Common/Memory.h>
 #include <Common/Debug.h>
 #include <Common/Hash.h>
 #include <Common/String.h>
@@ -27,12 +29,34 @@
 #include <Common/File.h>
 
 namespace Common {
+    // types whose serialized bytes are exactly their in-memory bytes, made of scalars of one arithmetic type, contiguous
+    // ranges of them are moved by one bulk stream call and, across endian, swapped in one pass over the range. math types
+    // with user-declared copy constructors opt in by specializing this with their scalar type
+    template <typename T> struct BulkSerializeTraits {
+        static constexpr bool bulk = false;
+    };
+
+    template <CppArithmeticNonBool T> struct BulkSerializeTraits<T> {
+        static constexpr bool bulk = true;
+        using Scalar = T;
+    };
+
+    template <typename T> concept BulkSerializable = BulkSerializeTraits<T>::bulk;
+
+    // state kept by serializers along one stream, e.g. tables written once per stream and referenced later by index
+    class SerializeStreamContext {
+    public:
+        virtual ~SerializeStreamContext();
+    };
+
     class BinarySerializeStream {
     public:
         NonCopyable(BinarySerializeStream)
         virtual ~BinarySerializeStream();
 
         template <CppArithmetic T> void Write(const T& value);
+        template <BulkSerializable T> void WriteBulk(const T* values, size_t count);
+        template <std::derived_from<SerializeStreamContext> C> C& GetContext();
         virtual void Seek(int64_t offset) = 0;
         virtual size_t Loc() = 0;
         virtual std::endian Endian() = 0;
@@ -41,6 +65,9 @@ namespace Common {
         BinarySerializeStream();
 
         virtual void WriteInternal(const void* data, size_t size) = 0;
+
+    private:
+        std::unordered_map<size_t, UniquePtr<SerializeStreamContext>> contexts;
     };
 
     class BinaryDeserializeStream {
@@ -49,14 +76,22 @@ namespace Common {
         virtual ~BinaryDeserializeStream();
 
         template <CppArithmetic T> void Read(T& value);
+        template <BulkSerializable T> void ReadBulk(T* values, size_t count);
+        template <std::derived_from<SerializeStreamContext> C> C& GetContext();
         virtual void Seek(int64_t offset) = 0;
         virtual size_t Loc() = 0;
         virtual std::endian Endian() = 0;
+        // lends next size bytes of stream storage read-only and skips them, the storage lives as long as outOwner,
+        // returns nullptr when the storage can not outlive the stream
+        virtual const uint8_t* Borrow(size_t size, SharedPtr<MappedFile>& outOwner);
 
     protected:
         BinaryDeserializeStream();
 
         virtual void ReadInternal(void* data, size_t size) = 0;
+
+    private:
+        std::unordered_map<size_t, UniquePtr<SerializeStreamContext>> contexts;
     };
 
     template <std::endian E = std::endian::little>
@@ -98,6 +133,31 @@ namespace Common {
         size_t fileSize;
     };
 
+    // reads a memory mapped file, fields are copied out of the mapping without iostream, when borrowable bulk ranges
+    // are viewed in place by BulkArray and keep the file mapped, so only enable it for read-only data which is never
+    // rewritten while loaded, truncating a mapped file faults its readers
+    template <std::endian E = std::endian::little>
+    class MappedFileDeserializeStream final : public BinaryDeserializeStream {
+    public:
+        NonCopyable(MappedFileDeserializeStream)
+        explicit MappedFileDeserializeStream(const std::string& inFileName, bool inBorrowable = false);
+        ~MappedFileDeserializeStream() override;
+
+        bool Valid() const;
+        void Seek(int64_t offset) override;
+        size_t Loc() override;
+        std::endian Endian() override;
+        const uint8_t* Borrow(size_t size, SharedPtr<MappedFile>& outOwner) override;
+
+    protected:
+        void ReadInternal(void* data, size_t size) override;
+
+    private:
+        SharedPtr<MappedFile> file;
+        bool borrowable;
+        size_t pointer;
+    };
+
     template <std::endian E = std::endian::little>
     class MemorySerializeStream final : public BinarySerializeStream {
     public:
@@ -136,6 +196,34 @@ namespace Common {
         const std::vector<uint8_t>& bytes;
     };
 
+    // contiguous read-only array of bulk serializable elements, either owns its elements or views them in place in
+    // the memory mapped file it was deserialized from
+    template <BulkSerializable T>
+    class BulkArray {
+    public:
+        BulkArray();
+        BulkArray(std::vector<T> inElements); // NOLINT
+
+        bool operator==(const BulkArray& rhs) const;
+        const T& operator[](size_t index) const;
+
+        size_t Size() const;
+        bool Empty() const;
+        const T* Data() const;
+        const T* begin() const;
+        const T* end() const;
+        bool IsBorrowed() const;
+        std::vector<T> ToVector() const;
+
+    private:
+        template <typename> friend struct Serializer;
+
+        std::vector<T> elements;
+        SharedPtr<MappedFile> borrowedOwner;
+        const T* borrowedData;
+        size_t borrowedSize;
+    };
+
     template <typename T> struct Serializer {};
     template <typename T> concept Serializable = requires(T inValue, BinarySerializeStream& serializeStream, BinaryDeserializeStream& deserializeStream)
     {
@@ -205,6 +293,49 @@ namespace Common::Internal {
             std::swap(bytes[i], bytes[size - 1 - i]);
         }
     }
+
+    inline uint16_t ByteSwap(uint16_t value)
+    {
+        return static_cast<uint16_t>(value << 8 | value >> 8);
+    }
+
+    inline uint32_t ByteSwap(uint32_t value)
+    {
+        return value << 24 | (value << 8 & 0x00ff0000u) | (value >> 8 & 0x0000ff00u) | value >> 24;
+    }
+
+    inline uint64_t ByteSwap(uint64_t value)
+    {
+        return static_cast<uint64_t>(ByteSwap(static_cast<uint32_t>(value))) << 32 | ByteSwap(static_cast<uint32_t>(value >> 32));
+    }
+
+    // branch free per element, compilers turn the loop into vector byte shuffles
+    template <typename U>
+    void SwapEndianArrayInplace(uint8_t* bytes, size_t count)
+    {
+        for (auto i = 0; i < count; i++) {
+            U value;
+            memcpy(&value, bytes + i * sizeof(U), sizeof(U));
+            value = ByteSwap(value);
+            memcpy(bytes + i * sizeof(U), &value, sizeof(U));
+        }
+    }
+
+    inline void SwapEndianArrayInplace(void* data, size_t elementSize, size_t count)
+    {
+        auto* bytes = static_cast<uint8_t*>(data);
+        if (elementSize == sizeof(uint16_t)) {
+            SwapEndianArrayInplace<uint16_t>(bytes, count);
+        } else if (elementSize == sizeof(uint32_t)) {
+            SwapEndianArrayInplace<uint32_t>(bytes, count);
+        } else if (elementSize == sizeof(uint64_t)) {
+            SwapEndianArrayInplace<uint64_t>(bytes, count);
+        } else if (elementSize > 1) {
+            for (auto i = 0; i < count; i++) {
+                SwapEndianInplace(bytes + i * elementSize, elementSize);
+            }
+        }
+    }
 }
 
 namespace Common {
@@ -228,6 +359,64 @@ namespace Common {
         }
     }
 
+    template <BulkSerializable T>
+    void BinarySerializeStream::WriteBulk(const T* values, size_t count)
+    {
+        using Scalar = typename BulkSerializeTraits<T>::Scalar;
+        static_assert(sizeof(T) % sizeof(Scalar) == 0);
+
+        if (count == 0) {
+            return;
+        }
+
+        const size_t size = sizeof(T) * count;
+        if (std::endian::native == Endian() || sizeof(Scalar) == 1) {
+            WriteInternal(values, size);
+        } else {
+            std::vector<uint8_t> swapped(size);
+            memcpy(swapped.data(), values, size);
+            Internal::SwapEndianArrayInplace(swapped.data(), sizeof(Scalar), size / sizeof(Scalar));
+            WriteInternal(swapped.data(), size);
+        }
+    }
+
+    template <BulkSerializable T>
+    void BinaryDeserializeStream::ReadBulk(T* values, size_t count)
+    {
+        using Scalar = typename BulkSerializeTraits<T>::Scalar;
+        static_assert(sizeof(T) % sizeof(Scalar) == 0);
+
+        if (count == 0) {
+            return;
+        }
+
+        const size_t size = sizeof(T) * count;
+        ReadInternal(values, size);
+        if (std::endian::native != Endian() && sizeof(Scalar) > 1) {
+            Internal::SwapEndianArrayInplace(values, sizeof(Scalar), size / sizeof(Scalar));
+        }
+    }
+
+    template <std::derived_from<SerializeStreamContext> C>
+    C& BinarySerializeStream::GetContext()
+    {
+        auto iter = contexts.find(typeid(C).hash_code());
+        if (iter == contexts.end()) {
+            iter = contexts.emplace(typeid(C).hash_code(), new C()).first;
+        }
+        return static_cast<C&>(*iter->second);
+    }
+
+    template <std::derived_from<SerializeStreamContext> C>
+    C& BinaryDeserializeStream::GetContext()
+    {
+        auto iter = contexts.find(typeid(C).hash_code());
+        if (iter == contexts.end()) {
+            iter = contexts.emplace(typeid(C).hash_code(), new C()).first;
+        }
+        return static_cast<C&>(*iter->second);
+    }
+
     template <std::endian E>
     BinaryFileSerializeStream<E>::BinaryFileSerializeStream(const std::string& inFileName)
     {
@@ -334,6 +523,65 @@ namespace Common {
         }
     }
 
+    template <std::endian E>
+    MappedFileDeserializeStream<E>::MappedFileDeserializeStream(const std::string& inFileName, bool inBorrowable)
+        : file(new MappedFile(inFileName))
+        , borrowable(inBorrowable)
+        , pointer(0)
+    {
+    }
+
+    template <std::endian E>
+    MappedFileDeserializeStream<E>::~MappedFileDeserializeStream() = default;
+
+    template <std::endian E>
+    bool MappedFileDeserializeStream<E>::Valid() const
+    {
+        return file->Valid();
+    }
+
+    template <std::endian E>
+    void MappedFileDeserializeStream<E>::ReadInternal(void* data, const size_t size)
+    {
+        const auto newPointer = pointer + size;
+        Assert(newPointer <= file->Size());
+        memcpy(data, file->Data() + pointer, size);
+        pointer = newPointer;
+    }
+
+    template <std::endian E>
+    void MappedFileDeserializeStream<E>::Seek(int64_t offset)
+    {
+        pointer += offset;
+    }
+
+    template <std::endian E>
+    size_t MappedFileDeserializeStream<E>::Loc()
+    {
+        return pointer;
+    }
+
+    template <std::endian E>
+    std::endian MappedFileDeserializeStream<E>::Endian()
+    {
+        return E;
+    }
+
+    template <std::endian E>
+    const uint8_t* MappedFileDeserializeStream<E>::Borrow(size_t size, SharedPtr<MappedFile>& outOwner)
+    {
+        if (!borrowable) {
+            return nullptr;
+        }
+
+        const auto newPointer = pointer + size;
+        Assert(newPointer <= file->Size());
+        const auto* result = file->Data() + pointer;
+        pointer = newPointer;
+        outOwner = file;
+        return result;
+    }
+
     template <std::endian E>
     MemorySerializeStream<E>::MemorySerializeStream(std::vector<uint8_t>& inBytes, const size_t pointerBegin)
         : pointer(pointerBegin)
@@ -415,6 +663,76 @@ namespace Common {
         return E;
     }
 
+    template <BulkSerializable T>
+    BulkArray<T>::BulkArray()
+        : borrowedData(nullptr)
+        , borrowedSize(0)
+    {
+    }
+
+    template <BulkSerializable T>
+    BulkArray<T>::BulkArray(std::vector<T> inElements)
+        : elements(std::move(inElements))
+        , borrowedData(nullptr)
+        , borrowedSize(0)
+    {
+    }
+
+    template <BulkSerializable T>
+    bool BulkArray<T>::operator==(const BulkArray& rhs) const
+    {
+        return Size() == rhs.Size() && std::equal(begin(), end(), rhs.begin());
+    }
+
+    template <BulkSerializable T>
+    const T& BulkArray<T>::operator[](size_t index) const
+    {
+        Assert(index < Size());
+        return Data()[index];
+    }
+
+    template <BulkSerializable T>
+    size_t BulkArray<T>::Size() const
+    {
+        return IsBorrowed() ? borrowedSize : elements.size();
+    }
+
+    template <BulkSerializable T>
+    bool BulkArray<T>::Empty() const
+    {
+        return Size() == 0;
+    }
+
+    template <BulkSerializable T>
+    const T* BulkArray<T>::Data() const
+    {
+        return IsBorrowed() ? borrowedData : elements.data();
+    }
+
+    template <BulkSerializable T>
+    const T* BulkArray<T>::begin() const
+    {
+        return Data();
+    }
+
+    template <BulkSerializable T>
+    const T* BulkArray<T>::end() const
+    {
+        return Data() + Size();
+    }
+
+    template <BulkSerializable T>
+    bool BulkArray<T>::IsBorrowed() const
+    {
+        return borrowedOwner != nullptr;
+    }
+
+    template <BulkSerializable T>
+    std::vector<T> BulkArray<T>::ToVector() const
+    {
+        return std::vector<T>(begin(), end());
+    }
+
     template <typename T>
     size_t Serialize(BinarySerializeStream& inStream, const T& inValue)
     {
@@ -707,8 +1025,13 @@ namespace Common {
             const uint64_t size = value.size();
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
-            for (const auto& element : value) {
-                serialized += Serializer<T>::Serialize(stream, element);
+            if constexpr (BulkSerializable<T>) {
+                stream.WriteBulk(value.data(), N);
+                serialized += sizeof(T) * N;
+            } else {
+                for (const auto& element : value) {
+                    serialized += Serializer<T>::Serialize(stream, element);
+                }
             }
             return serialized;
         }
@@ -727,10 +1050,15 @@ namespace Common {
                 return deserialized;
             }
 
-            for (auto i = 0; i < size; i++) {
-                T element;
-                deserialized += Serializer<T>::Deserialize(stream, element);
-                value[i] = std::move(element);
+            if constexpr (BulkSerializable<T>) {
+                stream.ReadBulk(value.data(), N);
+                deserialized += sizeof(T) * N;
+            } else {
+                for (auto i = 0; i < size; i++) {
+                    T element;
+                    deserialized += Serializer<T>::Deserialize(stream, element);
+                    value[i] = std::move(element);
+                }
             }
             return deserialized;
         }
@@ -749,8 +1077,13 @@ namespace Common {
             const uint64_t size = value.size();
             serialized += Serializer<uint64_t>::Serialize(stream, size);
 
-            for (auto i = 0; i < size; i++) {
-                serialized += Serializer<T>::Serialize(stream, value[i]);
+            if constexpr (BulkSerializable<T>) {
+                stream.WriteBulk(value.data(), size);
+                serialized += sizeof(T) * size;
+            } else {
+                for (auto i = 0; i < size; i++) {
+                    serialized += Serializer<T>::Serialize(stream, value[i]);
+                }
             }
             return serialized;
         }
@@ -763,16 +1096,75 @@ namespace Common {
             uint64_t size;
             deserialized += Serializer<uint64_t>::Deserialize(stream, size);
 
-            value.reserve(size);
-            for (auto i = 0; i < size; i++) {
-                T element;
-                deserialized += Serializer<T>::Deserialize(stream, element);
-                value.emplace_back(std::move(element));
+            if constexpr (BulkSerializable<T>) {
+                value.resize(size);
+                stream.ReadBulk(value.data(), size);
+                deserialized += sizeof(T) * size;
+            } else {
+                value.reserve(size);
+                for (auto i = 0; i < size; i++) {
+                    T element;
+                    deserialized += Serializer<T>::Deserialize(stream, element);
+                    value.emplace_back(std::move(element));
+                }
             }
             return deserialized;
         }
     };
 
+    template <BulkSerializable T>
+    struct Serializer<BulkArray<T>> {
+        static constexpr size_t typeId
+            = HashUtils::StrCrc32("Common::BulkArray")
+            + Serializer<T>::typeId;
+
+        // uint64_t size                          : sizeof(uint64_t)
+        // uint8_t paddingSize                    : sizeof(uint8_t)
+        // uint8_t[] padding                      : paddingSize, aligns elements to alignof(T) from stream begin
+        // T[] elements                           : sizeof(T) * size
+
+        static size_t Serialize(BinarySerializeStream& stream, const BulkArray<T>& value)
+        {
+            const uint64_t size = value.Size();
+            Serializer<uint64_t>::Serialize(stream, size);
+
+            const auto paddingSize = static_cast<uint8_t>((alignof(T) - (stream.Loc() + sizeof(uint8_t)) % alignof(T)) % alignof(T));
+            Serializer<uint8_t>::Serialize(stream, paddingSize);
+            for (auto i = 0; i < paddingSize; i++) {
+                Serializer<uint8_t>::Serialize(stream, 0);
+            }
+
+            stream.WriteBulk(value.Data(), size);
+            return sizeof(uint64_t) + sizeof(uint8_t) + paddingSize + sizeof(T) * size;
+        }
+
+        static size_t Deserialize(BinaryDeserializeStream& stream, BulkArray<T>& value)
+        {
+            value = BulkArray<T>();
+
+            uint64_t size;
+            uint8_t paddingSize;
+            Serializer<uint64_t>::Deserialize(stream, size);
+            Serializer<uint8_t>::Deserialize(stream, paddingSize);
+            stream.Seek(paddingSize);
+
+            // borrowed bytes are only usable as elements without endian swap and at element alignment
+            const uint8_t* borrowed = stream.Endian() == std::endian::native ? stream.Borrow(sizeof(T) * size, value.borrowedOwner) : nullptr;
+            if (borrowed != nullptr && reinterpret_cast<uintptr_t>(borrowed) % alignof(T) == 0) {
+                value.borrowedData = reinterpret_cast<const T*>(borrowed);
+                value.borrowedSize = size;
+            } else if (borrowed != nullptr) {
+                value.borrowedOwner.Reset();
+                value.elements.resize(size);
+                memcpy(value.elements.data(), borrowed, sizeof(T) * size);
+            } else {
+                value.elements.resize(size);
+                stream.ReadBulk(value.elements.data(), size);
+            }
+            return sizeof(uint64_t) + sizeof(uint8_t) + paddingSize + sizeof(T) * size;
+        }
+    };
+
     template <Serializable T>
     struct Serializer<std::list<T>> {
         static constexpr size_t typeId
@@ -1359,6 +1751,22 @@ namespace Common {
         }
     };
 
+    template <BulkSerializable T>
+    requires JsonSerializable<T>
+    struct JsonSerializer<BulkArray<T>> {
+        static void JsonSerialize(rapidjson::Value& outJsonValue, rapidjson::Document::AllocatorType& inAllocator, const BulkArray<T>& inValue)
+        {
+            JsonSerializer<std::vector<T>>::JsonSerialize(outJsonValue, inAllocator, inValue.ToVector());
+        }
+
+        static void JsonDeserialize(const rapidjson::Value& inJsonValue, BulkArray<T>& outValue)
+        {
+            std::vector<T> elements;
+            JsonSerializer<std::vector<T>>::JsonDeserialize(inJsonValue, elements);
+            outValue = BulkArray<T>(std::move(elements));
+        }
+    };
+
     template <JsonSerializable T>
     struct JsonSerializer<std::list<T>> {
         static void JsonSerialize(rapidjson::Value& outJsonValue, rapidjson::Document::AllocatorType& inAllocator, const std::list<T>& inValue)
@@ -8,6 +8,8 @@
 #include <pthread.h>
 #endif
 
+#include <utility>
+
 #include <Common/Concurrent.h>
 #include <Common/String.h>
 
@@ -19,34 +21,147 @@ namespace Common {
         thread.join();
     }
 
-    void NamedThread::SetThreadName(const std::string& name) // NOLINT
+    void NamedThread::SetCurrentThreadName(const std::string& name)
     {
 #if PLATFORM_WINDOWS
         Assert(SUCCEEDED(SetThreadDescription(GetCurrentThread(), Common::StringUtils::ToWideString(name).c_str())));
 #elif PLATFORM_MACOS
         pthread_setname_np(name.c_str());
 #else
-        pthread_setname_np(thread.native_handle(), name.c_str());
+        pthread_setname_np(pthread_self(), name.c_str());
 #endif
     }
 
+    Task::Task()
+        : storage()
+        , ops(nullptr)
+    {
+    }
+
+    Task::Task(Task&& inOther) noexcept
+        : storage()
+        , ops(std::exchange(inOther.ops, nullptr))
+    {
+        if (ops != nullptr) {
+            ops->moveConstruct(storage, inOther.storage);
+        }
+    }
+
+    Task& Task::operator=(Task&& inOther) noexcept
+    {
+        if (this != &inOther) {
+            Reset();
+            ops = std::exchange(inOther.ops, nullptr);
+            if (ops != nullptr) {
+                ops->moveConstruct(storage, inOther.storage);
+            }
+        }
+        return *this;
+    }
+
+    Task::~Task()
+    {
+        Reset();
+    }
+
+    Task::operator bool() const
+    {
+        return ops != nullptr;
+    }
+
+    void Task::operator()()
+    {
+        Assert(ops != nullptr);
+        ops->invoke(storage);
+    }
+
+    void Task::Reset()
+    {
+        if (ops != nullptr) {
+            ops->destruct(storage);
+            ops = nullptr;
+        }
+    }
+
+    TaskQueue::TaskQueue(size_t inCapacity)
+        : tasks(inCapacity)
+        , overflowNum(0)
+        , stop(false)
+        , sleepingNum(0)
+    {
+    }
+
+    void TaskQueue::Push(Task&& inTask)
+    {
+        Assert(!stop.load(std::memory_order_relaxed));
+        if (overflowNum.load() > 0 || !tasks.TryPush(std::move(inTask))) {
+            std::unique_lock lock(overflowMutex);
+            overflowTasks.emplace_back(std::move(inTask));
+            ++overflowNum;
+        }
+
+        // pairs with the increment of sleepingNum in Pop(), so either the sleeping consumer sees the new task
+        // when checking the wait predicate, or it is counted here and notified
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepingNum.load() > 0) {
+            std::unique_lock lock(mutex);
+            condition.notify_one();
+        }
+    }
+
+    bool TaskQueue::Pop(Task& outTask)
+    {
+        while (true) {
+            // tasks in the ring were pushed before the overflowed ones
+            if (tasks.TryPop(outTask) || TryPopOverflow(outTask)) {
+                return true;
+            }
+
+            std::unique_lock lock(mutex);
+            ++sleepingNum;
+            condition.wait(lock, [this]() -> bool { return stop.load() || !tasks.Empty() || overflowNum.load() > 0; });
+            --sleepingNum;
+            if (stop.load() && tasks.Empty() && overflowNum.load() == 0) {
+                return false;
+            }
+        }
+    }
+
+    bool TaskQueue::TryPopOverflow(Task& outTask)
+    {
+        if (overflowNum.load() == 0) {
+            return false;
+        }
+
+        std::unique_lock lock(overflowMutex);
+        if (overflowTasks.empty()) {
+            return false;
+        }
+        outTask = std::move(overflowTasks.front());
+        overflowTasks.pop_front();
+        --overflowNum;
+        return true;
+    }
+
+    void TaskQueue::Stop()
+    {
+        {
+            std::unique_lock lock(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+    }
+
     ThreadPool::ThreadPool(const std::string& name, uint8_t threadNum)
-        : stop(false)
     {
         threads.reserve(threadNum);
         for (auto i = 0; i < threadNum; i++) {
             std::string fullName = name + "-" + std::to_string(i);
             threads.emplace_back(fullName, [this]() -> void {
                 while (true) {
-                    std::function<void()> task;
-                    {
-                        std::unique_lock lock(mutex);
-                        condition.wait(lock, [this]() -> bool { return stop || !tasks.empty(); });
-                        if (stop && tasks.empty()) {
-                            return;
-                        }
-                        task = std::move(tasks.front());
-                        tasks.pop();
+                    Task task;
+                    if (!tasks.Pop(task)) {
+                        return;
                     }
                     task();
                 }
@@ -56,73 +171,34 @@ namespace Common {
 
     ThreadPool::~ThreadPool()
     {
-        {
-            std::unique_lock lock(mutex);
-            stop = true;
-        }
-        condition.notify_all();
+        tasks.Stop();
         for (auto& thread : threads) {
             thread.Join();
         }
     }
 
     WorkerThread::WorkerThread(const std::string& name)
-        : stop(false)
-        , flush(false)
     {
         thread = NamedThread(name, [this]() -> void {
             while (true) {
-                bool needNotifyMainThread = false;
-                std::vector<std::function<void()>> tasksToExecute;
-                {
-                    std::unique_lock lock(mutex);
-                    taskCondition.wait(lock, [this]() -> bool { return stop || flush || !tasks.empty(); });
-                    if (stop && tasks.empty()) {
-                        return;
-                    }
-                    if (flush) {
-                        tasksToExecute.reserve(tasks.size());
-                        while (!tasks.empty()) {
-                            tasksToExecute.emplace_back(std::move(tasks.front()));
-                            tasks.pop();
-                        }
-                        flush = false;
-                        needNotifyMainThread = true;
-                    } else {
-                        tasksToExecute.emplace_back(std::move(tasks.front()));
-                        tasks.pop();
-                    }
-                }
-                for (auto& task : tasksToExecute) {
-                    task();
-                }
-                if (needNotifyMainThread) {
-                    flushCondition.notify_one();
+                Task task;
+                if (!tasks.Pop(task)) {
+                    return;
                 }
+                task();
             }
         });
     }
 
     WorkerThread::~WorkerThread()
     {
-        {
-            std::unique_lock lock(mutex);
-            stop = true;
-        }
-        taskCondition.notify_all();
+        tasks.Stop();
         thread.Join();
     }
 
     void WorkerThread::Flush()
     {
-        {
-            std::unique_lock lock(mutex);
-            flush = true;
-        }
-        taskCondition.notify_one();
-        {
-            std::unique_lock lock(mutex);
-            flushCondition.wait(lock);
-        }
+        // tasks are executed in order, so all tasks queued before are done once this one is done
+        EmplaceTask([]() -> void {}).wait();
     }
 }
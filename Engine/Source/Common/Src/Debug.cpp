@@ -6,9 +6,15 @@
 #include <debugbreak.h>
 #endif
 
+#include <atomic>
+
 #include <Common/Debug.h>
 #include <Common/IO.h>
 
+namespace Common::Internal {
+    static std::atomic<Debug::AssertFailHandler> assertFailHandler = nullptr;
+}
+
 namespace Common {
     void Debug::AssertImpl(const bool expression, const std::string& name, const std::string& file, const uint32_t line, const std::string& reason)
     {
@@ -20,11 +26,21 @@ namespace Common {
         std::cerr << "Assert failed: " << name << ", " << file << ", " << line << newline;
         std::cerr << "Reason: " << reason << newline;
 
+        if (const auto handler = Internal::assertFailHandler.load();
+            handler != nullptr) {
+            handler();
+        }
+
 #if BUILD_CONFIG_DEBUG
         debug_break();
 #endif
     }
 
+    void Debug::SetAssertFailHandler(AssertFailHandler inHandler)
+    {
+        Internal::assertFailHandler = inHandler;
+    }
+
     Debug::Debug() = default;
 
     Debug::~Debug() = default;
@@ -14,6 +14,15 @@
 #include <Common/Debug.h>
 #include <Common/FileSystem.h>
 
+#if PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 namespace Common {
     std::string FileUtils::ReadTextFile(const std::string& inFileName)
     {
@@ -62,4 +71,79 @@ namespace Common {
         }
         (void) fclose(file);
     }
+
+    MappedFile::MappedFile(const std::string& inFileName)
+        : valid(false)
+        , data(nullptr)
+        , size(0)
+    {
+        // the mapping stays valid without the file handle, so close it right after mapping
+#if PLATFORM_WINDOWS
+        void* fileHandle = CreateFileA(inFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize)) {
+            CloseHandle(fileHandle);
+            return;
+        }
+        size = static_cast<size_t>(fileSize.QuadPart);
+        if (size > 0) {
+            void* mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mappingHandle != nullptr) {
+                data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mappingHandle);
+            }
+        }
+        CloseHandle(fileHandle);
+#else
+        const int fileDescriptor = open(inFileName.c_str(), O_RDONLY);
+        if (fileDescriptor < 0) {
+            return;
+        }
+        struct stat fileStat {};
+        if (fstat(fileDescriptor, &fileStat) != 0) {
+            close(fileDescriptor);
+            return;
+        }
+        size = static_cast<size_t>(fileStat.st_size);
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+            if (mapped != MAP_FAILED) {
+                data = static_cast<const uint8_t*>(mapped);
+                madvise(mapped, size, MADV_SEQUENTIAL);
+            }
+        }
+        close(fileDescriptor);
+#endif
+        valid = size == 0 || data != nullptr;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (data == nullptr) {
+            return;
+        }
+#if PLATFORM_WINDOWS
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+
+    bool MappedFile::Valid() const
+    {
+        return valid;
+    }
+
+    const uint8_t* MappedFile::Data() const
+    {
+        return data;
+    }
+
+    size_t MappedFile::Size() const
+    {
+        return size;
+    }
 }
@@ -5,6 +5,8 @@
 #include <Common/Serialization.h>
 
 namespace Common {
+    SerializeStreamContext::~SerializeStreamContext() = default;
+
     BinarySerializeStream::BinarySerializeStream() = default;
 
     BinarySerializeStream::~BinarySerializeStream() = default;
@@ -12,4 +14,9 @@ namespace Common {
     BinaryDeserializeStream::BinaryDeserializeStream() = default;
 
     BinaryDeserializeStream::~BinaryDeserializeStream() = default;
+
+    const uint8_t* BinaryDeserializeStream::Borrow(size_t size, SharedPtr<MappedFile>& outOwner)
+    {
+        return nullptr;
+    }
 }
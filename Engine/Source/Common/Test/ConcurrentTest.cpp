@@ -2,6 +2,8 @@
 // Created by johnk on 2022/7/20.
 //
 
+#include <array>
+
 #include <Test/Test.h>
 
 #include <Common/Concurrent.h>
@@ -123,3 +125,160 @@ TEST(ConcurrentTest, WorkerThread3)
     syncSignal.wait();
     ASSERT_EQ(value, 10);
 }
+
+TEST(ConcurrentTest, TaskTest)
+{
+    uint32_t value = 0;
+    Common::Task task0([&value]() -> void { ++value; });
+    ASSERT_TRUE(task0);
+    task0();
+    ASSERT_EQ(value, 1);
+
+    Common::Task task1 = std::move(task0);
+    ASSERT_FALSE(task0);
+    task1();
+    ASSERT_EQ(value, 2);
+
+    // exceeds inline storage, stored on heap
+    std::array<uint32_t, 32> values {};
+    values[31] = 3;
+    Common::Task task2([&value, values]() -> void { value += values[31]; });
+    Common::Task task3;
+    task3 = std::move(task2);
+    task3();
+    ASSERT_EQ(value, 5);
+
+    auto sharedValue = Common::MakeShared<uint32_t>(0);
+    {
+        Common::Task task4([sharedValue]() -> void { ++*sharedValue; });
+        ASSERT_EQ(sharedValue.RefCount(), 2);
+    }
+    ASSERT_EQ(sharedValue.RefCount(), 1);
+}
+
+TEST(ConcurrentTest, BoundedConcurrentQueueTest)
+{
+    Common::BoundedConcurrentQueue<uint32_t> queue(4);
+    ASSERT_TRUE(queue.Empty());
+    for (uint32_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPush(std::move(i)));
+    }
+    uint32_t value = 4;
+    ASSERT_FALSE(queue.TryPush(std::move(value)));
+
+    for (uint32_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+    ASSERT_TRUE(queue.Empty());
+}
+
+TEST(ConcurrentTest, TaskQueueOverflowTest)
+{
+    // pushing to a full ring moves tasks to the overflow list instead of waiting for a consumer
+    Common::TaskQueue queue(2);
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 8; i++) {
+        queue.Push(Common::Task([&values, i]() -> void { values.emplace_back(i); }));
+    }
+    queue.Stop();
+
+    Common::Task task;
+    while (queue.Pop(task)) {
+        task();
+    }
+    ASSERT_EQ(values.size(), 8);
+    for (uint32_t i = 0; i < 8; i++) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(ConcurrentTest, WorkerThreadSelfPushTest)
+{
+    // a task on the worker thread fills its own queue, it must not wait for itself to consume
+    constexpr uint32_t taskNum = Common::TaskQueue::defaultCapacity * 2;
+    uint32_t count = 0;
+    {
+        Common::WorkerThread workerThread("TestWorkerThread");
+        workerThread.EmplaceDetachedTask([&]() -> void {
+            for (uint32_t i = 0; i < taskNum; i++) {
+                workerThread.EmplaceDetachedTask([&count]() -> void { count++; });
+            }
+        });
+        workerThread.Flush();
+    }
+    ASSERT_EQ(count, taskNum);
+}
+
+TEST(ConcurrentTest, WorkerThreadDetachedTaskTest)
+{
+    std::vector<uint32_t> values;
+    {
+        Common::WorkerThread workerThread("TestWorkerThread");
+        for (uint32_t i = 0; i < 100; i++) {
+            workerThread.EmplaceDetachedTask([&values, i]() -> void { values.emplace_back(i); });
+        }
+        workerThread.Flush();
+        ASSERT_EQ(values.size(), 100);
+    }
+    for (uint32_t i = 0; i < 100; i++) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(ConcurrentTest, WorkerThreadContentionTest)
+{
+    constexpr uint32_t producerNum = 8;
+    constexpr uint32_t taskNumPerProducer = 10000;
+
+    uint64_t sum = 0;
+    std::vector<uint32_t> lastValues(producerNum, 0);
+    bool ordered = true;
+    {
+        Common::WorkerThread workerThread("TestWorkerThread");
+        std::vector<std::thread> producers;
+        producers.reserve(producerNum);
+        for (uint32_t p = 0; p < producerNum; p++) {
+            producers.emplace_back([&, p]() -> void {
+                for (uint32_t i = 1; i <= taskNumPerProducer; i++) {
+                    workerThread.EmplaceDetachedTask([&, p, i]() -> void {
+                        sum += i;
+                        ordered = ordered && lastValues[p] + 1 == i;
+                        lastValues[p] = i;
+                    });
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        workerThread.Flush();
+    }
+    ASSERT_TRUE(ordered);
+    ASSERT_EQ(sum, static_cast<uint64_t>(producerNum) * taskNumPerProducer * (taskNumPerProducer + 1) / 2);
+}
+
+TEST(ConcurrentTest, ThreadPoolContentionTest)
+{
+    constexpr uint32_t producerNum = 8;
+    constexpr uint32_t taskNumPerProducer = 10000;
+
+    std::atomic<uint64_t> count = 0;
+    {
+        Common::ThreadPool threadPool("TestThreadPool", 4);
+        std::vector<std::thread> producers;
+        producers.reserve(producerNum);
+        for (uint32_t p = 0; p < producerNum; p++) {
+            producers.emplace_back([&]() -> void {
+                for (uint32_t i = 0; i < taskNumPerProducer; i++) {
+                    threadPool.EmplaceDetachedTask([&count]() -> void { count.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+    }
+    ASSERT_EQ(count, producerNum * taskNumPerProducer);
+}
@@ -642,6 +642,12 @@ TEST(MathTest, SerializationTest)
     PerformTypedSerializationTest(Color(1, 2, 3, 1));
     PerformTypedSerializationTest(LinearColor(1.0f, 0.5f, 0.2f, 1.0f));
 
+    // contiguous containers, bulk serialized
+    PerformTypedSerializationTest(std::vector<FVec3> { FVec3(1.0f, 2.0f, 3.0f), FVec3(4.0f, 5.0f, 6.0f) });
+    PerformTypedSerializationTest(std::vector<FMat4x4> { FMat4x4(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f, 16.0f) });
+    PerformTypedSerializationTest(std::array<Color, 2> { Color(1, 2, 3, 1), Color(4, 5, 6, 1) });
+    PerformTypedSerializationTest(std::vector<LinearColor> { LinearColor(1.0f, 0.5f, 0.2f, 1.0f) });
+
     // rect
     PerformTypedSerializationTest(FRect(1.0f, 2.0f, 3.0f, 4.0f));
 
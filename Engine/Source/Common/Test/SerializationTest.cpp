@@ -47,6 +47,28 @@ TEST(SerializationTest, ByteStreamTest)
     }
 }
 
+TEST(SerializationTest, MappedFileStreamTest)
+{
+    static Common::Path fileName = "../Test/Generated/Common/SerializationTest.MappedFileStreamTest.bin";
+    {
+        const uint32_t value = 5; // NOLINT
+
+        BinaryFileSerializeStream stream(fileName.String());
+        stream.Seek(3);
+        stream.Write<uint32_t>(value);
+    }
+
+    {
+        uint32_t value;
+
+        MappedFileDeserializeStream stream(fileName.String());
+        ASSERT_TRUE(stream.Valid());
+        stream.Seek(3);
+        stream.Read<uint32_t>(value);
+        ASSERT_EQ(value, 5);
+    }
+}
+
 TEST(SerializationTest, TypedSerializationTest)
 {
     PerformTypedSerializationTest<bool>(false);
@@ -109,6 +131,96 @@ TEST(SerializationTest, TypedSerializationWithFileTest)
     PerformTypeSerializationWithFileTest<std::variant<int, bool, float>>(fileName, { true });
 }
 
+TEST(SerializationTest, BulkSerializationTest)
+{
+    std::vector<double> doubles(1024);
+    std::vector<uint16_t> shorts(1023);
+    for (auto i = 0; i < doubles.size(); i++) {
+        doubles[i] = static_cast<double>(i) * 0.5;
+    }
+    for (auto i = 0; i < shorts.size(); i++) {
+        shorts[i] = static_cast<uint16_t>(i * 7);
+    }
+    PerformTypedSerializationTest<std::vector<double>>(doubles);
+    PerformTypedSerializationTest<std::vector<uint16_t>>(shorts);
+    PerformTypedSerializationTest<std::vector<uint8_t>>({ 1, 2, 3 });
+    PerformTypedSerializationTest<std::vector<float>>({});
+    PerformTypedSerializationTest<BulkArray<float>>({});
+    PerformTypedSerializationTest<std::array<int64_t, 4>>({ -1, 2, -3, 4 });
+
+    // bulk written bytes must match the element by element layout in both endian
+    std::vector<uint8_t> bulkBytes;
+    std::vector<uint8_t> elementBytes;
+    {
+        MemorySerializeStream<std::endian::big> bulkStream(bulkBytes);
+        Serializer<std::vector<uint16_t>>::Serialize(bulkStream, shorts);
+
+        MemorySerializeStream<std::endian::big> elementStream(elementBytes);
+        elementStream.Write<uint64_t>(shorts.size());
+        for (const auto& element : shorts) {
+            elementStream.Write<uint16_t>(element);
+        }
+    }
+    ASSERT_EQ(bulkBytes, elementBytes);
+}
+
+TEST(SerializationTest, BulkArrayBorrowTest)
+{
+    static Common::Path fileName = "../Test/Generated/Common/SerializationTest.BulkArrayBorrowTest.bin";
+
+    std::vector<double> elements(1024);
+    for (auto i = 0; i < elements.size(); i++) {
+        elements[i] = static_cast<double>(i) * 0.25;
+    }
+    const BulkArray<double> array(elements);
+    PerformTypedSerializationTest<BulkArray<double>>(array);
+
+    {
+        BinaryFileSerializeStream stream(fileName.String());
+        Serialize(stream, std::string("unaligned"));
+        Serialize(stream, array);
+    }
+
+    BulkArray<double> restored;
+    {
+        MappedFileDeserializeStream stream(fileName.String(), true);
+        std::string head;
+        Deserialize(stream, head);
+        ASSERT_TRUE(Deserialize(stream, restored).first);
+    }
+    // the view keeps the mapping alive after the stream is gone
+    ASSERT_TRUE(restored.IsBorrowed());
+    ASSERT_EQ(restored.ToVector(), elements);
+}
+
+TEST(SerializationTest, BulkArrayCopyTest)
+{
+    static Common::Path fileName = "../Test/Generated/Common/SerializationTest.BulkArrayCopyTest.bin";
+
+    std::vector<double> elements(1024);
+    for (auto i = 0; i < elements.size(); i++) {
+        elements[i] = static_cast<double>(i) * 0.25;
+    }
+    {
+        BinaryFileSerializeStream stream(fileName.String());
+        Serialize(stream, BulkArray<double>(elements));
+    }
+
+    BulkArray<double> restored;
+    {
+        MappedFileDeserializeStream stream(fileName.String());
+        ASSERT_TRUE(Deserialize(stream, restored).first);
+    }
+    ASSERT_FALSE(restored.IsBorrowed());
+
+    // not borrowed data stays readable after the file is truncated
+    {
+        BinaryFileSerializeStream stream(fileName.String());
+        Serialize(stream, 1);
+    }
+    ASSERT_EQ(restored.ToVector(), elements);
+}
+
 TEST(SerializationTest, JsonSerializationTest)
 {
     PerformJsonSerializationTest<bool>(false, "false");
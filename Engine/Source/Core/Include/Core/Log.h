@@ -7,18 +7,38 @@
 #include <iostream>
 #include <fstream>
 #include <format>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
 
 #include <Common/Memory.h>
 #include <Common/Time.h>
 #include <Common/Utility.h>
+#include <Common/Concurrent.h>
 #include <Core/Api.h>
 
-#define LogVerbose(tag, ...) Core::Logger::Get().Log(#tag, "Verbose", std::format(__VA_ARGS__))
-#define LogDebug(tag, ...) Core::Logger::Get().Log(#tag, "Debug", std::format(__VA_ARGS__))
-#define LogHint(tag, ...) Core::Logger::Get().Log(#tag, "Hint", std::format(__VA_ARGS__))
-#define LogInfo(tag, ...) Core::Logger::Get().Log(#tag, "Info", std::format(__VA_ARGS__))
-#define LogWarning(tag, ...) Core::Logger::Get().Log(#tag, "Warning", std::format(__VA_ARGS__))
-#define LogError(tag, ...) Core::Logger::Get().Log(#tag, "Error", std::format(__VA_ARGS__))
+// logs below LOG_COMPILE_LEVEL (value of Core::LogLevel) are stripped at compile time
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL 0
+#endif
+
+// arguments are only formatted when the level passes both the compile time and the runtime threshold
+#define LogWithLevel(tag, level, ...) \
+    do { \
+        if constexpr (static_cast<uint8_t>(level) >= LOG_COMPILE_LEVEL) { \
+            if (Core::Logger::Get().IsLevelEnabled(level)) { \
+                Core::Logger::Get().Log(#tag, level, std::format(__VA_ARGS__)); \
+            } \
+        } \
+    } while (false)
+
+#define LogVerbose(tag, ...) LogWithLevel(tag, Core::LogLevel::verbose, __VA_ARGS__)
+#define LogDebug(tag, ...) LogWithLevel(tag, Core::LogLevel::debug, __VA_ARGS__)
+#define LogHint(tag, ...) LogWithLevel(tag, Core::LogLevel::hint, __VA_ARGS__)
+#define LogInfo(tag, ...) LogWithLevel(tag, Core::LogLevel::info, __VA_ARGS__)
+#define LogWarning(tag, ...) LogWithLevel(tag, Core::LogLevel::warning, __VA_ARGS__)
+#define LogError(tag, ...) LogWithLevel(tag, Core::LogLevel::error, __VA_ARGS__)
 
 namespace Core {
     class LogStream {
@@ -65,24 +85,84 @@ namespace Core {
         max
     };
 
+    enum class LogOverflowPolicy : uint8_t {
+        // records below warning logged while the ring buffer of the thread is full are dropped, the dropped count is
+        // logged later, warnings and errors always block
+        drop,
+        // the logging thread yields until the logger thread frees a slot
+        block,
+        max
+    };
+
+    struct LogRecord {
+        LogRecord();
+        LogRecord(const char* inTag, LogLevel inLevel, std::string inContent);
+
+        std::chrono::system_clock::time_point time;
+        const char* tag;
+        LogLevel level;
+        std::string content;
+    };
+
+    namespace Internal {
+        struct LogThreadRing;
+    }
+
+    // logging threads push records into their own lock-free ring buffer, the logger thread drains all rings, formats
+    // the records and writes them to streams, so logging never waits for I/O
     class CORE_API Logger {
     public:
+        static constexpr size_t threadRingCapacity = 1024;
+
         static Logger& Get();
 
         ~Logger();
         NonCopyable(Logger)
         NonMovable(Logger)
 
-        void Log(const std::string& inTag, const std::string& inLevel, const std::string& inContent);
+        // inTag must live as long as the logger, tags from the log macros are string literals
+        void Log(const char* inTag, LogLevel inLevel, std::string inContent);
+        bool IsLevelEnabled(LogLevel inLevel) const;
+        void SetLevel(LogLevel inLevel);
+        LogLevel GetLevel() const;
+        void SetOverflowPolicy(LogOverflowPolicy inPolicy);
+        LogOverflowPolicy GetOverflowPolicy() const;
+        uint64_t GetDroppedNum() const;
         void Attach(Common::UniquePtr<LogStream>&& inStream);
+        // writes all records logged before the call and flushes streams
         void Flush();
+        // flush used by assert and crash paths, gives up if the streams can not be locked in time
+        void FlushOnCrash();
+        // called by engine at shutdown, drains the rings and joins the logger thread, records logged after stopping are
+        // written synchronously by the logging thread
+        void Stop();
 
     private:
         Logger();
 
-        void LogInternal(const std::string& inString);
+        Internal::LogThreadRing& GetThreadRing();
+        void WriteSynchronously(const LogRecord& inRecord);
+        void ConsumeRecords();
+        void WriteRecord(const LogRecord& inRecord);
+        void FlushStreams();
+
+        std::atomic<LogLevel> level;
+        std::atomic<LogOverflowPolicy> overflowPolicy;
+        std::atomic<uint64_t> droppedNum;
+        std::atomic<bool> stop;
 
-        float lastFlushTimeSec;
+        std::mutex ringsMutex;
+        std::vector<Common::SharedPtr<Internal::LogThreadRing>> rings;
+
+        // guards streams and everything below, only one thread consumes the rings at a time
+        std::timed_mutex consumeMutex;
         std::vector<Common::UniquePtr<LogStream>> streams;
+        std::vector<LogRecord> consumingRecords;
+        uint64_t reportedDroppedNum;
+        double lastFlushTimeSec;
+
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        Common::NamedThread thread;
     };
 }
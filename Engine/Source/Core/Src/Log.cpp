@@ -2,10 +2,48 @@
 // Created by johnk on 2025/1/13.
 //
 
+#include <exception>
+
 #include <Core/Log.h>
 #include <Common/FileSystem.h>
 #include <Common/IO.h>
 
+namespace Core::Internal {
+    constexpr auto loggerWakeInterval = std::chrono::milliseconds(10);
+    constexpr auto loggerCrashFlushTimeout = std::chrono::milliseconds(100);
+
+    static std::terminate_handler prevTerminateHandler = nullptr;
+
+    struct LogThreadRing {
+        LogThreadRing()
+            : records(Logger::threadRingCapacity)
+            , retired(false)
+        {
+        }
+
+        Common::BoundedConcurrentQueue<LogRecord> records;
+        std::atomic<bool> retired;
+    };
+
+    struct LogThreadRingHolder {
+        ~LogThreadRingHolder()
+        {
+            if (ring != nullptr) {
+                ring->retired = true;
+            }
+        }
+
+        Common::SharedPtr<LogThreadRing> ring;
+    };
+
+    static const char* GetLogLevelName(LogLevel inLevel)
+    {
+        static constexpr const char* names[] = { "Verbose", "Debug", "Hint", "Info", "Warning", "Error" };
+        Assert(inLevel < LogLevel::max);
+        return names[static_cast<uint8_t>(inLevel)];
+    }
+}
+
 namespace Core {
     COutLogStream::COutLogStream() = default;
 
@@ -48,6 +86,20 @@ namespace Core {
         file << std::flush;
     }
 
+    LogRecord::LogRecord()
+        : tag(nullptr)
+        , level(LogLevel::max)
+    {
+    }
+
+    LogRecord::LogRecord(const char* inTag, LogLevel inLevel, std::string inContent)
+        : time(std::chrono::system_clock::now())
+        , tag(inTag)
+        , level(inLevel)
+        , content(std::move(inContent))
+    {
+    }
+
     Logger& Logger::Get()
     {
         static Logger logger;
@@ -56,48 +108,202 @@ namespace Core {
 
     Logger::~Logger()
     {
-        Flush();
+        Stop();
+        Common::Debug::SetAssertFailHandler(nullptr);
+        std::set_terminate(Internal::prevTerminateHandler);
+    }
+
+    void Logger::Log(const char* inTag, LogLevel inLevel, std::string inContent)
+    {
+        LogRecord record(inTag, inLevel, std::move(inContent));
+        for (auto& records = GetThreadRing().records; !stop.load(std::memory_order_acquire);) {
+            if (records.TryPush(std::move(record))) {
+                if (inLevel >= LogLevel::warning) {
+                    wakeCondition.notify_one();
+                }
+                return;
+            }
+            if (inLevel < LogLevel::warning && overflowPolicy.load(std::memory_order_relaxed) == LogOverflowPolicy::drop) {
+                droppedNum.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wakeCondition.notify_one();
+            std::this_thread::yield();
+        }
+        // no logger thread drains the rings once stopped
+        WriteSynchronously(record);
+    }
+
+    bool Logger::IsLevelEnabled(LogLevel inLevel) const
+    {
+        return inLevel >= level.load(std::memory_order_relaxed);
+    }
+
+    void Logger::SetLevel(LogLevel inLevel)
+    {
+        level.store(inLevel, std::memory_order_relaxed);
+    }
+
+    LogLevel Logger::GetLevel() const
+    {
+        return level.load(std::memory_order_relaxed);
+    }
+
+    void Logger::SetOverflowPolicy(LogOverflowPolicy inPolicy)
+    {
+        overflowPolicy.store(inPolicy, std::memory_order_relaxed);
+    }
+
+    LogOverflowPolicy Logger::GetOverflowPolicy() const
+    {
+        return overflowPolicy.load(std::memory_order_relaxed);
     }
 
-    void Logger::Log(const std::string& inTag, const std::string& inLevel, const std::string& inContent)
+    uint64_t Logger::GetDroppedNum() const
     {
-        const auto time = Common::AccurateTime(Common::TimePoint::Now());
-        LogInternal(std::format("[{}][{}][{}] {}", time.ToString(), inTag, inLevel, inContent));
+        return droppedNum.load(std::memory_order_relaxed);
     }
 
     void Logger::Attach(Common::UniquePtr<LogStream>&& inStream)
     {
+        std::unique_lock lock(consumeMutex);
         streams.emplace_back(std::move(inStream));
     }
 
     void Logger::Flush() // NOLINT
     {
-        for (const auto& stream : streams) {
-            stream->Flush();
+        std::unique_lock lock(consumeMutex);
+        ConsumeRecords();
+        FlushStreams();
+    }
+
+    void Logger::FlushOnCrash()
+    {
+        // the crashing thread may be the one holding the lock
+        std::unique_lock lock(consumeMutex, Internal::loggerCrashFlushTimeout);
+        if (!lock.owns_lock()) {
+            return;
         }
+        ConsumeRecords();
+        FlushStreams();
     }
 
-    Logger::Logger()
-        : lastFlushTimeSec(Common::TimePoint::Now().ToSeconds())
+    void Logger::Stop()
     {
-        Attach(new COutLogStream());
+        if (!stop.exchange(true)) {
+            wakeCondition.notify_one();
+            thread.Join();
+        }
+        Flush();
     }
 
-    void Logger::LogInternal(const std::string& inString) // NOLINT
+    Logger::Logger()
+        : level(LogLevel::verbose)
+        , overflowPolicy(LogOverflowPolicy::drop)
+        , droppedNum(0)
+        , stop(false)
+        , reportedDroppedNum(0)
+        , lastFlushTimeSec(Common::TimePoint::Now().ToSeconds())
     {
+        streams.emplace_back(new COutLogStream());
+        Common::Debug::SetAssertFailHandler([]() -> void {
+            Logger::Get().FlushOnCrash();
+        });
+        Internal::prevTerminateHandler = std::set_terminate([]() -> void {
+            Logger::Get().FlushOnCrash();
+            if (Internal::prevTerminateHandler != nullptr) {
+                Internal::prevTerminateHandler();
+            }
+            std::abort();
+        });
+        thread = Common::NamedThread("Logger", [this]() -> void {
+            while (!stop) {
+                {
+                    std::unique_lock lock(wakeMutex);
+                    wakeCondition.wait_for(lock, Internal::loggerWakeInterval);
+                }
+
+                std::unique_lock lock(consumeMutex);
+                ConsumeRecords();
 #if BUILD_CONFIG_DEBUG
-        const bool needFlush = true; // NOLINT
+                const bool needFlush = true; // NOLINT
 #else
-        const auto timeNowSec = Common::TimePoint::Now().ToSeconds();
-        const bool needFlush = timeNowSec - lastFlushTimeSec > 5.0f;
-        lastFlushTimeSec = timeNowSec;
+                const auto timeNowSec = Common::TimePoint::Now().ToSeconds();
+                const bool needFlush = timeNowSec - lastFlushTimeSec > 5.0f;
 #endif
+                if (needFlush) {
+                    FlushStreams();
+                }
+            }
+        });
+    }
 
-        for (const auto& stream : streams) {
-            stream->Write(inString);
-            if (needFlush) {
-                stream->Flush();
+    void Logger::WriteSynchronously(const LogRecord& inRecord)
+    {
+        std::unique_lock lock(consumeMutex);
+        ConsumeRecords();
+        WriteRecord(inRecord);
+        FlushStreams();
+    }
+
+    Internal::LogThreadRing& Logger::GetThreadRing()
+    {
+        thread_local Internal::LogThreadRingHolder holder;
+        if (holder.ring == nullptr) {
+            holder.ring = new Internal::LogThreadRing();
+            std::unique_lock lock(ringsMutex);
+            rings.emplace_back(holder.ring);
+        }
+        return *holder.ring;
+    }
+
+    void Logger::ConsumeRecords()
+    {
+        std::vector<Common::SharedPtr<Internal::LogThreadRing>> ringsToConsume;
+        {
+            std::unique_lock lock(ringsMutex);
+            // rings of exited threads will never be pushed again, they are removed once drained
+            std::erase_if(rings, [](const Common::SharedPtr<Internal::LogThreadRing>& ring) -> bool {
+                return ring->retired && ring->records.Empty();
+            });
+            ringsToConsume = rings;
+        }
+
+        for (const auto& ring : ringsToConsume) {
+            for (LogRecord record; ring->records.TryPop(record);) {
+                consumingRecords.emplace_back(std::move(record));
             }
         }
+        // records of different threads are interleaved by log time
+        std::ranges::stable_sort(consumingRecords, [](const LogRecord& lhs, const LogRecord& rhs) -> bool {
+            return lhs.time < rhs.time;
+        });
+        for (const auto& record : consumingRecords) {
+            WriteRecord(record);
+        }
+        consumingRecords.clear();
+
+        if (const auto currentDroppedNum = droppedNum.load(std::memory_order_relaxed);
+            currentDroppedNum != reportedDroppedNum) {
+            WriteRecord(LogRecord("Logger", LogLevel::warning, std::format("{} log records dropped because ring buffer is full", currentDroppedNum - reportedDroppedNum)));
+            reportedDroppedNum = currentDroppedNum;
+        }
+    }
+
+    void Logger::WriteRecord(const LogRecord& inRecord)
+    {
+        const auto time = Common::AccurateTime(Common::TimePoint(inRecord.time));
+        const auto string = std::format("[{}][{}][{}] {}", time.ToString(), inRecord.tag, Internal::GetLogLevelName(inRecord.level), inRecord.content);
+        for (const auto& stream : streams) {
+            stream->Write(string);
+        }
+    }
+
+    void Logger::FlushStreams()
+    {
+        for (const auto& stream : streams) {
+            stream->Flush();
+        }
+        lastFlushTimeSec = Common::TimePoint::Now().ToSeconds();
     }
 }
@@ -0,0 +1,137 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <thread>
+
+#include <Test/Test.h>
+#include <Core/Log.h>
+
+struct LogCapture {
+    std::mutex mutex;
+    std::vector<std::string> lines;
+};
+
+class CaptureLogStream final : public Core::LogStream {
+public:
+    explicit CaptureLogStream(std::shared_ptr<LogCapture> inCapture)
+        : capture(std::move(inCapture))
+    {
+    }
+
+    void Write(const std::string& inString) override
+    {
+        if (inString.find("[LogTest]") == std::string::npos) {
+            return;
+        }
+        std::unique_lock lock(capture->mutex);
+        capture->lines.emplace_back(inString);
+    }
+
+    void Flush() override {}
+
+private:
+    std::shared_ptr<LogCapture> capture;
+};
+
+static std::shared_ptr<LogCapture> GetLogCapture()
+{
+    static std::shared_ptr<LogCapture> capture = []() -> std::shared_ptr<LogCapture> {
+        auto result = std::make_shared<LogCapture>();
+        Core::Logger::Get().Attach(new CaptureLogStream(result));
+        return result;
+    }();
+    std::unique_lock lock(capture->mutex);
+    capture->lines.clear();
+    return capture;
+}
+
+TEST(LogTest, LevelFilterTest)
+{
+    const auto capture = GetLogCapture();
+    uint32_t formatCount = 0;
+    const auto countFormat = [&]() -> uint32_t {
+        return ++formatCount;
+    };
+
+    Core::Logger::Get().SetLevel(Core::LogLevel::warning);
+    LogInfo(LogTest, "info {}", countFormat());
+    LogWarning(LogTest, "warning {}", countFormat());
+    Core::Logger::Get().SetLevel(Core::LogLevel::verbose);
+    Core::Logger::Get().Flush();
+
+    ASSERT_EQ(formatCount, 1);
+    ASSERT_EQ(capture->lines.size(), 1);
+    ASSERT_NE(capture->lines[0].find("[Warning] warning 1"), std::string::npos);
+}
+
+TEST(LogTest, MultiThreadTest)
+{
+    const auto capture = GetLogCapture();
+    constexpr uint32_t threadNum = 4;
+    constexpr uint32_t logNumPerThread = Core::Logger::threadRingCapacity * 2;
+
+    Core::Logger::Get().SetOverflowPolicy(Core::LogOverflowPolicy::block);
+    std::vector<std::thread> threads;
+    threads.reserve(threadNum);
+    for (uint32_t i = 0; i < threadNum; i++) {
+        threads.emplace_back([i]() -> void {
+            for (uint32_t j = 0; j < logNumPerThread; j++) {
+                LogVerbose(LogTest, "thread {} log {}", i, j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Core::Logger::Get().Flush();
+    Core::Logger::Get().SetOverflowPolicy(Core::LogOverflowPolicy::drop);
+
+    ASSERT_EQ(capture->lines.size(), threadNum * logNumPerThread);
+}
+
+TEST(LogTest, DropTest)
+{
+    const auto capture = GetLogCapture();
+    const auto droppedNum = Core::Logger::Get().GetDroppedNum();
+
+    // how many records are dropped depends on how fast the logger thread drains, but each record is either written or dropped
+    Core::Logger::Get().SetOverflowPolicy(Core::LogOverflowPolicy::drop);
+    constexpr uint32_t logNum = Core::Logger::threadRingCapacity * 64;
+    for (uint32_t i = 0; i < logNum; i++) {
+        LogVerbose(LogTest, "log {}", i);
+    }
+    Core::Logger::Get().Flush();
+
+    ASSERT_EQ(capture->lines.size() + Core::Logger::Get().GetDroppedNum() - droppedNum, logNum);
+}
+
+TEST(LogTest, WarningNotDroppedTest)
+{
+    const auto capture = GetLogCapture();
+    const auto droppedNum = Core::Logger::Get().GetDroppedNum();
+
+    Core::Logger::Get().SetOverflowPolicy(Core::LogOverflowPolicy::drop);
+    constexpr uint32_t logNum = Core::Logger::threadRingCapacity * 8;
+    for (uint32_t i = 0; i < logNum; i++) {
+        LogError(LogTest, "error {}", i);
+    }
+    Core::Logger::Get().Flush();
+
+    ASSERT_EQ(Core::Logger::Get().GetDroppedNum(), droppedNum);
+    ASSERT_EQ(capture->lines.size(), logNum);
+}
+
+// must be the last test, the logger stays stopped
+TEST(LogTest, StopTest)
+{
+    const auto capture = GetLogCapture();
+
+    LogInfo(LogTest, "before stop");
+    Core::Logger::Get().Stop();
+    ASSERT_EQ(capture->lines.size(), 1);
+
+    LogInfo(LogTest, "after stop");
+    ASSERT_EQ(capture->lines.size(), 2);
+    ASSERT_NE(capture->lines[1].find("[Info] after stop"), std::string::npos);
+}
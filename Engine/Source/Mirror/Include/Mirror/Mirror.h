@@ -62,6 +62,7 @@ namespace Mirror {
         const uint32_t moveConstructible : 1;
         const uint32_t moveAssignable : 1;
         const uint32_t equalComparable : 1;
+        const uint32_t triviallyCopyable : 1;
     };
 
     template <typename T> const TypeInfo* GetTypeInfo();
@@ -761,6 +762,13 @@ namespace Mirror {
         Common::StableUnorderedMap<Id, Function, 128, IdHashProvider> functions;
     };
 
+    // serialized member layout of a class, non-transient member variables sorted by name, the hash identifies
+    // class name and member names so serializers can write it once per stream and match it without per-field names
+    struct ClassSchema {
+        uint64_t hash;
+        std::vector<const MemberVariable*> memberVariables;
+    };
+
     class MIRROR_API Class final : public ReflNode {
     public:
         template <Common::CppClass C> static bool Has();
@@ -822,6 +830,7 @@ namespace Mirror {
         const MemberFunction& GetMemberFunction(const Id& inId) const;
         Any GetDefaultObject() const;
         bool IsTransient() const;
+        const ClassSchema& GetSchema() const;
 
         Any ConstructDyn(const ArgumentList& arguments) const;
         Any NewDyn(const ArgumentList& arguments) const;
@@ -854,6 +863,7 @@ namespace Mirror {
         explicit Class(ConstructParams&& params);
 
         void CreateDefaultObject(const std::function<Any()>& inCreator);
+        void BuildSchema();
         Destructor& EmplaceDestructor(Destructor::ConstructParams&& inParams);
         Constructor& EmplaceConstructor(const Id& inId, Constructor::ConstructParams&& inParams);
         Variable& EmplaceStaticVariable(const Id& inId, Variable::ConstructParams&& inParams);
@@ -872,6 +882,7 @@ namespace Mirror {
         std::unordered_map<Id, Function, IdHashProvider> staticFunctions;
         std::unordered_map<Id, MemberVariable, IdHashProvider> memberVariables;
         std::unordered_map<Id, MemberFunction, IdHashProvider> memberFunctions;
+        ClassSchema schema;
     };
 
     class MIRROR_API EnumValue final : public ReflNode {
@@ -1648,14 +1659,54 @@ namespace Mirror::Internal {
             inVisitor(std::ref(std::get<I>(tuple)));
         }(), 0)... };
     }
+
+    // schema table of the meta object root being written, schemas are appended once and referenced by index
+    struct MetaObjectSerializeContext final : Common::SerializeStreamContext {
+        uint32_t depth = 0;
+        std::unordered_map<const Class*, uint32_t> schemaIndices;
+        std::vector<const Class*> schemaClasses;
+    };
+
+    // schema table of the meta object root being read, each schema is matched against the target class once
+    struct MetaObjectDeserializeContext final : Common::SerializeStreamContext {
+        struct Schema {
+            std::string className;
+            uint64_t hash = 0;
+            bool hasBaseClass = false;
+            std::vector<std::string> memberVariableNames;
+            const Class* resolvedClass = nullptr;
+            std::vector<const MemberVariable*> resolvedMemberVariables;
+        };
+
+        uint32_t depth = 0;
+        std::vector<Schema> schemas;
+    };
 }
 
 namespace Common { // NOLINT
     template <Mirror::MetaClass T>
     struct Serializer<T> {
         static constexpr size_t typeId = HashUtils::StrCrc32("_MetaObject");
-
-        // struct
+        static constexpr uint64_t schemaMarker = 0xFFFFFFFFFFFFFF01;
+
+        // root object, the outermost meta object in a stream, all meta objects nested in it share its schema table
+        // uint64_t schemaMarker                  : sizeof(uint64_t), never a valid class name size of legacy struct
+        // uint64_t bodySize                      : sizeof(uint64_t)
+        // void* body                             : bodySize
+        // uint32_t schemaCount                   : sizeof(uint32_t)
+        // schema[] schemas                       : schemaTableSize
+        //     |- std::string className           : classNameSize
+        //     |- uint64_t hash                   : sizeof(uint64_t)
+        //     |- bool hasBaseClass               : sizeof(bool)
+        //     |- uint32_t memberVariableCount    : sizeof(uint32_t)
+        //     |- std::string[] memberVariableNames
+        //
+        // body, nested meta objects are written as body only
+        // uint32_t schemaIndex                   : sizeof(uint32_t)
+        // void* baseBody                         : body of base class if has one
+        // void*[] memberVariableContent          : field contents in schema order
+        //
+        // legacy struct, still readable
         // std::string className                  : classNameSize
         // size_t baseContentSize                 : sizeof(size_t)
         // void* baseContent                      : baseContentSize
@@ -1666,59 +1717,159 @@ namespace Common { // NOLINT
         //     |- bool sameAsDefaultObject        : sizeof(bool)
         //     |- void* memberVariableContent     : memberVariableEnd - memberVariableLastEnd
 
-        static size_t SerializeDyn(BinarySerializeStream& stream, const Mirror::Class& clazz, const Mirror::Argument& obj)
+        static void SerializeBody(BinarySerializeStream& stream, Mirror::Internal::MetaObjectSerializeContext& context, const Mirror::Class& clazz, const Mirror::Argument& obj)
         {
             Assert(!clazz.IsTransient());
-            const auto& className = clazz.GetName();
-            const auto* baseClass = clazz.GetBaseClass();
-            const auto& memberVariables = clazz.GetMemberVariables();
-            const auto defaultObject = clazz.GetDefaultObject();
-
-            const auto classNameSize = Serializer<std::string>::Serialize(stream, className);
+            const auto [iter, inserted] = context.schemaIndices.emplace(&clazz, static_cast<uint32_t>(context.schemaClasses.size()));
+            if (inserted) {
+                context.schemaClasses.emplace_back(&clazz);
+            }
+            Serializer<uint32_t>::Serialize(stream, iter->second);
 
-            uint64_t baseClassContentSize = 0;
-            stream.Seek(sizeof(uint64_t));
-            if (baseClass != nullptr) {
-                baseClassContentSize = SerializeDyn(stream, *baseClass, obj);
+            if (const auto* baseClass = clazz.GetBaseClass();
+                baseClass != nullptr) {
+                SerializeBody(stream, context, *baseClass, obj);
+            }
+            for (const auto* memberVariable : clazz.GetSchema().memberVariables) {
+                memberVariable->GetDyn(obj).Serialize(stream);
             }
+        }
 
-            stream.Seek(-static_cast<int64_t>(baseClassContentSize) - static_cast<int64_t>(sizeof(uint64_t)));
-            Serializer<uint64_t>::Serialize(stream, baseClassContentSize);
-            stream.Seek(static_cast<int64_t>(baseClassContentSize));
+        // a null class skips the body, used when the data was written by a class not matching the target
+        static void DeserializeBody(BinaryDeserializeStream& stream, Mirror::Internal::MetaObjectDeserializeContext& context, const Mirror::Class* clazz, const Mirror::Argument& obj)
+        {
+            uint32_t schemaIndex = 0;
+            Serializer<uint32_t>::Deserialize(stream, schemaIndex);
+            AssertWithReason(schemaIndex < context.schemas.size(), "meta object refers to a schema not in stream");
+            auto& schema = context.schemas[schemaIndex];
 
-            const uint64_t memberVariableCount = memberVariables.size();
-            std::vector<uint64_t> memberVariableContentEnds;
-            memberVariableContentEnds.reserve(memberVariableCount);
+            if (clazz != nullptr && clazz->GetName() != schema.className) {
+                clazz = nullptr;
+            }
+            if (clazz != nullptr && schema.resolvedClass != clazz) {
+                const auto& classSchema = clazz->GetSchema();
+                if (schema.hash == classSchema.hash && schema.memberVariableNames.size() == classSchema.memberVariables.size()) {
+                    schema.resolvedMemberVariables = classSchema.memberVariables;
+                } else {
+                    schema.resolvedMemberVariables.resize(schema.memberVariableNames.size());
+                    for (auto i = 0; i < schema.memberVariableNames.size(); i++) {
+                        const auto* memberVariable = clazz->FindMemberVariable(schema.memberVariableNames[i]);
+                        schema.resolvedMemberVariables[i] = memberVariable == nullptr || memberVariable->IsTransient() ? nullptr : memberVariable;
+                    }
+                }
+                schema.resolvedClass = clazz;
+            }
 
-            stream.Seek(static_cast<int64_t>(sizeof(uint64_t) * (memberVariableCount + 1)));
-            uint64_t memberVariableContentSize = 0;
-            for (const auto& memberVariable : memberVariables | std::views::values) {
-                if (memberVariable.IsTransient()) {
+            if (schema.hasBaseClass) {
+                DeserializeBody(stream, context, clazz == nullptr ? nullptr : clazz->GetBaseClass(), obj);
+            }
+            for (auto i = 0; i < schema.memberVariableNames.size(); i++) {
+                const auto* memberVariable = clazz == nullptr ? nullptr : schema.resolvedMemberVariables[i];
+                if (memberVariable == nullptr) {
+                    SkipField(stream);
                     continue;
                 }
+                memberVariable->GetDyn(obj).Deserialize(stream);
+            }
+        }
 
-                const bool sameAsDefaultObject = defaultObject.Empty() || !memberVariable.GetTypeInfo()->equalComparable
-                    ? false
-                    : memberVariable.GetDyn(obj) == memberVariable.GetDyn(defaultObject);
+        static void SkipField(BinaryDeserializeStream& stream)
+        {
+            uint64_t fieldTypeId = 0;
+            uint64_t fieldContentSize = 0;
+            Serializer<uint64_t>::Deserialize(stream, fieldTypeId);
+            Serializer<uint64_t>::Deserialize(stream, fieldContentSize);
+            stream.Seek(static_cast<int64_t>(fieldContentSize));
+        }
 
-                memberVariableContentSize += Serializer<std::string>::Serialize(stream, memberVariable.GetName());
-                memberVariableContentSize += Serializer<bool>::Serialize(stream, sameAsDefaultObject);
-                if (!sameAsDefaultObject) {
-                    memberVariableContentSize += memberVariable.GetDyn(obj).Serialize(stream);
-                }
-                memberVariableContentEnds.emplace_back(memberVariableContentSize);
+        static size_t SerializeDyn(BinarySerializeStream& stream, const Mirror::Class& clazz, const Mirror::Argument& obj)
+        {
+            auto& context = stream.GetContext<Mirror::Internal::MetaObjectSerializeContext>();
+            const auto begin = stream.Loc();
+            if (context.depth > 0) {
+                context.depth++;
+                SerializeBody(stream, context, clazz, obj);
+                context.depth--;
+                return stream.Loc() - begin;
             }
 
-            stream.Seek(-static_cast<int64_t>(memberVariableContentSize) - static_cast<int64_t>(sizeof(uint64_t) * (memberVariableCount + 1)));
-            Serializer<uint64_t>::Serialize(stream, memberVariableCount);
-            for (const auto& end : memberVariableContentEnds) {
-                Serializer<uint64_t>::Serialize(stream, end);
+            context.depth++;
+            Serializer<uint64_t>::Serialize(stream, schemaMarker);
+            stream.Seek(sizeof(uint64_t));
+            SerializeBody(stream, context, clazz, obj);
+            const uint64_t bodySize = stream.Loc() - begin - sizeof(uint64_t) * 2;
+
+            stream.Seek(-static_cast<int64_t>(bodySize) - static_cast<int64_t>(sizeof(uint64_t)));
+            Serializer<uint64_t>::Serialize(stream, bodySize);
+            stream.Seek(static_cast<int64_t>(bodySize));
+
+            Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(context.schemaClasses.size()));
+            for (const auto* schemaClass : context.schemaClasses) {
+                const auto& schema = schemaClass->GetSchema();
+                Serializer<std::string>::Serialize(stream, schemaClass->GetName());
+                Serializer<uint64_t>::Serialize(stream, schema.hash);
+                Serializer<bool>::Serialize(stream, schemaClass->GetBaseClass() != nullptr);
+                Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(schema.memberVariables.size()));
+                for (const auto* memberVariable : schema.memberVariables) {
+                    Serializer<std::string>::Serialize(stream, memberVariable->GetName());
+                }
             }
-            stream.Seek(static_cast<int64_t>(memberVariableContentSize));
-            return classNameSize + baseClassContentSize + sizeof(uint64_t) * (memberVariableCount + 2) + memberVariableContentSize; // NOLINT
+            context.schemaIndices.clear();
+            context.schemaClasses.clear();
+            context.depth--;
+            return stream.Loc() - begin;
         }
 
         static size_t DeserializeDyn(BinaryDeserializeStream& stream, const Mirror::Class& clazz, const Mirror::Argument& obj)
+        {
+            auto& context = stream.GetContext<Mirror::Internal::MetaObjectDeserializeContext>();
+            const auto begin = stream.Loc();
+            if (context.depth > 0) {
+                context.depth++;
+                DeserializeBody(stream, context, &clazz, obj);
+                context.depth--;
+                return stream.Loc() - begin;
+            }
+
+            uint64_t marker = 0;
+            Serializer<uint64_t>::Deserialize(stream, marker);
+            if (marker != schemaMarker) {
+                stream.Seek(-static_cast<int64_t>(sizeof(uint64_t)));
+                return DeserializeDynLegacy(stream, clazz, obj);
+            }
+
+            uint64_t bodySize = 0;
+            Serializer<uint64_t>::Deserialize(stream, bodySize);
+            const auto bodyBegin = stream.Loc();
+            stream.Seek(static_cast<int64_t>(bodySize));
+
+            uint32_t schemaCount = 0;
+            Serializer<uint32_t>::Deserialize(stream, schemaCount);
+            context.schemas.resize(schemaCount);
+            for (auto& schema : context.schemas) {
+                uint32_t memberVariableCount = 0;
+                Serializer<std::string>::Deserialize(stream, schema.className);
+                Serializer<uint64_t>::Deserialize(stream, schema.hash);
+                Serializer<bool>::Deserialize(stream, schema.hasBaseClass);
+                Serializer<uint32_t>::Deserialize(stream, memberVariableCount);
+                schema.memberVariableNames.resize(memberVariableCount);
+                for (auto& memberVariableName : schema.memberVariableNames) {
+                    Serializer<std::string>::Deserialize(stream, memberVariableName);
+                }
+            }
+            const auto end = stream.Loc();
+
+            stream.Seek(static_cast<int64_t>(bodyBegin) - static_cast<int64_t>(end));
+            context.depth++;
+            DeserializeBody(stream, context, &clazz, obj);
+            context.depth--;
+            context.schemas.clear();
+
+            stream.Seek(static_cast<int64_t>(end) - static_cast<int64_t>(stream.Loc()));
+            return end - begin;
+        }
+
+        static size_t DeserializeDynLegacy(BinaryDeserializeStream& stream, const Mirror::Class& clazz, const Mirror::Argument& obj)
         {
             Assert(!clazz.IsTransient());
             const auto& className = clazz.GetName();
@@ -1734,7 +1885,7 @@ namespace Common { // NOLINT
             uint64_t aspectBaseClassContentSize = 0;
             Serializer<uint64_t>::Deserialize(stream, aspectBaseClassContentSize);
             if (aspectBaseClassContentSize != 0 && baseClass != nullptr) {
-                const auto actualBaseClassContentSize = DeserializeDyn(stream, *baseClass, obj);
+                const auto actualBaseClassContentSize = DeserializeDynLegacy(stream, *baseClass, obj);
                 stream.Seek(static_cast<int64_t>(aspectBaseClassContentSize) - static_cast<int64_t>(actualBaseClassContentSize));
             }
 
@@ -2710,7 +2861,8 @@ namespace Mirror {
             Common::CppCopyAssignable<T>,
             Common::CppMoveConstructible<T>,
             Common::CppMoveAssignable<T>,
-            Common::EqualComparable<T>
+            Common::EqualComparable<T>,
+            Common::CppTriviallyCopyable<T>
         };
         return &typeInfo;
     }
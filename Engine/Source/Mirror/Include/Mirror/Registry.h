@@ -235,7 +235,10 @@ namespace Mirror {
     }
 
     template <typename C>
-    ClassRegistry<C>::~ClassRegistry() = default;
+    ClassRegistry<C>::~ClassRegistry()
+    {
+        clazz.BuildSchema();
+    }
 
     template <typename C>
     template <typename... Args, FieldAccess Access>
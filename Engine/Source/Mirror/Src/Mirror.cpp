@@ -3,6 +3,7 @@
 //
 
 #include <ranges>
+#include <algorithm>
 #include <utility>
 #include <sstream>
 
@@ -1400,6 +1401,7 @@ namespace Mirror {
         , memorySize(params.memorySize)
         , baseClassGetter(std::move(params.baseClassGetter))
         , inplaceGetter(std::move(params.inplaceGetter))
+        , schema()
     {
         CreateDefaultObject(params.defaultObjectCreator);
         if (params.destructorParams.has_value()) {
@@ -1823,6 +1825,31 @@ namespace Mirror {
         return GetMetaBoolOr(MetaPresets::transient, false);
     }
 
+    const ClassSchema& Class::GetSchema() const
+    {
+        return schema;
+    }
+
+    void Class::BuildSchema()
+    {
+        schema.memberVariables.clear();
+        for (const auto& memberVariable : memberVariables | std::views::values) {
+            if (!memberVariable.IsTransient()) {
+                schema.memberVariables.emplace_back(&memberVariable);
+            }
+        }
+        std::ranges::sort(schema.memberVariables, [](const MemberVariable* lhs, const MemberVariable* rhs) -> bool {
+            return lhs->GetName() < rhs->GetName();
+        });
+
+        std::string schemaStr = GetName();
+        for (const auto* memberVariable : schema.memberVariables) {
+            schemaStr += ';';
+            schemaStr += memberVariable->GetName();
+        }
+        schema.hash = Common::HashUtils::CityHash(schemaStr.data(), schemaStr.size());
+    }
+
     EnumValue::EnumValue(ConstructParams&& inParams)
         : ReflNode(std::move(inParams.id))
         , owner(std::move(inParams.owner))
@@ -139,6 +139,132 @@ TEST(SerializationTest, MetaObjectWithBaseClassTest)
         SerializationTestStruct2 { { 1, 2, "3.0" }, 4.0 });
 }
 
+TEST(SerializationTest, MetaObjectSchemaTableTest)
+{
+    SerializationTestStruct1 obj;
+    for (auto i = 0; i < 1024; i++) {
+        obj.e.emplace_back(SerializationTestStruct0 { i, static_cast<float>(i), std::to_string(i) });
+    }
+
+    std::vector<uint8_t> buffer;
+    {
+        Common::MemorySerializeStream stream(buffer);
+        Serialize(stream, obj);
+    }
+
+    // schema of element class is written once in the table of root object
+    const std::string bufferStr(buffer.begin(), buffer.end());
+    const std::string className = "SerializationTestStruct0";
+    const auto firstPos = bufferStr.find(className);
+    ASSERT_NE(firstPos, std::string::npos);
+    ASSERT_EQ(bufferStr.find(className, firstPos + 1), std::string::npos);
+
+    {
+        Common::MemoryDeserializeStream stream(buffer);
+        SerializationTestStruct1 restored;
+        Deserialize(stream, restored);
+        ASSERT_EQ(restored, obj);
+    }
+}
+
+// writes a root meta object of class inClassName as a stream written with a different schema would, member values
+// are in schema order and the schema hash never matches, so members are resolved by name
+template <typename... T>
+std::vector<uint8_t> MakeSchemaBlob(const std::string& inClassName, const std::vector<std::string>& inMemberNames, const T&... inValues)
+{
+    std::vector<uint8_t> body;
+    {
+        Common::MemorySerializeStream stream(body);
+        Common::Serializer<uint32_t>::Serialize(stream, 0);
+        (Serialize(stream, inValues), ...);
+    }
+
+    std::vector<uint8_t> blob;
+    Common::MemorySerializeStream stream(blob);
+    Common::Serializer<uint64_t>::Serialize(stream, Common::Serializer<SerializationTestStruct0>::schemaMarker);
+    Common::Serializer<uint64_t>::Serialize(stream, body.size());
+    stream.WriteBulk(body.data(), body.size());
+    Common::Serializer<uint32_t>::Serialize(stream, 1);
+    Common::Serializer<std::string>::Serialize(stream, inClassName);
+    Common::Serializer<uint64_t>::Serialize(stream, 0);
+    Common::Serializer<bool>::Serialize(stream, false);
+    Common::Serializer<uint32_t>::Serialize(stream, static_cast<uint32_t>(inMemberNames.size()));
+    for (const auto& memberName : inMemberNames) {
+        Common::Serializer<std::string>::Serialize(stream, memberName);
+    }
+    return blob;
+}
+
+SerializationTestStruct0 DeserializeStruct0Blob(const std::vector<uint8_t>& inBlob)
+{
+    SerializationTestStruct0 result { 5, 6.0f, "7" };
+    Common::MemoryDeserializeStream stream(inBlob);
+    const auto deserialized = Common::Serializer<SerializationTestStruct0>::Deserialize(stream, result);
+    EXPECT_EQ(deserialized, inBlob.size());
+    EXPECT_EQ(stream.Loc(), inBlob.size());
+    return result;
+}
+
+TEST(SerializationTest, MetaObjectSchemaAddedFieldTest)
+{
+    const auto blob = MakeSchemaBlob("SerializationTestStruct0", { "a", "added", "b", "c" }, 1, 3.0, 2.0f, std::string("4"));
+    ASSERT_EQ(DeserializeStruct0Blob(blob), (SerializationTestStruct0 { 1, 2.0f, "4" }));
+}
+
+TEST(SerializationTest, MetaObjectSchemaRemovedFieldTest)
+{
+    const auto blob = MakeSchemaBlob("SerializationTestStruct0", { "a", "c" }, 1, std::string("4"));
+    ASSERT_EQ(DeserializeStruct0Blob(blob), (SerializationTestStruct0 { 1, 6.0f, "4" }));
+}
+
+TEST(SerializationTest, MetaObjectSchemaReorderedFieldTest)
+{
+    const auto blob = MakeSchemaBlob("SerializationTestStruct0", { "c", "b", "a" }, std::string("4"), 2.0f, 1);
+    ASSERT_EQ(DeserializeStruct0Blob(blob), (SerializationTestStruct0 { 1, 2.0f, "4" }));
+}
+
+TEST(SerializationTest, MetaObjectSchemaClassMismatchTest)
+{
+    const auto blob = MakeSchemaBlob("SerializationTestStruct2", { "a", "b", "c" }, 1, 2.0f, std::string("4"));
+    ASSERT_EQ(DeserializeStruct0Blob(blob), (SerializationTestStruct0 { 5, 6.0f, "7" }));
+}
+
+TEST(SerializationTest, MetaObjectLegacyTest)
+{
+    // pre-schema format, class name and member names written for every object, with an unknown member to skip
+    const auto makeMember = [](const std::string& inName, const auto& inValue) -> std::vector<uint8_t> {
+        std::vector<uint8_t> member;
+        Common::MemorySerializeStream stream(member);
+        Common::Serializer<std::string>::Serialize(stream, inName);
+        Common::Serializer<bool>::Serialize(stream, false);
+        Serialize(stream, inValue);
+        return member;
+    };
+    const std::vector<std::vector<uint8_t>> members = {
+        makeMember("c", std::string("4")),
+        makeMember("removed", 3.0),
+        makeMember("a", 1),
+        makeMember("b", 2.0f)
+    };
+
+    std::vector<uint8_t> blob;
+    {
+        Common::MemorySerializeStream stream(blob);
+        Common::Serializer<std::string>::Serialize(stream, std::string("SerializationTestStruct0"));
+        Common::Serializer<uint64_t>::Serialize(stream, 0);
+        Common::Serializer<uint64_t>::Serialize(stream, members.size());
+        uint64_t memberEnd = 0;
+        for (const auto& member : members) {
+            memberEnd += member.size();
+            Common::Serializer<uint64_t>::Serialize(stream, memberEnd);
+        }
+        for (const auto& member : members) {
+            stream.WriteBulk(member.data(), member.size());
+        }
+    }
+    ASSERT_EQ(DeserializeStruct0Blob(blob), (SerializationTestStruct0 { 1, 2.0f, "4" }));
+}
+
 TEST(SerializationTest, EnumSerializationTest)
 {
     PerformSerializationTest<SerializationTestEnum>(
@@ -93,6 +93,7 @@ namespace RHI::DirectX12 {
 
         bool CheckSwapChainFormatSupport(Surface* inSurface, PixelFormat inFormat) override;
         TextureSubResourceCopyFootprint GetTextureSubResourceCopyFootprint(const Texture& texture, const TextureSubResourceInfo& subResourceInfo) override;
+        std::vector<uint8_t> GetPipelineCacheData() const override;
 
         ID3D12Device* GetNative() const;
         Common::UniquePtr<DescriptorAllocation> AllocateRtvDescriptor() const;
@@ -19,6 +19,7 @@ namespace RHI::DirectX12 {
         ~DX12Queue() override;
 
         void Submit(CommandBuffer* inCmdBuffer, const QueueSubmitInfo& inSubmitInfo) override;
+        void Submit(const std::vector<CommandBuffer*>& inCmdBuffers, const QueueSubmitInfo& inSubmitInfo) override;
         void Flush(Fence* inFenceToSignal) override;
 
         ID3D12CommandQueue* GetNative() const;
@@ -379,6 +379,16 @@ namespace RHI::DirectX12 {
             afterState = EnumCast<TextureState, D3D12_RESOURCE_STATES>(inBarrier.texture.after);
         }
 
+        // a transition between the same states is invalid, same state barriers are only emitted to order accesses of
+        // the same resource, which only unordered access needs in d3d12
+        if (beforeState == afterState) {
+            if (beforeState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS) {
+                const CD3DX12_RESOURCE_BARRIER uavBarrier = CD3DX12_RESOURCE_BARRIER::UAV(resource);
+                commandBuffer.GetNativeCmdList()->ResourceBarrier(1, &uavBarrier);
+            }
+            return;
+        }
+
         const CD3DX12_RESOURCE_BARRIER resourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(resource, beforeState, afterState);
         commandBuffer.GetNativeCmdList()->ResourceBarrier(1, &resourceBarrier);
     }
@@ -278,6 +278,13 @@ namespace RHI::DirectX12 {
         return result;
     }
 
+    std::vector<uint8_t> DX12Device::GetPipelineCacheData() const
+    {
+        // not supported yet, pipelines are recompiled from bytecode every run, an ID3D12PipelineLibrary would need a
+        // stable name for each stored pipeline
+        return {};
+    }
+
     ID3D12Device* DX12Device::GetNative() const
     {
         return nativeDevice.Get();
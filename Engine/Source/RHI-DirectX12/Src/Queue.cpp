@@ -2,7 +2,7 @@
 // Created by johnk on 15/1/2022.
 //
 
-#include <array>
+#include <vector>
 
 #include <Common/Debug.h>
 #include <RHI/DirectX12/Queue.h>
@@ -16,15 +16,23 @@ namespace RHI::DirectX12 {
 
     void DX12Queue::Submit(CommandBuffer* inCmdBuffer, const QueueSubmitInfo& inSubmitInfo)
     {
-        const auto* commandBuffer = static_cast<DX12CommandBuffer*>(inCmdBuffer);
-        Assert(commandBuffer);
+        Submit(std::vector { inCmdBuffer }, inSubmitInfo);
+    }
 
+    void DX12Queue::Submit(const std::vector<CommandBuffer*>& inCmdBuffers, const QueueSubmitInfo& inSubmitInfo)
+    {
         for (auto i = 0; i < inSubmitInfo.waitSemaphores.size(); i++) {
             auto* waitSemaphore = static_cast<DX12Semaphore*>(inSubmitInfo.waitSemaphores[i]);
             Assert(SUCCEEDED(nativeCmdQueue->Wait(waitSemaphore->GetNative(), 1)));
         }
 
-        std::array<ID3D12CommandList*, 1> cmdListsToExecute = { commandBuffer->GetNativeCmdList() };
+        std::vector<ID3D12CommandList*> cmdListsToExecute;
+        cmdListsToExecute.reserve(inCmdBuffers.size());
+        for (auto* cmdBuffer : inCmdBuffers) {
+            const auto* commandBuffer = static_cast<DX12CommandBuffer*>(cmdBuffer);
+            Assert(commandBuffer);
+            cmdListsToExecute.emplace_back(commandBuffer->GetNativeCmdList());
+        }
         nativeCmdQueue->ExecuteCommandLists(cmdListsToExecute.size(), cmdListsToExecute.data());
 
         for (auto i = 0; i < inSubmitInfo.signalSemaphores.size(); i++) {
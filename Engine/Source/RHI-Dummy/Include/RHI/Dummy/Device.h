@@ -36,9 +36,11 @@ namespace RHI::Dummy {
 
         bool CheckSwapChainFormatSupport(Surface *surface, PixelFormat format) override;
         TextureSubResourceCopyFootprint GetTextureSubResourceCopyFootprint(const Texture& texture, const TextureSubResourceInfo& subResourceInfo) override;
+        std::vector<uint8_t> GetPipelineCacheData() const override;
 
     private:
         DummyGpu& gpu;
+        std::vector<uint8_t> pipelineCacheData;
         Common::UniquePtr<DummyQueue> dummyQueue;
     };
 }
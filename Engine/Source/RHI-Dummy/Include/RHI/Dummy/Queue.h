@@ -14,6 +14,7 @@ namespace RHI::Dummy {
         ~DummyQueue() override;
 
         void Submit(RHI::CommandBuffer* commandBuffer, const RHI::QueueSubmitInfo& submitInfo) override;
+        void Submit(const std::vector<RHI::CommandBuffer*>& commandBuffers, const RHI::QueueSubmitInfo& submitInfo) override;
         void Flush(RHI::Fence* fenceToSignal) override;
     };
 }
@@ -22,6 +22,7 @@ namespace RHI::Dummy {
     DummyDevice::DummyDevice(DummyGpu& gpu, const DeviceCreateInfo& createInfo)
         : Device(createInfo)
         , gpu(gpu)
+        , pipelineCacheData(createInfo.pipelineCacheData)
         , dummyQueue(Common::MakeUnique<DummyQueue>())
     {
     }
@@ -123,4 +124,10 @@ namespace RHI::Dummy {
     {
         return {};
     }
+
+    std::vector<uint8_t> DummyDevice::GetPipelineCacheData() const
+    {
+        // no real pipelines are compiled, the blob is passed through so callers can round trip it
+        return pipelineCacheData;
+    }
 }
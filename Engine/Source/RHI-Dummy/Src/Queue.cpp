@@ -13,6 +13,10 @@ namespace RHI::Dummy {
     {
     }
 
+    void DummyQueue::Submit(const std::vector<RHI::CommandBuffer*>& commandBuffers, const QueueSubmitInfo& submitInfo)
+    {
+    }
+
     void DummyQueue::Flush(RHI::Fence* fenceToSignal)
     {
     }
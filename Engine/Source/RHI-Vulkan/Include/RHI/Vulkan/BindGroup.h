@@ -21,11 +21,10 @@ namespace RHI::Vulkan {
         VkDescriptorSet GetNative() const;
 
     private:
-        void CreateNativeDescriptorPool(const BindGroupCreateInfo& inCreateInfo);
         void CreateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo);
 
         VulkanDevice& device;
         VkDescriptorSet nativeDescriptorSet;
-        VkDescriptorPool nativeDescriptorPool;
+        size_t descriptorPoolIndex;
     };
 }
\ No newline at end of file
@@ -16,7 +16,7 @@ namespace RHI::Vulkan {
     class VulkanCommandBuffer final : public CommandBuffer {
     public:
         NonCopyable(VulkanCommandBuffer)
-        VulkanCommandBuffer(VulkanDevice& inDevice, VkCommandPool inNativeCmdPool);
+        VulkanCommandBuffer(VulkanDevice& inDevice, uint32_t inQueueFamilyIndex);
         ~VulkanCommandBuffer() override;
 
         Common::UniquePtr<CommandRecorder> Begin() override;
@@ -24,6 +24,7 @@ namespace RHI::Vulkan {
         VkCommandBuffer GetNative() const;
 
     private:
+        void CreateNativeCommandPool(uint32_t inQueueFamilyIndex);
         void CreateNativeCommandBuffer();
 
         VulkanDevice& device;
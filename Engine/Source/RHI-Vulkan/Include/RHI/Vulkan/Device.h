@@ -5,6 +5,7 @@
 #pragma once
 
 #include <optional>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -43,9 +44,15 @@ namespace RHI::Vulkan {
 
         bool CheckSwapChainFormatSupport(Surface* inSurface, PixelFormat inFormat) override;
         TextureSubResourceCopyFootprint GetTextureSubResourceCopyFootprint(const Texture& texture, const TextureSubResourceInfo& subResourceInfo) override;
+        std::vector<uint8_t> GetPipelineCacheData() const override;
 
         VkDevice GetNative() const;
         VmaAllocator& GetNativeAllocator();
+        VkPipelineCache GetNativePipelineCache() const;
+        // descriptor sets are allocated from pools shared by all bind groups, a pool is reset and reused once all sets
+        // allocated from it are released
+        VkDescriptorSet AllocateNativeDescriptorSet(VkDescriptorSetLayout inLayout, size_t& outPoolIndex);
+        void ReleaseNativeDescriptorSet(size_t inPoolIndex);
 
 #if BUILD_CONFIG_DEBUG
         void SetObjectName(VkObjectType inObjectType, uint64_t inObjectHandle, const char* inObjectName) const;
@@ -56,12 +63,24 @@ namespace RHI::Vulkan {
         void CreateNativeDevice(const DeviceCreateInfo& inCreateInfo);
         void GetQueues();
         void CreateNativeVmaAllocator();
+        void CreateNativePipelineCache(const DeviceCreateInfo& inCreateInfo);
+        bool IsPipelineCacheDataCompatible(const std::vector<uint8_t>& inData) const;
+        VkDescriptorPool CreateNativeDescriptorPool() const;
+
+        struct DescriptorPool {
+            VkDescriptorPool nativePool;
+            uint32_t liveSetNum;
+        };
 
         VulkanGpu& gpu;
         VkDevice nativeDevice;
         VmaAllocator nativeAllocator;
+        VkPipelineCache nativePipelineCache;
         std::unordered_map<QueueType, std::pair<uint32_t, uint32_t>> queueFamilyMappings;
         std::unordered_map<QueueType, std::vector<Common::UniquePtr<VulkanQueue>>> queues;
-        std::unordered_map<QueueType, VkCommandPool> nativeCmdPools;
+        std::mutex descriptorPoolMutex;
+        std::vector<DescriptorPool> descriptorPools;
+        std::vector<size_t> freeDescriptorPools;
+        std::optional<size_t> currentDescriptorPool;
     };
 }
@@ -6,6 +6,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 
 #include <vulkan/vulkan.h>
 
@@ -30,6 +31,8 @@ namespace RHI::Vulkan {
         template <typename T>
         T FindOrGetTypedDynamicFuncPointer(const std::string& inName)
         {
+            // command buffers may be recorded from several threads
+            std::unique_lock lock(dynamicFuncPointersMutex);
             if (const auto iter = dynamicFuncPointers.find(inName);
                 iter != dynamicFuncPointers.end()) {
                 return reinterpret_cast<T>(iter->second);
@@ -55,6 +58,7 @@ namespace RHI::Vulkan {
         VkInstance nativeInstance;
         std::vector<VkPhysicalDevice> nativePhysicalDevices;
         std::vector<Common::UniquePtr<Gpu>> gpus;
+        std::mutex dynamicFuncPointersMutex;
         std::unordered_map<std::string, PFN_vkVoidFunction> dynamicFuncPointers;
     };
 }
@@ -19,6 +19,7 @@ namespace RHI::Vulkan {
         ~VulkanQueue() override;
 
         void Submit(CommandBuffer* inCmdBuffer, const QueueSubmitInfo& inSubmitInfo) override;
+        void Submit(const std::vector<CommandBuffer*>& inCmdBuffers, const QueueSubmitInfo& inSubmitInfo) override;
         void Flush(Fence* inFenceToSignal) override;
 
         VkQueue GetNative() const;
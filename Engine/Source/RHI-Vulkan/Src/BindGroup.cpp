@@ -15,15 +15,16 @@ namespace RHI::Vulkan {
     VulkanBindGroup::VulkanBindGroup(VulkanDevice& inDevice, const BindGroupCreateInfo& inCreateInfo)
         : BindGroup(inCreateInfo)
         , device(inDevice)
+        , nativeDescriptorSet(VK_NULL_HANDLE)
+        , descriptorPoolIndex(0)
     {
-        CreateNativeDescriptorPool(inCreateInfo);
         CreateNativeDescriptorSet(inCreateInfo);
     }
 
     VulkanBindGroup::~VulkanBindGroup() noexcept
     {
-        if (nativeDescriptorPool != VK_NULL_HANDLE) {
-            vkDestroyDescriptorPool(device.GetNative(), nativeDescriptorPool, nullptr);
+        if (nativeDescriptorSet != VK_NULL_HANDLE) {
+            device.ReleaseNativeDescriptorSet(descriptorPoolIndex);
         }
     }
 
@@ -32,38 +33,10 @@ namespace RHI::Vulkan {
         return nativeDescriptorSet;
     }
 
-    void VulkanBindGroup::CreateNativeDescriptorPool(const BindGroupCreateInfo& inCreateInfo)
-    {
-        const auto entryCount = inCreateInfo.entries.size();
-
-        std::vector<VkDescriptorPoolSize> poolSizes(entryCount);
-        for (auto i = 0; i < entryCount; i++) {
-            const auto& entry = inCreateInfo.entries[i];
-
-            poolSizes[i].type = EnumCast<BindingType, VkDescriptorType>(entry.binding.type);
-            poolSizes[i].descriptorCount = 1;
-        }
-
-        VkDescriptorPoolCreateInfo poolInfo {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-        poolInfo.pPoolSizes = poolSizes.data();
-        poolInfo.poolSizeCount = poolSizes.size();
-        poolInfo.maxSets = 1;
-
-        Assert(vkCreateDescriptorPool(device.GetNative(), &poolInfo, nullptr, &nativeDescriptorPool) == VK_SUCCESS);
-    }
-
     void VulkanBindGroup::CreateNativeDescriptorSet(const BindGroupCreateInfo& inCreateInfo)
     {
         const VkDescriptorSetLayout layout = static_cast<VulkanBindGroupLayout*>(inCreateInfo.layout)->GetNative();
-
-        VkDescriptorSetAllocateInfo allocInfo {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorSetCount = 1;
-        allocInfo.pSetLayouts = &layout;
-        allocInfo.descriptorPool = nativeDescriptorPool;
-
-        Assert(vkAllocateDescriptorSets(device.GetNative(), &allocInfo, &nativeDescriptorSet) == VK_SUCCESS);
+        nativeDescriptorSet = device.AllocateNativeDescriptorSet(layout, descriptorPoolIndex);
 
 #if BUILD_CONFIG_DEBUG
         if (!inCreateInfo.debugName.empty()) {
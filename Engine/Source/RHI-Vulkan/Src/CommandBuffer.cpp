@@ -8,10 +8,10 @@
 #include <Common/Debug.h>
 
 namespace RHI::Vulkan {
-    VulkanCommandBuffer::VulkanCommandBuffer(VulkanDevice& inDevice, VkCommandPool inNativeCmdPool) // NOLINT
+    VulkanCommandBuffer::VulkanCommandBuffer(VulkanDevice& inDevice, uint32_t inQueueFamilyIndex) // NOLINT
         : device(inDevice)
-        , pool(inNativeCmdPool)
     {
+        CreateNativeCommandPool(inQueueFamilyIndex);
         CreateNativeCommandBuffer();
     }
 
@@ -21,6 +21,9 @@ namespace RHI::Vulkan {
         if (nativeCmdBuffer != VK_NULL_HANDLE) {
             vkFreeCommandBuffers(vkDevice, pool, 1, &nativeCmdBuffer);
         }
+        if (pool != VK_NULL_HANDLE) {
+            vkDestroyCommandPool(vkDevice, pool, nullptr);
+        }
     }
 
     Common::UniquePtr<CommandRecorder> VulkanCommandBuffer::Begin()
@@ -39,6 +42,18 @@ namespace RHI::Vulkan {
         return nativeCmdBuffer;
     }
 
+    void VulkanCommandBuffer::CreateNativeCommandPool(uint32_t inQueueFamilyIndex)
+    {
+        // command pools are externally synchronized, a pool per command buffer lets command buffers be recorded on
+        // different threads at the same time
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolInfo.queueFamilyIndex = inQueueFamilyIndex;
+
+        Assert(vkCreateCommandPool(device.GetNative(), &poolInfo, nullptr, &pool) == VK_SUCCESS);
+    }
+
     void VulkanCommandBuffer::CreateNativeCommandBuffer()
     {
         VkCommandBufferAllocateInfo cmdInfo = {};
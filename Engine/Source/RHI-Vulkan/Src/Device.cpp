@@ -3,7 +3,9 @@
 //
 
 #include <map>
+#include <array>
 #include <algorithm>
+#include <cstring>
 
 #include <RHI/Vulkan/Common.h>
 #include <RHI/Vulkan/Instance.h>
@@ -44,18 +46,23 @@ namespace RHI::Vulkan {
     VulkanDevice::VulkanDevice(VulkanGpu& inGpu, const DeviceCreateInfo& inCreateInfo)
         : Device(inCreateInfo)
         , gpu(inGpu)
+        , nativePipelineCache(VK_NULL_HANDLE)
     {
         CreateNativeDevice(inCreateInfo);
         GetQueues();
         CreateNativeVmaAllocator();
+        CreateNativePipelineCache(inCreateInfo);
     }
 
     VulkanDevice::~VulkanDevice()
     {
         vmaDestroyAllocator(nativeAllocator);
 
-        for (auto& [queue, pool] : nativeCmdPools) {
-            vkDestroyCommandPool(nativeDevice, pool, nullptr);
+        if (nativePipelineCache != VK_NULL_HANDLE) {
+            vkDestroyPipelineCache(nativeDevice, nativePipelineCache, nullptr);
+        }
+        for (const auto& descriptorPool : descriptorPools) {
+            vkDestroyDescriptorPool(nativeDevice, descriptorPool.nativePool, nullptr);
         }
         vkDestroyDevice(nativeDevice, nullptr);
     }
@@ -134,7 +141,7 @@ namespace RHI::Vulkan {
 
     Common::UniquePtr<CommandBuffer> VulkanDevice::CreateCommandBuffer()
     {
-        return { new VulkanCommandBuffer(*this, nativeCmdPools[QueueType::graphics]) };
+        return { new VulkanCommandBuffer(*this, queueFamilyMappings.at(QueueType::graphics).first) };
     }
 
     Common::UniquePtr<Fence> VulkanDevice::CreateFence(const bool initAsSignaled)
@@ -186,6 +193,16 @@ namespace RHI::Vulkan {
         return result;
     }
 
+    std::vector<uint8_t> VulkanDevice::GetPipelineCacheData() const
+    {
+        size_t dataSize = 0;
+        Assert(vkGetPipelineCacheData(nativeDevice, nativePipelineCache, &dataSize, nullptr) == VK_SUCCESS);
+        std::vector<uint8_t> result(dataSize);
+        Assert(vkGetPipelineCacheData(nativeDevice, nativePipelineCache, &dataSize, result.data()) == VK_SUCCESS);
+        result.resize(dataSize);
+        return result;
+    }
+
     VkDevice VulkanDevice::GetNative() const
     {
         return nativeDevice;
@@ -281,10 +298,6 @@ namespace RHI::Vulkan {
 
     void VulkanDevice::GetQueues()
     {
-        VkCommandPoolCreateInfo poolInfo = {};
-        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-
         for (auto [queueType, queueFamilyInfo] : queueFamilyMappings) {
             auto [queueFamilyIndex, queueNum] = queueFamilyInfo;
 
@@ -295,15 +308,31 @@ namespace RHI::Vulkan {
                 tempQueues[i] = Common::MakeUnique<VulkanQueue>(*this, queue);
             }
             queues[queueType] = std::move(tempQueues);
-
-            poolInfo.queueFamilyIndex = queueFamilyIndex;
-
-            VkCommandPool pool;
-            Assert(vkCreateCommandPool(nativeDevice, &poolInfo, nullptr, &pool) == VK_SUCCESS);
-            nativeCmdPools.emplace(queueType, pool);
         }
     }
 
+    VkDescriptorPool VulkanDevice::CreateNativeDescriptorPool() const
+    {
+        static constexpr uint32_t maxSets = 1024;
+        static constexpr std::array poolSizes = {
+            VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, maxSets * 4 },
+            VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, maxSets * 4 },
+            VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_SAMPLER, maxSets * 2 },
+            VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, maxSets * 4 },
+            VkDescriptorPoolSize { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, maxSets * 2 }
+        };
+
+        VkDescriptorPoolCreateInfo poolInfo {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.pPoolSizes = poolSizes.data();
+        poolInfo.poolSizeCount = poolSizes.size();
+        poolInfo.maxSets = maxSets;
+
+        VkDescriptorPool result;
+        Assert(vkCreateDescriptorPool(nativeDevice, &poolInfo, nullptr, &result) == VK_SUCCESS);
+        return result;
+    }
+
     void VulkanDevice::CreateNativeVmaAllocator()
     {
         VmaVulkanFunctions vulkanFunctions = {};
@@ -325,6 +354,93 @@ namespace RHI::Vulkan {
         return nativeAllocator;
     }
 
+    VkPipelineCache VulkanDevice::GetNativePipelineCache() const
+    {
+        return nativePipelineCache;
+    }
+
+    void VulkanDevice::CreateNativePipelineCache(const DeviceCreateInfo& inCreateInfo)
+    {
+        const bool useInitialData = IsPipelineCacheDataCompatible(inCreateInfo.pipelineCacheData);
+
+        VkPipelineCacheCreateInfo createInfo {};
+        createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        createInfo.initialDataSize = useInitialData ? inCreateInfo.pipelineCacheData.size() : 0;
+        createInfo.pInitialData = useInitialData ? inCreateInfo.pipelineCacheData.data() : nullptr;
+        Assert(vkCreatePipelineCache(nativeDevice, &createInfo, nullptr, &nativePipelineCache) == VK_SUCCESS);
+    }
+
+    bool VulkanDevice::IsPipelineCacheDataCompatible(const std::vector<uint8_t>& inData) const
+    {
+        // drivers are required to reject incompatible blobs, but some of them crash instead, so the header is checked
+        // against the current gpu before the blob is handed over
+        if (inData.size() < sizeof(VkPipelineCacheHeaderVersionOne)) {
+            return false;
+        }
+
+        VkPipelineCacheHeaderVersionOne header {};
+        memcpy(&header, inData.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(gpu.GetNative(), &properties);
+        return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+            && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header.vendorID == properties.vendorID
+            && header.deviceID == properties.deviceID
+            && memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    VkDescriptorSet VulkanDevice::AllocateNativeDescriptorSet(VkDescriptorSetLayout inLayout, size_t& outPoolIndex)
+    {
+        std::unique_lock lock(descriptorPoolMutex);
+
+        VkDescriptorSetAllocateInfo allocInfo {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &inLayout;
+
+        VkDescriptorSet result = VK_NULL_HANDLE;
+        if (currentDescriptorPool.has_value()) {
+            allocInfo.descriptorPool = descriptorPools[currentDescriptorPool.value()].nativePool;
+            if (vkAllocateDescriptorSets(nativeDevice, &allocInfo, &result) == VK_SUCCESS) {
+                outPoolIndex = currentDescriptorPool.value();
+                descriptorPools[outPoolIndex].liveSetNum++;
+                return result;
+            }
+        }
+
+        // current pool is exhausted or fragmented, it is reset when its sets are all released
+        if (currentDescriptorPool.has_value() && descriptorPools[currentDescriptorPool.value()].liveSetNum == 0) {
+            Assert(vkResetDescriptorPool(nativeDevice, descriptorPools[currentDescriptorPool.value()].nativePool, 0) == VK_SUCCESS);
+            freeDescriptorPools.emplace_back(currentDescriptorPool.value());
+        }
+        if (freeDescriptorPools.empty()) {
+            currentDescriptorPool = descriptorPools.size();
+            descriptorPools.emplace_back(DescriptorPool { CreateNativeDescriptorPool(), 0 });
+        } else {
+            currentDescriptorPool = freeDescriptorPools.back();
+            freeDescriptorPools.pop_back();
+        }
+
+        outPoolIndex = currentDescriptorPool.value();
+        allocInfo.descriptorPool = descriptorPools[outPoolIndex].nativePool;
+        Assert(vkAllocateDescriptorSets(nativeDevice, &allocInfo, &result) == VK_SUCCESS);
+        descriptorPools[outPoolIndex].liveSetNum++;
+        return result;
+    }
+
+    void VulkanDevice::ReleaseNativeDescriptorSet(size_t inPoolIndex)
+    {
+        std::unique_lock lock(descriptorPoolMutex);
+
+        auto& [nativePool, liveSetNum] = descriptorPools[inPoolIndex];
+        Assert(liveSetNum > 0);
+        if (--liveSetNum == 0 && currentDescriptorPool != inPoolIndex) {
+            Assert(vkResetDescriptorPool(nativeDevice, nativePool, 0) == VK_SUCCESS);
+            freeDescriptorPools.emplace_back(inPoolIndex);
+        }
+    }
+
 #if BUILD_CONFIG_DEBUG
     void VulkanDevice::SetObjectName(const VkObjectType inObjectType, const uint64_t inObjectHandle, const char* inObjectName) const
     {
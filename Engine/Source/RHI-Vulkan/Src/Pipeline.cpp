@@ -255,7 +255,7 @@ namespace RHI::Vulkan {
         pipelineCreateInfo.pVertexInputState = &vtxInput;
         pipelineCreateInfo.pNext = &pipelineRenderingCreateInfo;
 
-        Assert(vkCreateGraphicsPipelines(device.GetNative(), VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &nativePipeline) == VK_SUCCESS);
+        Assert(vkCreateGraphicsPipelines(device.GetNative(), device.GetNativePipelineCache(), 1, &pipelineCreateInfo, nullptr, &nativePipeline) == VK_SUCCESS);
 
 #if BUILD_CONFIG_DEBUG
         if (!inCreateInfo.debugName.empty()) {
@@ -310,7 +310,7 @@ namespace RHI::Vulkan {
         pipelineInfo.layout = pipelineLayout->GetNative();
         pipelineInfo.stage = stageInfo;
 
-        Assert(vkCreateComputePipelines(device.GetNative(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &nativePipeline) == VK_SUCCESS);
+        Assert(vkCreateComputePipelines(device.GetNative(), device.GetNativePipelineCache(), 1, &pipelineInfo, nullptr, &nativePipeline) == VK_SUCCESS);
     }
 
     VkPipeline VulkanComputePipeline::GetNative() const
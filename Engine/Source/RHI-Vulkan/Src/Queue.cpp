@@ -19,11 +19,20 @@ namespace RHI::Vulkan {
 
     void VulkanQueue::Submit(CommandBuffer* inCmdBuffer, const QueueSubmitInfo& inSubmitInfo)
     {
-        const auto* commandBuffer = static_cast<VulkanCommandBuffer*>(inCmdBuffer);
+        Submit(std::vector { inCmdBuffer }, inSubmitInfo);
+    }
+
+    void VulkanQueue::Submit(const std::vector<CommandBuffer*>& inCmdBuffers, const QueueSubmitInfo& inSubmitInfo)
+    {
         const auto* vkFence = static_cast<VulkanFence*>(inSubmitInfo.signalFence);
 
-        Assert(commandBuffer);
-        const VkCommandBuffer& cmdBuffer = commandBuffer->GetNative();
+        std::vector<VkCommandBuffer> cmdBuffers;
+        cmdBuffers.reserve(inCmdBuffers.size());
+        for (auto* cmdBuffer : inCmdBuffers) {
+            const auto* commandBuffer = static_cast<VulkanCommandBuffer*>(cmdBuffer);
+            Assert(commandBuffer);
+            cmdBuffers.emplace_back(commandBuffer->GetNative());
+        }
 
         std::vector<VkSemaphore> waitSemaphores;
         std::vector<VkPipelineStageFlags> waitStageFlags;
@@ -50,8 +59,8 @@ namespace RHI::Vulkan {
         vkSubmitInfo.pWaitDstStageMask = waitStageFlags.data();
         vkSubmitInfo.signalSemaphoreCount = signalSemaphores.size();
         vkSubmitInfo.pSignalSemaphores = signalSemaphores.data();
-        vkSubmitInfo.commandBufferCount = 1;
-        vkSubmitInfo.pCommandBuffers = &cmdBuffer;
+        vkSubmitInfo.commandBufferCount = cmdBuffers.size();
+        vkSubmitInfo.pCommandBuffers = cmdBuffers.data();
 
         const VkFence nativeFence = vkFence == nullptr ? VK_NULL_HANDLE : vkFence->GetNative();
         Assert(vkQueueSubmit(nativeQueue, 1, &vkSubmitInfo, nativeFence) == VK_SUCCESS);
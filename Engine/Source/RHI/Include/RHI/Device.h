@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 
 #include <Common/Utility.h>
 #include <RHI/Common.h>
@@ -53,9 +54,14 @@ namespace RHI {
 
     struct DeviceCreateInfo {
         std::vector<QueueRequestInfo> queueRequests;
+        // opaque blob returned by Device::GetPipelineCacheData() in a previous run, ignored by the backend if it is
+        // not compatible with the current driver, only the vulkan backend compiles pipelines with it yet, the directx12
+        // backend ignores it and returns an empty blob
+        std::vector<uint8_t> pipelineCacheData;
 
         DeviceCreateInfo();
         DeviceCreateInfo& AddQueueRequest(const QueueRequestInfo& inQueue);
+        DeviceCreateInfo& SetPipelineCacheData(std::vector<uint8_t> inData);
     };
 
     class Device {
@@ -83,6 +89,8 @@ namespace RHI {
 
         virtual bool CheckSwapChainFormatSupport(Surface* surface, PixelFormat format) = 0;
         virtual TextureSubResourceCopyFootprint GetTextureSubResourceCopyFootprint(const Texture& texture, const TextureSubResourceInfo& subResourceInfo) = 0;
+        // empty if the backend does not support pipeline cache data (see DeviceCreateInfo::pipelineCacheData)
+        virtual std::vector<uint8_t> GetPipelineCacheData() const = 0;
 
     protected:
         explicit Device(const DeviceCreateInfo& createInfo);
@@ -33,6 +33,8 @@ namespace RHI {
         virtual ~Queue();
 
         virtual void Submit(CommandBuffer* commandBuffer, const QueueSubmitInfo& submitInfo) = 0;
+        // command buffers are executed in order as one batch, waits apply before the first and signals after the last
+        virtual void Submit(const std::vector<CommandBuffer*>& commandBuffers, const QueueSubmitInfo& submitInfo) = 0;
         virtual void Flush(Fence* fenceToSignal) = 0;
 
     protected:
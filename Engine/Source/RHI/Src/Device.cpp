@@ -19,6 +19,12 @@ namespace RHI {
         return *this;
     }
 
+    DeviceCreateInfo& DeviceCreateInfo::SetPipelineCacheData(std::vector<uint8_t> inData)
+    {
+        pipelineCacheData = std::move(inData);
+        return *this;
+    }
+
     Device::Device(const DeviceCreateInfo&) {}
 
     Device::~Device() = default;
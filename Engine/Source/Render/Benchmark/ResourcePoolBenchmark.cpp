@@ -0,0 +1,50 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <chrono>
+#include <iostream>
+
+#include <Render/ResourcePool.h>
+
+using namespace Render;
+
+int main(int argc, char* argv[])
+{
+    constexpr uint32_t descNum = 512;
+    constexpr uint32_t frameNum = 64;
+    constexpr uint32_t allocationNumPerFrame = 1024;
+
+    auto* instance = RHI::Instance::GetByType(RHI::RHIType::dummy);
+    const Common::UniquePtr<RHI::Device> device = instance->GetGpu(0)->RequestDevice(
+        RHI::DeviceCreateInfo()
+            .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1)));
+
+    auto& bufferPool = BufferPool::Get(*device);
+    bufferPool.Invalidate();
+
+    std::vector<PooledBufferRef> frameBuffers;
+    frameBuffers.reserve(allocationNumPerFrame);
+    const auto begin = std::chrono::high_resolution_clock::now();
+    for (uint32_t frame = 0; frame < frameNum; frame++) {
+        for (uint32_t i = 0; i < allocationNumPerFrame; i++) {
+            const PooledBufferDesc bufferDesc(256 * (1 + (i * 7 + frame) % descNum), RHI::BufferUsageBits::storage, RHI::BufferState::undefined);
+            frameBuffers.emplace_back(bufferPool.Allocate(bufferDesc));
+        }
+        frameBuffers.clear();
+        Core::ThreadContext::IncFrameNumber();
+        bufferPool.Forfeit();
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const auto& stats = bufferPool.GetStats();
+    std::cout << "allocationNum: " << frameNum * allocationNumPerFrame << std::endl;
+    std::cout << "hitNum: " << stats.hitNum << std::endl;
+    std::cout << "missNum: " << stats.missNum << std::endl;
+    std::cout << "evictedNum: " << stats.evictedNum << std::endl;
+    std::cout << "bucketNum: " << bufferPool.BucketNum() << std::endl;
+    std::cout << "timeUs: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << std::endl;
+
+    bufferPool.Invalidate();
+    return 0;
+}
@@ -5,6 +5,10 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
+#include <future>
+#include <mutex>
+#include <atomic>
 
 #include <RHI/RHI.h>
 #include <Render/Shader.h>
@@ -200,10 +204,18 @@ namespace Render {
     private:
         friend class PipelineCache;
 
+        // the layout is resolved on the calling thread, the rhi pipeline is created later by CreateRHI(), which may run
+        // on a render worker thread
         ComputePipelineState(RHI::Device& inDevice, const ComputePipelineStateDesc& inDesc, size_t inHash);
+        // creates the rhi pipeline once, a concurrent caller waits for the thread that is creating it
+        void CreateRHI(RHI::Device& inDevice);
+        bool IsRHICreated() const;
 
         size_t hash;
         PipelineLayout* pipelineLayout;
+        RHI::ComputePipelineCreateInfo createInfo;
+        std::once_flag rhiCreateFlag;
+        std::atomic<bool> rhiCreated;
         Common::UniquePtr<RHI::ComputePipeline> rhiHandle;
     };
 
@@ -219,9 +231,14 @@ namespace Render {
         friend class PipelineCache;
 
         RasterPipelineState(RHI::Device& inDevice, const RasterPipelineStateDesc& inDesc, size_t inHash);
+        void CreateRHI(RHI::Device& inDevice);
+        bool IsRHICreated() const;
 
         size_t hash;
         PipelineLayout* pipelineLayout;
+        RHI::RasterPipelineCreateInfo createInfo;
+        std::once_flag rhiCreateFlag;
+        std::atomic<bool> rhiCreated;
         Common::UniquePtr<RHI::RasterPipeline> rhiHandle;
     };
 
@@ -236,25 +253,65 @@ namespace Render {
         explicit SamplerCache(RHI::Device& inDevice);
 
         RHI::Device& device;
+        std::mutex mutex;
         std::unordered_map<size_t, Common::UniquePtr<Sampler>> samplers;
     };
 
+    struct PipelineCacheStats {
+        uint32_t hitNum;
+        uint32_t syncCompiledNum;
+        uint32_t asyncCompiledNum;
+        uint32_t precachedNum;
+
+        PipelineCacheStats();
+    };
+
+    // compiled pipeline binaries are kept by the rhi device (see RHI::DeviceCreateInfo::pipelineCacheData), this cache
+    // owns the pipeline state objects and records the hashes of the used ones as the precache list, a desc can not be
+    // rebuilt from its hash, so at startup the renderer passes its candidate descs to Precache and only the ones found
+    // in the list of the last run are compiled ahead, GetOrCreate and Precache may be called from several threads
     class PipelineCache {
     public:
         static PipelineCache& Get(RHI::Device& device);
         ~PipelineCache();
 
-        // TODO offline pipeline cache
         void Invalidate();
+        // compiles on the calling thread, or waits for the pending async compile of the same desc
         ComputePipelineState* GetOrCreate(const ComputePipelineStateDesc& desc);
         RasterPipelineState* GetOrCreate(const RasterPipelineStateDesc& desc);
+        // never stalls, returns nullptr and compiles on render worker threads until the pipeline is ready, callers
+        // are expected to skip the draw or use a fallback pipeline meanwhile
+        ComputePipelineState* GetOrCreateAsync(const ComputePipelineStateDesc& desc);
+        RasterPipelineState* GetOrCreateAsync(const RasterPipelineStateDesc& desc);
+        // starts an async compile if the desc was used in the run the precache list was recorded from
+        bool Precache(const ComputePipelineStateDesc& desc);
+        bool Precache(const RasterPipelineStateDesc& desc);
+        void SetPrecacheList(const std::vector<uint64_t>& inHashes);
+        std::vector<uint64_t> GetPrecacheList() const;
+        void WaitPendingCompiles();
+        PipelineCacheStats GetStats() const;
 
     private:
+        template <typename S>
+        struct Entry {
+            Common::UniquePtr<S> state;
+            std::future<void> compileTask;
+        };
+
+        template <typename S> using EntryMap = std::unordered_map<size_t, Entry<S>>;
+
         explicit PipelineCache(RHI::Device& inDevice);
+        template <typename S, typename D> S* GetOrCreateInternal(EntryMap<S>& inEntries, const D& inDesc, bool inAsync);
+        template <typename S, typename D> bool PrecacheInternal(EntryMap<S>& inEntries, const D& inDesc);
+        template <typename S> void CompileAsync(Entry<S>& inEntry);
 
         RHI::Device& device;
-        std::unordered_map<size_t, Common::UniquePtr<ComputePipelineState>> computePipelines;
-        std::unordered_map<size_t, Common::UniquePtr<RasterPipelineState>> rasterPipelines;
+        mutable std::mutex mutex;
+        PipelineCacheStats stats;
+        EntryMap<ComputePipelineState> computePipelines;
+        EntryMap<RasterPipelineState> rasterPipelines;
+        std::unordered_set<uint64_t> recordedHashes;
+        std::unordered_set<uint64_t> usedHashes;
     };
 
     class ResourceViewCache {
@@ -264,6 +321,8 @@ namespace Render {
 
         RHI::BufferView* GetOrCreate(RHI::Buffer* buffer, const RHI::BufferViewCreateInfo& inDesc);
         RHI::TextureView* GetOrCreate(RHI::Texture* texture, const RHI::TextureViewCreateInfo& inDesc);
+        // releases all views, bind groups referencing them must be invalidated first
+        void Invalidate();
         void Invalidate(RHI::Buffer* buffer);
         void Invalidate(RHI::Texture* texture);
         void Forfeit();
@@ -284,10 +343,21 @@ namespace Render {
         };
 
         RHI::Device& device;
+        std::mutex mutex;
         std::unordered_map<RHI::Buffer*, BufferViewCache> bufferViewCaches;
         std::unordered_map<RHI::Texture*, TextureViewCache> textureViewCaches;
     };
 
+    struct BindGroupCacheStats {
+        BindGroupCacheStats();
+
+        uint64_t hitNum;
+        uint64_t missNum;
+        uint64_t invalidatedNum;
+    };
+
+    // bind groups are addressed by layout and entry contents, so a group with the same entries is reused across frames,
+    // groups referencing a view are destroyed when the view is invalidated, safe to use from several threads
     class BindGroupCache {
     public:
         static BindGroupCache& Get(RHI::Device& device);
@@ -295,14 +365,30 @@ namespace Render {
 
         RHI::BindGroup* Allocate(const RHI::BindGroupCreateInfo& inCreateInfo);
         void Invalidate();
+        void Invalidate(RHI::BufferView* inView);
+        void Invalidate(RHI::TextureView* inView);
         void Forfeit();
+        size_t Size() const;
+        BindGroupCacheStats GetStats() const;
 
     private:
-        using AllocateFrameNumber = uint64_t;
+        struct CachedBindGroup {
+            Common::UniquePtr<RHI::BindGroup> bindGroup;
+            uint64_t lastUsedFrame;
+            // layout and sorted entries, compared on lookup so a hash collision never returns another group
+            std::vector<uint64_t> key;
+            std::vector<const void*> views;
+        };
 
         explicit BindGroupCache(RHI::Device& inDevice);
 
+        void InvalidateByView(const void* inView);
+        void Erase(uint64_t inHash);
+
         RHI::Device& device;
-        std::vector<std::pair<Common::UniquePtr<RHI::BindGroup>, AllocateFrameNumber>> bindGroups;
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, CachedBindGroup> bindGroups;
+        std::unordered_map<const void*, std::vector<uint64_t>> viewBindGroups;
+        BindGroupCacheStats stats;
     };
 }
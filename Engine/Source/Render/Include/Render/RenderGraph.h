@@ -5,9 +5,11 @@
 #pragma once
 
 #include <unordered_map>
+#include <deque>
 #include <functional>
 #include <future>
 #include <optional>
+#include <limits>
 
 #include <Common/Memory.h>
 #include <RHI/RHI.h>
@@ -60,6 +62,7 @@ namespace Render {
         explicit RGResource(RGResType inType);
 
         RGResType type;
+        uint32_t index;
         bool forceUsed;
         bool imported;
     };
@@ -256,6 +259,7 @@ namespace Render {
 
         std::string name;
         RGPassType type;
+        uint32_t index;
     };
 
     using RGPassRef = RGPass*;
@@ -326,17 +330,145 @@ namespace Render {
         std::vector<RGBindGroupRef> bindGroups;
     };
 
+    struct RGTransientMemoryStats {
+        RGTransientMemoryStats();
+
+        size_t transientResourceNum;
+        // pooled objects backing the transient resources after aliasing
+        size_t physicalResourceNum;
+        // every transient resource owns its memory
+        size_t bytesWithoutAliasing;
+        // transient resources with the same desc and disjoint lifetimes share one pooled object
+        size_t bytesWithAliasing;
+        // max bytes of transient resources alive at the same step, the lower bound of any aliasing
+        size_t peakLiveBytes;
+    };
+
+    using RGResourceState = std::variant<RHI::BufferState, RHI::TextureState>;
+
+    // compile result of a render graph, resources and passes are referred by their creation order, so it can be reused
+    // by any graph built with the same topology
+    struct RGCompiledGraph {
+        static constexpr uint32_t noAliasSlot = std::numeric_limits<uint32_t>::max();
+
+        struct Transition {
+            uint32_t resource;
+            RGResourceState before;
+            RGResourceState after;
+        };
+
+        RGCompiledGraph();
+
+        std::vector<std::vector<uint32_t>> passReads;
+        std::vector<std::vector<uint32_t>> passWrites;
+        std::vector<bool> culledResources;
+        std::vector<bool> culledPasses;
+        // read counts after cull, a resource is released when its count drops to zero while executing
+        std::vector<uint32_t> resourceReadCounts;
+        // transient resources in the same alias slot have the same desc and disjoint lifetimes, they share one pooled object
+        std::vector<uint32_t> resourceAliasSlots;
+        std::vector<RGResType> aliasSlotTypes;
+        // transitions recorded before each pass, the first transition of an aliased resource starts from the last state
+        // of its predecessor in the slot, which is the aliasing barrier, it is kept even if both states are the same
+        std::vector<std::vector<Transition>> passTransitions;
+        RGTransientMemoryStats transientMemoryStats;
+    };
+
+    struct RGCompileCacheStats {
+        RGCompileCacheStats();
+
+        uint64_t hitNum;
+        uint64_t missNum;
+    };
+
+    class RGCompileCache {
+    public:
+        static RGCompileCache& Get(RHI::Device& device);
+        ~RGCompileCache();
+
+        Common::SharedPtr<RGCompiledGraph> Find(uint64_t inTopologyHash);
+        void Emplace(uint64_t inTopologyHash, Common::SharedPtr<RGCompiledGraph> inCompiledGraph);
+        size_t Size() const;
+        const RGCompileCacheStats& GetStats() const;
+        void Invalidate();
+        void Forfeit();
+
+    private:
+        struct Entry {
+            Common::SharedPtr<RGCompiledGraph> compiledGraph;
+            uint64_t lastUsedFrame;
+        };
+
+        RGCompileCache();
+
+        std::unordered_map<uint64_t, Entry> entries;
+        RGCompileCacheStats stats;
+    };
+
+    struct RGCommandPoolStats {
+        RGCommandPoolStats();
+
+        uint64_t cmdBufferCreatedNum;
+        uint64_t cmdBufferReusedNum;
+        uint64_t semaphoreCreatedNum;
+        uint64_t semaphoreReusedNum;
+    };
+
+    // command buffers and semaphores used by builders are recycled per queue, objects allocated in a frame stay in flight
+    // until GPU has finished the frame, then they are moved back to the free lists of their queue, so a steady frame loop
+    // creates no new objects
+    class RGCommandPool {
+    public:
+        static RGCommandPool& Get(RHI::Device& device);
+        ~RGCommandPool();
+
+        RHI::CommandBuffer* AllocateCommandBuffer(RGQueueType inQueueType);
+        RHI::Semaphore* AllocateSemaphore(RGQueueType inQueueType);
+        size_t Size() const;
+        const RGCommandPoolStats& GetStats() const;
+        // callers must make sure the device is idle
+        void Invalidate();
+
+    private:
+        struct QueueObjects {
+            std::vector<Common::UniquePtr<RHI::CommandBuffer>> cmdBuffers;
+            std::vector<Common::UniquePtr<RHI::Semaphore>> semaphores;
+        };
+
+        struct FrameObjects {
+            uint64_t frame;
+            std::unordered_map<RGQueueType, QueueObjects> queueObjects;
+        };
+
+        explicit RGCommandPool(RHI::Device& inDevice);
+
+        QueueObjects& GetInFlightQueueObjects(RGQueueType inQueueType);
+
+        RHI::Device& device;
+        std::deque<FrameObjects> inFlightFrames;
+        std::unordered_map<RGQueueType, QueueObjects> freeQueueObjects;
+        size_t objectNum;
+        RGCommandPoolStats stats;
+    };
+
     struct RGExecuteInfo {
         std::vector<RHI::Semaphore*> semaphoresToWait;
         std::vector<RHI::Semaphore*> semaphoresToSignal;
         RHI::Fence* inFenceToSignal = nullptr;
+        // record passes of each queue into several command buffers on render worker threads, pass functions then run
+        // concurrently and must only read the builder and the thread safe render caches, off by default because each
+        // group costs a command buffer and a worker round trip, which only pays off for graphs with many heavy passes,
+        // callers opt in per graph once their pass functions are known to be thread safe
+        bool parallelRecording = false;
     };
 
     class RGBuilder {
     public:
         NonCopyable(RGBuilder);
         NonMovable(RGBuilder);
-        explicit RGBuilder(RHI::Device& inDevice);
+        // with inReuseCompiled, the topology of the graph is hashed on execute, and the compiled graph of a previous builder
+        // with the same topology is reused from RGCompileCache, only devirtualization and recording run per frame
+        explicit RGBuilder(RHI::Device& inDevice, bool inReuseCompiled = false);
         ~RGBuilder();
 
         // setup
@@ -360,41 +492,57 @@ namespace Render {
         RHI::BufferView* GetRHI(RGBufferViewRef inBufferView) const;
         RHI::TextureView* GetRHI(RGTextureViewRef inTextureView) const;
         RHI::BindGroup* GetRHI(RGBindGroupRef inBindGroup) const;
+        const RGTransientMemoryStats& GetTransientMemoryStats() const;
+        bool CompiledGraphReused() const;
+        // pass index is the order the pass was added in
+        const std::vector<RGCompiledGraph::Transition>& GetPassTransitions(uint32_t inPassIndex) const;
 
     private:
         struct AsyncTimelineExecuteContext {
-            std::unordered_map<RGQueueType, Common::UniquePtr<RHI::CommandBuffer>> queueCmdBufferMap;
-            std::unordered_map<RGQueueType, Common::UniquePtr<RHI::Semaphore>> queueSemaphoreToSignalMap;
+            std::unordered_map<RGQueueType, std::vector<RHI::CommandBuffer*>> queueCmdBufferMap;
+            std::unordered_map<RGQueueType, RHI::Semaphore*> queueSemaphoreToSignalMap;
 
             AsyncTimelineExecuteContext();
             AsyncTimelineExecuteContext(AsyncTimelineExecuteContext&& inOther) noexcept;
         };
 
+        // steps are pass positions in the timeline, passes of an async timeline with several queues run concurrently, so
+        // all of them share the whole step range of the async timeline
+        struct ResourceLifetime {
+            uint32_t firstStep;
+            uint32_t lastStep;
+        };
+
         void Compile();
         void ExecuteInternal(const RGExecuteInfo& inExecuteInfo);
 
-        void CompilePassReadWrites();
+        uint64_t ComputeTopologyHash() const;
+        Common::SharedPtr<RGCompiledGraph> CompileInternal() const;
+        void CompilePassReadWrites(RGCompiledGraph& outGraph) const;
         void PerformSyncCheck() const;
-        void PerformCull();
+        void PerformCull(RGCompiledGraph& outGraph) const;
+        std::vector<std::optional<ResourceLifetime>> ComputeResourceLifetimes(const RGCompiledGraph& inGraph) const;
+        void PlanTransientAliasing(RGCompiledGraph& outGraph, const std::vector<std::optional<ResourceLifetime>>& inLifetimes, std::vector<std::optional<uint32_t>>& outAliasPredecessors) const;
         // TODO resource states check inside pass (e.g. read/write a resource within a pass)
-        void ComputeResourcesInitialState();
-        void ExecuteCopyPass(RHI::CommandRecorder& inRecoder, RGCopyPass* inCopyPass);
-        void ExecuteComputePass(RHI::CommandRecorder& inRecoder, RGComputePass* inComputePass);
-        void ExecuteRasterPass(RHI::CommandRecorder& inRecoder, RGRasterPass* inRasterPass);
+        void PlanTransitions(RGCompiledGraph& outGraph, const std::vector<std::optional<uint32_t>>& inAliasPredecessors) const;
+        bool IsCulled(RGResourceRef inResource) const;
+        void RecordQueuePasses(std::vector<RHI::CommandBuffer*>& outCmdBuffers, RGQueueType inQueueType, const std::vector<RGPassRef>& inPasses, bool inParallel);
+        void PreparePass(RGPassRef inPass);
+        void RecordPass(RHI::CommandRecorder& inRecoder, RGPassRef inPass) const;
+        void FinalizePass(RGPassRef inPass);
+        void RecordCopyPass(RHI::CommandRecorder& inRecoder, RGCopyPass* inCopyPass) const;
+        void RecordComputePass(RHI::CommandRecorder& inRecoder, RGComputePass* inComputePass) const;
+        void RecordRasterPass(RHI::CommandRecorder& inRecoder, RGRasterPass* inRasterPass) const;
         void PerformBufferUploads();
         void WaitBufferUploadsFinish() const;
         void DevirtualizeViewsCreatedOnImportedResources();
         void DevirtualizeResource(RGResourceRef inResource);
-        void DevirtualizeResources(const std::unordered_set<RGResourceRef>& inResources);
+        void DevirtualizeResources(const std::vector<uint32_t>& inResources);
         void DevirtualizeBindGroupsAndViews(const std::vector<RGBindGroupRef>& inBindGroups);
         void DevirtualizeAttachmentViews(const RGRasterPassDesc& inDesc);
-        void FinalizePassResources(const std::unordered_set<RGResourceRef>& inResources);
+        void FinalizePassResources(const std::vector<uint32_t>& inResources);
         void FinalizePassBindGroups(const std::vector<RGBindGroupRef>& inBindGroups);
-        void TransitionResourcesForCopyPassDesc(RHI::CommandCommandRecorder& inRecoder, const RGCopyPassDesc& inDesc);
-        void TransitionResourcesForRasterPassDesc(RHI::CommandCommandRecorder& inRecoder, const RGRasterPassDesc& inDesc);
-        void TransitionResourcesForBindGroups(RHI::CommandCommandRecorder& inRecoder, const std::vector<RGBindGroupRef>& inBindGroups);
-        void TransitionBuffer(RHI::CommandCommandRecorder& inRecoder, RGBufferRef inBuffer, RHI::BufferState inState);
-        void TransitionTexture(RHI::CommandCommandRecorder& inRecoder, RGTextureRef inTexture, RHI::TextureState inState);
+        void TransitionResourcesForPass(RHI::CommandCommandRecorder& inRecoder, RGPassRef inPass) const;
 
         bool executed;
         RHI::Device& device;
@@ -407,13 +555,12 @@ namespace Render {
         std::unordered_map<RGBufferRef, RGBufferUploadInfo> bufferUploads;
 
         // execute context
-        std::unordered_map<RGResourceRef, uint32_t> resourceReadCounts;
-        std::unordered_map<RGPassRef, std::unordered_set<RGResourceRef>> passReadsMap;
-        std::unordered_map<RGPassRef, std::unordered_set<RGResourceRef>> passWritesMap;
-        std::unordered_set<RGResourceRef> culledResources;
-        std::unordered_set<RGPassRef> culledPasses;
-        std::unordered_map<RGResourceRef, std::variant<RHI::BufferState, RHI::TextureState>> resourceStates;
+        bool reuseCompiled;
+        bool compiledGraphReused;
+        Common::SharedPtr<RGCompiledGraph> compiledGraph;
+        std::vector<uint32_t> resourceReadCounts;
         std::vector<AsyncTimelineExecuteContext> asyncTimelineExecuteContexts;
+        std::vector<std::variant<PooledBufferRef, PooledTextureRef>> aliasSlots;
         std::unordered_map<RGResourceRef, std::variant<PooledBufferRef, PooledTextureRef>> devirtualizedResources;
         std::unordered_map<RGResourceViewRef, std::variant<RHI::BufferView*, RHI::TextureView*>> devirtualizedResourceViews;
         std::unordered_map<RGBindGroupRef, RHI::BindGroup*> devirtualizedBindGroups;
@@ -29,6 +29,8 @@ namespace Render {
         void Initialize(const RenderModuleInitParams& inParams);
         void DeInitialize();
         RHI::Device* GetDevice() const;
+        // releases the entries of the device caches not used for a while, called by render thread once per frame
+        void ForfeitCaches() const;
         Render::RenderThread& GetRenderThread() const;
         Scene* NewScene() const;
         ViewState* NewViewState() const;
@@ -36,6 +38,11 @@ namespace Render {
         StandardRenderer CreateStandardRenderer(const StandardRenderer::Params& inParams) const;
 
     private:
+        Common::Path GetPipelineCacheDir() const;
+        std::vector<uint8_t> LoadPipelineCacheData() const;
+        void LoadPrecacheList() const;
+        void SavePipelineCache() const;
+
         bool initialized;
         RHI::Instance* rhiInstance;
         Common::UniquePtr<RHI::Device> rhiDevice;
@@ -19,6 +19,7 @@ namespace Render {
         void Stop();
         void Flush() const;
         template <typename F> auto EmplaceTask(F&& inTask);
+        template <typename F> void EmplaceDetachedTask(F&& inTask);
 
     private:
         RenderThread();
@@ -35,6 +36,7 @@ namespace Render {
         void Start();
         void Stop();
         template <typename F> auto EmplaceTask(F&& inTask);
+        template <typename F> void EmplaceDetachedTask(F&& inTask);
         template <typename F> void ExecuteTasks(size_t inTaskNum, F&& inTask);
 
     private:
@@ -52,6 +54,13 @@ namespace Render {
         return thread->EmplaceTask(std::forward<F>(inTask));
     }
 
+    template <typename F>
+    void RenderThread::EmplaceDetachedTask(F&& inTask)
+    {
+        Assert(thread != nullptr);
+        thread->EmplaceDetachedTask(std::forward<F>(inTask));
+    }
+
     template <typename F>
     auto RenderWorkerThreads::EmplaceTask(F&& inTask)
     {
@@ -64,6 +73,16 @@ namespace Render {
         });
     }
 
+    template <typename F>
+    void RenderWorkerThreads::EmplaceDetachedTask(F&& inTask)
+    {
+        Assert(threads != nullptr);
+        threads->EmplaceDetachedTask([inTask = std::forward<F>(inTask)]() mutable -> void {
+            Core::ScopedThreadTag tag(Core::ThreadTag::renderWorker);
+            inTask();
+        });
+    }
+
     template <typename F>
     void RenderWorkerThreads::ExecuteTasks(size_t inTaskNum, F&& inTask)
     {
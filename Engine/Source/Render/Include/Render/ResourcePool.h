@@ -5,6 +5,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <limits>
 
 #include <Common/Memory.h>
 #include <Common/Container.h>
@@ -13,6 +14,7 @@
 
 namespace Render::Internal {
     constexpr uint64_t pooledResourceReleaseFrameLatency = 2;
+    constexpr size_t pooledResourceForfeitBucketsPerFrame = 64;
 }
 
 namespace Render {
@@ -31,6 +33,7 @@ namespace Render {
         const DescType& GetDesc() const;
         uint64_t LastUsedFrame() const;
         void MarkUsedThisFrame();
+        void MarkUsedFrame(uint64_t inFrame);
 
     private:
         Common::UniquePtr<RHIRes> rhiHandle;
@@ -48,6 +51,17 @@ namespace Render {
     template <typename PooledRes>
     struct PooledResTraits {};
 
+    struct ResourcePoolStats {
+        ResourcePoolStats();
+
+        uint64_t hitNum;
+        uint64_t missNum;
+        uint64_t evictedNum;
+    };
+
+    // resources are bucketed by desc, each bucket has a free list, so allocating is O(1) for a bucket with free resources,
+    // users release resources by dropping the refs without notifying the pool, released resources are moved back to the
+    // free list by the forfeit pass, or by allocating in a bucket whose free list is empty
     template <typename PooledRes>
     class ResourcePool {
     public:
@@ -58,14 +72,35 @@ namespace Render {
 
         ResRefType Allocate(const DescType& desc);
         size_t Size() const;
-        void Forfeit();
+        size_t BucketNum() const;
+        const ResourcePoolStats& GetStats() const;
+        // incremental eviction pass called once per frame, visits at most inMaxBucketNum buckets round-robin, evicts free
+        // resources not used for pooledResourceReleaseFrameLatency frames, buckets left empty are removed
+        void Forfeit(size_t inMaxBucketNum = Internal::pooledResourceForfeitBucketsPerFrame);
         void Invalidate();
 
     private:
+        struct DescHasher {
+            size_t operator()(const DescType& desc) const;
+        };
+
+        struct Bucket {
+            DescType desc;
+            std::vector<ResRefType> usedResources;
+            std::vector<ResRefType> freeResources;
+        };
+
         explicit ResourcePool(RHI::Device& inDevice);
 
+        // moves the used resources released by users to the free list
+        static void Reclaim(Bucket& bucket, uint64_t inCurrentFrame);
+
         RHI::Device& device;
-        std::vector<ResRefType> pooledResources;
+        std::unordered_map<DescType, size_t, DescHasher> bucketIndices;
+        std::vector<Bucket> buckets;
+        size_t resourceNum;
+        size_t forfeitCursor;
+        ResourcePoolStats stats;
     };
 
     using BufferPool = ResourcePool<PooledBuffer>;
@@ -118,6 +153,12 @@ namespace Render {
         lastUsedFrame = Core::ThreadContext::FrameNumber();
     }
 
+    template <typename RHIRes>
+    void PooledResource<RHIRes>::MarkUsedFrame(uint64_t inFrame)
+    {
+        lastUsedFrame = inFrame;
+    }
+
     template <>
     struct PooledResTraits<PooledBuffer> {
         using ResType = PooledBuffer;
@@ -142,6 +183,19 @@ namespace Render {
         }
     };
 
+    inline ResourcePoolStats::ResourcePoolStats()
+        : hitNum(0)
+        , missNum(0)
+        , evictedNum(0)
+    {
+    }
+
+    template <typename PooledRes>
+    size_t ResourcePool<PooledRes>::DescHasher::operator()(const DescType& desc) const
+    {
+        return desc.Hash();
+    }
+
     template <typename PooledResource>
     ResourcePool<PooledResource>& ResourcePool<PooledResource>::Get(RHI::Device& device)
     {
@@ -155,58 +209,125 @@ namespace Render {
     template <typename PooledResource>
     ResourcePool<PooledResource>::ResourcePool(RHI::Device& inDevice)
         : device(inDevice)
+        , resourceNum(0)
+        , forfeitCursor(0)
     {
     }
 
+    template <typename PooledRes>
+    void ResourcePool<PooledRes>::Reclaim(Bucket& bucket, uint64_t inCurrentFrame)
+    {
+        auto& usedResources = bucket.usedResources;
+        for (auto i = 0; i < usedResources.size();) {
+            auto& usedResource = usedResources[i];
+            if (usedResource.RefCount() > 1) {
+                usedResource->MarkUsedThisFrame();
+                i++;
+                continue;
+            }
+            // the resource was seen in use by the last visit and may be used by GPU until the last frame
+            if (inCurrentFrame > 0 && usedResource->LastUsedFrame() < inCurrentFrame - 1) {
+                usedResource->MarkUsedFrame(inCurrentFrame - 1);
+            }
+            bucket.freeResources.emplace_back(std::move(usedResource));
+            Common::VectorUtils::SwapWithLastAndDelete(usedResources, i);
+        }
+    }
+
     template <typename PooledResource>
     typename ResourcePool<PooledResource>::ResRefType ResourcePool<PooledResource>::Allocate(const DescType& desc)
     {
-        for (auto& pooledResource : pooledResources) {
-            if (pooledResource.RefCount() == 1 && desc == pooledResource->GetDesc()) {
-                pooledResource->MarkUsedThisFrame();
-                return pooledResource;
-            }
+        auto [iter, emplaced] = bucketIndices.try_emplace(desc, buckets.size());
+        if (emplaced) {
+            buckets.emplace_back(Bucket { desc });
         }
+        auto& bucket = buckets[iter->second];
+
+        if (bucket.freeResources.empty()) {
+            Reclaim(bucket, Core::ThreadContext::FrameNumber());
+        }
+        if (!bucket.freeResources.empty()) {
+            // the most recently used one is reused, older ones are left to be evicted
+            auto result = std::move(bucket.freeResources.back());
+            bucket.freeResources.pop_back();
+            result->MarkUsedThisFrame();
+            bucket.usedResources.emplace_back(result);
+            stats.hitNum++;
+            return result;
+        }
+
         auto result = PooledResTraits<PooledResource>::CreateResource(device, desc);
-        pooledResources.emplace_back(result);
+        bucket.usedResources.emplace_back(result);
+        resourceNum++;
+        stats.missNum++;
         return result;
     }
 
     template <typename PooledRes>
     size_t ResourcePool<PooledRes>::Size() const
     {
-        return pooledResources.size();
+        return resourceNum;
     }
 
     template <typename PooledRes>
-    void ResourcePool<PooledRes>::Forfeit()
+    size_t ResourcePool<PooledRes>::BucketNum() const
     {
-        const auto currentFrame = Core::ThreadContext::FrameNumber();
+        return buckets.size();
+    }
 
-        for (auto i = 0; i < pooledResources.size();) {
-            bool needRelease = false;
-            auto& pooledResource = pooledResources[i];
+    template <typename PooledRes>
+    const ResourcePoolStats& ResourcePool<PooledRes>::GetStats() const
+    {
+        return stats;
+    }
 
-            if (pooledResource.RefCount() <= 1) {
-                needRelease = currentFrame - pooledResource->LastUsedFrame() > Internal::pooledResourceReleaseFrameLatency;
-            } else {
-                pooledResource->MarkUsedThisFrame();
+    template <typename PooledRes>
+    void ResourcePool<PooledRes>::Forfeit(size_t inMaxBucketNum)
+    {
+        const auto currentFrame = Core::ThreadContext::FrameNumber();
+        const auto visitNum = std::min(inMaxBucketNum, buckets.size());
+
+        for (auto v = 0; v < visitNum && !buckets.empty(); v++) {
+            forfeitCursor = forfeitCursor % buckets.size();
+            auto& bucket = buckets[forfeitCursor];
+            Reclaim(bucket, currentFrame);
+
+            auto& freeResources = bucket.freeResources;
+            for (auto i = 0; i < freeResources.size();) {
+                if (currentFrame - freeResources[i]->LastUsedFrame() > Internal::pooledResourceReleaseFrameLatency) {
+                    Common::VectorUtils::SwapWithLastAndDelete(freeResources, i);
+                    resourceNum--;
+                    stats.evictedNum++;
+                } else {
+                    i++;
+                }
             }
 
-            if (needRelease) { // NOLINT
-                pooledResources.erase(pooledResources.begin() + i);
-            } else {
-                i++;
+            if (!bucket.usedResources.empty() || !freeResources.empty()) {
+                forfeitCursor++;
+                continue;
             }
+            // swap-remove the empty bucket, the cursor stays to visit the bucket moved in next
+            bucketIndices.erase(bucket.desc);
+            if (forfeitCursor != buckets.size() - 1) {
+                bucket = std::move(buckets.back());
+                bucketIndices.at(bucket.desc) = forfeitCursor;
+            }
+            buckets.pop_back();
         }
     }
 
     template <typename PooledRes>
     void ResourcePool<PooledRes>::Invalidate()
     {
-        for (const auto& pooledResource : pooledResources) {
-            Assert(pooledResource.RefCount() == 1);
+        for (const auto& bucket : buckets) {
+            for (const auto& usedResource : bucket.usedResources) {
+                Assert(usedResource.RefCount() == 1);
+            }
         }
-        pooledResources.clear();
+        bucketIndices.clear();
+        buckets.clear();
+        resourceNum = 0;
+        forfeitCursor = 0;
     }
 } // namespace Render
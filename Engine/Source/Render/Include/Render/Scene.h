@@ -4,16 +4,21 @@
 
 #pragma once
 
+#include <vector>
+
 #include <Common/Debug.h>
 #include <Core/Thread.h>
+#include <Render/SceneProxy/Container.h>
 #include <Render/SceneProxy/Light.h>
 
 namespace Render {
+    template <typename SP> struct SceneProxyDeltas;
+
     // Render::Scene is a container of render-thread world data copy.
     // Notice all operations to scene need be down in render-thread.
     class Scene final {
     public:
-        using EntityId = uint32_t;
+        using EntityId = SceneEntityId;
 
         Scene();
         ~Scene();
@@ -22,18 +27,36 @@ namespace Render {
         NonMovable(Scene)
 
         template <typename SP> void Add(EntityId inEntity, SP&& inSceneProxy);
-        template <typename SP> SP& Get(EntityId inEntity);
-        template <typename SP> const SP& Get(EntityId inEntity) const;
+        template <typename SP> void Update(EntityId inEntity, SP&& inSceneProxy);
+        template <typename SP> SP Get(EntityId inEntity) const;
         template <typename SP> void Remove(EntityId inEntity);
+        template <typename SP> void Apply(SceneProxyDeltas<SP>&& inDeltas);
+        // number of delta batches applied, game-thread flushes at most one batch per scene proxy type each frame
+        uint64_t GetAppliedDeltasNum() const;
+        // dense proxy arrays, for render-thread loops over all proxies of one type
+        template <typename SP> const SceneProxyContainer<SP>& GetSceneProxies() const;
 
     private:
-        template <typename SP> using SceneProxyContainer = std::unordered_map<EntityId, LightSceneProxy>;
-
         template <typename SP> SceneProxyContainer<SP>& GetSceneProxyContainer();
         template <typename SP> const SceneProxyContainer<SP>& GetSceneProxyContainer() const;
 
+        uint64_t appliedDeltasNum;
         SceneProxyContainer<LightSceneProxy> lightSceneProxies;
     };
+
+    // changes of one scene proxy type collected by game-thread in one frame, they are moved to render-thread
+    // in one task and applied by Scene::Apply() in bulk, to avoid a render-thread task per entity
+    template <typename SP>
+    struct SceneProxyDeltas {
+        bool Empty() const;
+        void Clear();
+
+        // applied in declaration order
+        std::vector<std::pair<Scene::EntityId, SP>> adds;
+        std::vector<std::pair<Scene::EntityId, SP>> updates;
+        std::vector<Scene::EntityId> removes;
+        std::vector<std::pair<Scene::EntityId, Common::FMat4x4>> transformUpdates;
+    };
 }
 
 namespace Render {
@@ -41,54 +64,98 @@ namespace Render {
     void Scene::Add(EntityId inEntity, SP&& inSceneProxy)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        GetSceneProxyContainer<SP>().emplace(inEntity, std::move(inSceneProxy)); // NOLINT
+        GetSceneProxyContainer<SP>().Add(inEntity, std::move(inSceneProxy)); // NOLINT
     }
 
     template <typename SP>
-    SP& Scene::Get(EntityId inEntity)
+    void Scene::Update(EntityId inEntity, SP&& inSceneProxy)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        return GetSceneProxyContainer<SP>().at(inEntity);
+        GetSceneProxyContainer<SP>().Update(inEntity, std::move(inSceneProxy)); // NOLINT
     }
 
     template <typename SP>
-    const SP& Scene::Get(EntityId inEntity) const
+    SP Scene::Get(EntityId inEntity) const
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        return GetSceneProxyContainer<SP>().at(inEntity);
+        return GetSceneProxyContainer<SP>().Get(inEntity);
     }
 
     template <typename SP>
     void Scene::Remove(EntityId inEntity)
     {
         Assert(Core::ThreadContext::IsRenderThread());
-        GetSceneProxyContainer<SP>().erase(inEntity);
+        GetSceneProxyContainer<SP>().Remove(inEntity);
+    }
+
+    template <typename SP>
+    void Scene::Apply(SceneProxyDeltas<SP>&& inDeltas)
+    {
+        Assert(Core::ThreadContext::IsRenderThread());
+        appliedDeltasNum++;
+        auto& container = GetSceneProxyContainer<SP>();
+        for (auto& [entity, sceneProxy] : inDeltas.adds) {
+            container.Add(entity, std::move(sceneProxy));
+        }
+        for (auto& [entity, sceneProxy] : inDeltas.updates) {
+            container.Update(entity, std::move(sceneProxy));
+        }
+        for (const auto entity : inDeltas.removes) {
+            container.Remove(entity);
+        }
+        for (const auto& [entity, localToWorld] : inDeltas.transformUpdates) {
+            container.UpdateLocalToWorld(entity, localToWorld);
+        }
+    }
+
+    template <typename SP>
+    const SceneProxyContainer<SP>& Scene::GetSceneProxies() const
+    {
+        Assert(Core::ThreadContext::IsRenderThread());
+        return GetSceneProxyContainer<SP>();
     }
 
     template <typename SP>
-    Scene::SceneProxyContainer<SP>& Scene::GetSceneProxyContainer()
+    SceneProxyContainer<SP>& Scene::GetSceneProxyContainer()
     {
         Unimplement();
         return *static_cast<SceneProxyContainer<SP>*>(nullptr); // NOLINT
     }
 
     template <typename SP>
-    const Scene::SceneProxyContainer<SP>& Scene::GetSceneProxyContainer() const
+    const SceneProxyContainer<SP>& Scene::GetSceneProxyContainer() const
     {
         Unimplement();
         return *static_cast<const SceneProxyContainer<SP>*>(nullptr); // NOLINT
     }
 }
 
+namespace Render {
+    template <typename SP>
+    bool SceneProxyDeltas<SP>::Empty() const
+    {
+        return adds.empty() && updates.empty() && removes.empty() && transformUpdates.empty();
+    }
+
+    template <typename SP>
+    void SceneProxyDeltas<SP>::Clear()
+    {
+        adds.clear();
+        updates.clear();
+        removes.clear();
+        transformUpdates.clear();
+    }
+}
+
 namespace Render {
     template <>
-    inline Scene::SceneProxyContainer<LightSceneProxy>& Scene::GetSceneProxyContainer<LightSceneProxy>()
+    inline SceneProxyContainer<LightSceneProxy>& Scene::GetSceneProxyContainer<LightSceneProxy>()
     {
         return lightSceneProxies;
     }
 
     template <>
-    inline const Scene::SceneProxyContainer<LightSceneProxy>& Scene::GetSceneProxyContainer<LightSceneProxy>() const
+    inline const SceneProxyContainer<LightSceneProxy>& Scene::GetSceneProxyContainer<LightSceneProxy>() const
     {
         return lightSceneProxies;
     }
@@ -0,0 +1,164 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include <Common/Debug.h>
+#include <Common/Container.h>
+#include <Common/Math/Matrix.h>
+
+namespace Render {
+    using SceneEntityId = uint64_t;
+
+    // sparse entity index of a dense scene proxy store, dense arrays are kept packed by swap-remove,
+    // so the slot of an entity may change after another entity is erased
+    class SceneProxySlots {
+    public:
+        using Slot = size_t;
+
+        SceneProxySlots();
+
+        size_t Count() const;
+        bool Contains(SceneEntityId inEntity) const;
+        Slot Get(SceneEntityId inEntity) const;
+        Slot Emplace(SceneEntityId inEntity);
+        // returns the erased slot, every dense array of the store must swap-remove the same slot
+        Slot Erase(SceneEntityId inEntity);
+        const std::vector<SceneEntityId>& Entities() const;
+
+    private:
+        std::vector<SceneEntityId> entities;
+        std::unordered_map<SceneEntityId, Slot> slotMap;
+    };
+
+    // default scene proxy store, an array of whole proxies, scene proxy types iterated in hot render-thread
+    // loops can specialize it with one array per member
+    template <typename SP>
+    class SceneProxyContainer {
+    public:
+        SceneProxyContainer();
+
+        size_t Count() const;
+        bool Contains(SceneEntityId inEntity) const;
+        void Add(SceneEntityId inEntity, SP&& inSceneProxy);
+        void Update(SceneEntityId inEntity, SP&& inSceneProxy);
+        void UpdateLocalToWorld(SceneEntityId inEntity, const Common::FMat4x4& inLocalToWorld);
+        void Remove(SceneEntityId inEntity);
+        SP Get(SceneEntityId inEntity) const;
+        const std::vector<SceneEntityId>& Entities() const;
+        const std::vector<SP>& SceneProxies() const;
+
+    private:
+        SceneProxySlots slots;
+        std::vector<SP> sceneProxies;
+    };
+}
+
+namespace Render {
+    inline SceneProxySlots::SceneProxySlots() = default;
+
+    inline size_t SceneProxySlots::Count() const
+    {
+        return entities.size();
+    }
+
+    inline bool SceneProxySlots::Contains(SceneEntityId inEntity) const
+    {
+        return slotMap.contains(inEntity);
+    }
+
+    inline SceneProxySlots::Slot SceneProxySlots::Get(SceneEntityId inEntity) const
+    {
+        return slotMap.at(inEntity);
+    }
+
+    inline SceneProxySlots::Slot SceneProxySlots::Emplace(SceneEntityId inEntity)
+    {
+        Assert(!Contains(inEntity));
+        const Slot slot = entities.size();
+        entities.emplace_back(inEntity);
+        slotMap.emplace(inEntity, slot);
+        return slot;
+    }
+
+    inline SceneProxySlots::Slot SceneProxySlots::Erase(SceneEntityId inEntity)
+    {
+        const auto iter = slotMap.find(inEntity);
+        Assert(iter != slotMap.end());
+        const Slot slot = iter->second;
+        slotMap.erase(iter);
+
+        Common::VectorUtils::SwapWithLastAndDelete(entities, slot);
+        if (slot < entities.size()) {
+            slotMap.at(entities[slot]) = slot;
+        }
+        return slot;
+    }
+
+    inline const std::vector<SceneEntityId>& SceneProxySlots::Entities() const
+    {
+        return entities;
+    }
+
+    template <typename SP>
+    SceneProxyContainer<SP>::SceneProxyContainer() = default;
+
+    template <typename SP>
+    size_t SceneProxyContainer<SP>::Count() const
+    {
+        return slots.Count();
+    }
+
+    template <typename SP>
+    bool SceneProxyContainer<SP>::Contains(SceneEntityId inEntity) const
+    {
+        return slots.Contains(inEntity);
+    }
+
+    template <typename SP>
+    void SceneProxyContainer<SP>::Add(SceneEntityId inEntity, SP&& inSceneProxy)
+    {
+        slots.Emplace(inEntity);
+        sceneProxies.emplace_back(std::move(inSceneProxy));
+    }
+
+    template <typename SP>
+    void SceneProxyContainer<SP>::Update(SceneEntityId inEntity, SP&& inSceneProxy)
+    {
+        sceneProxies[slots.Get(inEntity)] = std::move(inSceneProxy);
+    }
+
+    template <typename SP>
+    void SceneProxyContainer<SP>::UpdateLocalToWorld(SceneEntityId inEntity, const Common::FMat4x4& inLocalToWorld)
+    {
+        sceneProxies[slots.Get(inEntity)].localToWorld = inLocalToWorld;
+    }
+
+    template <typename SP>
+    void SceneProxyContainer<SP>::Remove(SceneEntityId inEntity)
+    {
+        Common::VectorUtils::SwapWithLastAndDelete(sceneProxies, slots.Erase(inEntity));
+    }
+
+    template <typename SP>
+    SP SceneProxyContainer<SP>::Get(SceneEntityId inEntity) const
+    {
+        return sceneProxies[slots.Get(inEntity)];
+    }
+
+    template <typename SP>
+    const std::vector<SceneEntityId>& SceneProxyContainer<SP>::Entities() const
+    {
+        return slots.Entities();
+    }
+
+    template <typename SP>
+    const std::vector<SP>& SceneProxyContainer<SP>::SceneProxies() const
+    {
+        return sceneProxies;
+    }
+}
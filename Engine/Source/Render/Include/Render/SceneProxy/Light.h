@@ -6,6 +6,7 @@
 
 #include <Common/Math/Transform.h>
 #include <Common/Math/Color.h>
+#include <Render/SceneProxy/Container.h>
 
 namespace Render {
     enum class LightType : uint8_t {
@@ -25,6 +26,35 @@ namespace Render {
         // point light only
         float radius;
     };
+
+    // lights are culled and shaded all together every frame, so each member is stored in its own dense array
+    template <>
+    class SceneProxyContainer<LightSceneProxy> {
+    public:
+        SceneProxyContainer();
+
+        size_t Count() const;
+        bool Contains(SceneEntityId inEntity) const;
+        void Add(SceneEntityId inEntity, LightSceneProxy&& inSceneProxy);
+        void Update(SceneEntityId inEntity, LightSceneProxy&& inSceneProxy);
+        void UpdateLocalToWorld(SceneEntityId inEntity, const Common::FMat4x4& inLocalToWorld);
+        void Remove(SceneEntityId inEntity);
+        LightSceneProxy Get(SceneEntityId inEntity) const;
+        const std::vector<SceneEntityId>& Entities() const;
+        const std::vector<LightType>& Types() const;
+        const std::vector<Common::FMat4x4>& LocalToWorlds() const;
+        const std::vector<Common::Color>& Colors() const;
+        const std::vector<float>& Intensities() const;
+        const std::vector<float>& Radii() const;
+
+    private:
+        SceneProxySlots slots;
+        std::vector<LightType> types;
+        std::vector<Common::FMat4x4> localToWorlds;
+        std::vector<Common::Color> colors;
+        std::vector<float> intensities;
+        std::vector<float> radii;
+    };
 }
 
 namespace Render {
@@ -37,3 +67,94 @@ namespace Render {
     {
     }
 }
+
+namespace Render {
+    inline SceneProxyContainer<LightSceneProxy>::SceneProxyContainer() = default;
+
+    inline size_t SceneProxyContainer<LightSceneProxy>::Count() const
+    {
+        return slots.Count();
+    }
+
+    inline bool SceneProxyContainer<LightSceneProxy>::Contains(SceneEntityId inEntity) const
+    {
+        return slots.Contains(inEntity);
+    }
+
+    inline void SceneProxyContainer<LightSceneProxy>::Add(SceneEntityId inEntity, LightSceneProxy&& inSceneProxy)
+    {
+        slots.Emplace(inEntity);
+        types.emplace_back(inSceneProxy.type);
+        localToWorlds.emplace_back(inSceneProxy.localToWorld);
+        colors.emplace_back(inSceneProxy.color);
+        intensities.emplace_back(inSceneProxy.intensity);
+        radii.emplace_back(inSceneProxy.radius);
+    }
+
+    inline void SceneProxyContainer<LightSceneProxy>::Update(SceneEntityId inEntity, LightSceneProxy&& inSceneProxy)
+    {
+        const auto slot = slots.Get(inEntity);
+        types[slot] = inSceneProxy.type;
+        localToWorlds[slot] = inSceneProxy.localToWorld;
+        colors[slot] = inSceneProxy.color;
+        intensities[slot] = inSceneProxy.intensity;
+        radii[slot] = inSceneProxy.radius;
+    }
+
+    inline void SceneProxyContainer<LightSceneProxy>::UpdateLocalToWorld(SceneEntityId inEntity, const Common::FMat4x4& inLocalToWorld)
+    {
+        localToWorlds[slots.Get(inEntity)] = inLocalToWorld;
+    }
+
+    inline void SceneProxyContainer<LightSceneProxy>::Remove(SceneEntityId inEntity)
+    {
+        const auto slot = slots.Erase(inEntity);
+        Common::VectorUtils::SwapWithLastAndDelete(types, slot);
+        Common::VectorUtils::SwapWithLastAndDelete(localToWorlds, slot);
+        Common::VectorUtils::SwapWithLastAndDelete(colors, slot);
+        Common::VectorUtils::SwapWithLastAndDelete(intensities, slot);
+        Common::VectorUtils::SwapWithLastAndDelete(radii, slot);
+    }
+
+    inline LightSceneProxy SceneProxyContainer<LightSceneProxy>::Get(SceneEntityId inEntity) const
+    {
+        const auto slot = slots.Get(inEntity);
+        LightSceneProxy result;
+        result.type = types[slot];
+        result.localToWorld = localToWorlds[slot];
+        result.color = colors[slot];
+        result.intensity = intensities[slot];
+        result.radius = radii[slot];
+        return result;
+    }
+
+    inline const std::vector<SceneEntityId>& SceneProxyContainer<LightSceneProxy>::Entities() const
+    {
+        return slots.Entities();
+    }
+
+    inline const std::vector<LightType>& SceneProxyContainer<LightSceneProxy>::Types() const
+    {
+        return types;
+    }
+
+    inline const std::vector<Common::FMat4x4>& SceneProxyContainer<LightSceneProxy>::LocalToWorlds() const
+    {
+        return localToWorlds;
+    }
+
+    inline const std::vector<Common::Color>& SceneProxyContainer<LightSceneProxy>::Colors() const
+    {
+        return colors;
+    }
+
+    inline const std::vector<float>& SceneProxyContainer<LightSceneProxy>::Intensities() const
+    {
+        return intensities;
+    }
+
+    inline const std::vector<float>& SceneProxyContainer<LightSceneProxy>::Radii() const
+    {
+        return radii;
+    }
+}
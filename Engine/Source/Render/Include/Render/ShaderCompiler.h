@@ -6,10 +6,13 @@
 
 #include <vector>
 #include <string>
+#include <atomic>
+#include <mutex>
 
 #include <RHI/Common.h>
 #include <Render/Shader.h>
 #include <Common/Concurrent.h>
+#include <Common/FileSystem.h>
 
 namespace Render {
     enum class ShaderByteCodeType : uint8_t {
@@ -47,18 +50,55 @@ namespace Render {
         std::unordered_map<std::pair<ShaderTypeKey, VariantKey>, std::string, ShaderTypeAndVariantHashProvider> errorInfos;
     };
 
+    struct ShaderByteCodeCacheStats {
+        uint32_t hitNum;
+        uint32_t missNum;
+
+        ShaderByteCodeCacheStats();
+    };
+
+    // content addressed disk cache of compile outputs, the key covers everything that affects the output: source,
+    // included files, definitions, entry point, stage and compile options
+    class ShaderByteCodeCache {
+    public:
+        static ShaderByteCodeCache& Get();
+        ~ShaderByteCodeCache();
+
+        // an empty directory disables the cache, defaults to Shader in engine cache dir
+        void SetDirectory(const Common::Path& inDirectory);
+        Common::Path GetDirectory() const;
+        uint64_t ComputeKey(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions) const;
+        bool Load(uint64_t inKey, ShaderCompileOutput& outOutput);
+        void Save(uint64_t inKey, const ShaderCompileOutput& inOutput) const;
+        ShaderByteCodeCacheStats GetStats() const;
+
+    private:
+        ShaderByteCodeCache();
+
+        Common::Path GetFilePath(uint64_t inKey) const;
+
+        mutable std::mutex mutex;
+        Common::Path directory;
+        std::atomic<uint32_t> hitNum;
+        std::atomic<uint32_t> missNum;
+    };
+
     class ShaderCompiler {
     public:
         static ShaderCompiler& Get();
         ~ShaderCompiler();
         std::future<ShaderCompileOutput> Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions);
+        template <typename F> void Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions, F&& inOnFinished);
 
     private:
         ShaderCompiler();
 
+        static ShaderCompileOutput CompileOrLoadCached(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions);
+
         Common::ThreadPool threadPool;
     };
 
+    // variants of all shader types are compiled as independent tasks of ShaderCompiler, no thread waits on another
     class ShaderTypeCompiler {
     public:
         static ShaderTypeCompiler& Get();
@@ -69,7 +109,15 @@ namespace Render {
 
     private:
         ShaderTypeCompiler();
-
-        Common::ThreadPool threadPool;
     };
 }
+
+namespace Render {
+    template <typename F>
+    void ShaderCompiler::Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions, F&& inOnFinished)
+    {
+        threadPool.EmplaceDetachedTask([inInput, inOptions, onFinished = std::forward<F>(inOnFinished)]() mutable -> void {
+            onFinished(CompileOrLoadCached(inInput, inOptions));
+        });
+    }
+}
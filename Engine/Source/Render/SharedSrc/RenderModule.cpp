@@ -2,8 +2,13 @@
 // Created by johnk on 2023/8/4.
 //
 
+#include <Common/Serialization.h>
 #include <Core/Thread.h>
+#include <Core/Paths.h>
 #include <Render/RenderModule.h>
+#include <Render/RenderCache.h>
+#include <Render/RenderGraph.h>
+#include <Render/ResourcePool.h>
 #include <Render/Scene.h>
 
 namespace Render {
@@ -42,16 +47,25 @@ namespace Render {
             RHI::DeviceCreateInfo()
                 .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1))
                 .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::compute, 1))
-                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::transfer, 1)));
+                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::transfer, 1))
+                .SetPipelineCacheData(LoadPipelineCacheData()));
+        LoadPrecacheList();
 
         initialized = true;
     }
 
     void RenderModule::DeInitialize()
     {
+        SavePipelineCache();
+
         RenderThread::Get().Stop();
         RenderWorkerThreads::Get().Stop();
 
+        // cached objects are created from the device, they must be released before it
+        if (rhiDevice != nullptr) {
+            BindGroupCache::Get(*rhiDevice).Invalidate();
+            ResourceViewCache::Get(*rhiDevice).Invalidate();
+        }
         rhiInstance = nullptr;
         rhiDevice = nullptr;
         initialized = false;
@@ -62,6 +76,70 @@ namespace Render {
         return rhiDevice.Get();
     }
 
+    void RenderModule::ForfeitCaches() const
+    {
+        Assert(Core::ThreadContext::IsRenderThread());
+        if (rhiDevice == nullptr) {
+            return;
+        }
+
+        RGCompileCache::Get(*rhiDevice).Forfeit();
+        BindGroupCache::Get(*rhiDevice).Forfeit();
+        ResourceViewCache::Get(*rhiDevice).Forfeit();
+        BufferPool::Get(*rhiDevice).Forfeit();
+        TexturePool::Get(*rhiDevice).Forfeit();
+    }
+
+    Common::Path RenderModule::GetPipelineCacheDir() const
+    {
+        return Core::Paths::EngineCacheDir() / "Pipeline" / RHI::GetAbbrStringByType(rhiInstance->GetRHIType());
+    }
+
+    std::vector<uint8_t> RenderModule::LoadPipelineCacheData() const
+    {
+        std::vector<uint8_t> result;
+        if (const auto path = GetPipelineCacheDir() / "PipelineCache.bin";
+            path.Exists()) {
+            Common::BinaryFileDeserializeStream stream(path.String());
+            if (!Common::Deserialize(stream, result).first) {
+                result.clear();
+            }
+        }
+        return result;
+    }
+
+    void RenderModule::LoadPrecacheList() const
+    {
+        if (const auto path = GetPipelineCacheDir() / "PrecacheList.bin";
+            path.Exists()) {
+            Common::BinaryFileDeserializeStream stream(path.String());
+            if (std::vector<uint64_t> hashes;
+                Common::Deserialize(stream, hashes).first) {
+                PipelineCache::Get(*rhiDevice).SetPrecacheList(hashes);
+            }
+        }
+    }
+
+    void RenderModule::SavePipelineCache() const
+    {
+        if (rhiDevice == nullptr) {
+            return;
+        }
+
+        auto& pipelineCache = PipelineCache::Get(*rhiDevice);
+        pipelineCache.WaitPendingCompiles();
+
+        const auto cacheDir = GetPipelineCacheDir();
+        {
+            Common::BinaryFileSerializeStream stream((cacheDir / "PipelineCache.bin").String());
+            Common::Serialize(stream, rhiDevice->GetPipelineCacheData());
+        }
+        {
+            Common::BinaryFileSerializeStream stream((cacheDir / "PrecacheList.bin").String());
+            Common::Serialize(stream, pipelineCache.GetPrecacheList());
+        }
+    }
+
     Render::RenderThread& RenderModule::GetRenderThread() const // NOLINT
     {
         return RenderThread::Get();
@@ -5,13 +5,43 @@
 #include <Render/RenderCache.h>
 
 #include <utility>
+#include <array>
+#include <algorithm>
+#include <ranges>
 
 #include <Common/IO.h>
 #include <Core/Thread.h>
+#include <Render/RenderThread.h>
 
 namespace Render::Internal {
     constexpr uint64_t resourceViewCacheReleaseFrameLatency = 2;
     constexpr uint64_t bindGroupCacheReleaseFrameLatency = 2;
+
+    // entries are hashed in binding order, so the hash does not depend on the order they are added
+    static std::vector<uint64_t> ComputeBindGroupKey(const RHI::BindGroupCreateInfo& inCreateInfo)
+    {
+        std::vector<std::array<uint64_t, 4>> entryValues;
+        entryValues.reserve(inCreateInfo.entries.size());
+        for (const auto& [binding, entity] : inCreateInfo.entries) {
+            uint64_t platformBinding = 0;
+            if (const auto* hlslBinding = std::get_if<RHI::HlslBinding>(&binding.platformBinding)) {
+                platformBinding = static_cast<uint64_t>(hlslBinding->rangeType) << 8 | hlslBinding->index;
+            } else {
+                platformBinding = 1ull << 16 | std::get<RHI::GlslBinding>(binding.platformBinding).index;
+            }
+            const auto entityPtr = std::visit([](auto* ptr) -> uint64_t { return reinterpret_cast<uint64_t>(ptr); }, entity);
+            entryValues.emplace_back(std::array<uint64_t, 4> { platformBinding, static_cast<uint64_t>(binding.type), entity.index(), entityPtr });
+        }
+        std::ranges::sort(entryValues);
+
+        std::vector<uint64_t> values;
+        values.reserve(entryValues.size() * 4 + 1);
+        values.emplace_back(reinterpret_cast<uint64_t>(inCreateInfo.layout));
+        for (const auto& entryValue : entryValues) {
+            values.insert(values.end(), entryValue.begin(), entryValue.end());
+        }
+        return values;
+    }
 }
 
 namespace Render {
@@ -432,14 +462,26 @@ namespace Render {
 
     ComputePipelineState::ComputePipelineState(RHI::Device& inDevice, const ComputePipelineStateDesc& inDesc, const size_t inHash)
         : hash(inHash)
+        , rhiCreated(false)
     {
         const ComputePipelineLayoutDesc desc = { inDesc.shaders };
         pipelineLayout = PipelineLayoutCache::Get(inDevice).GetLayout(desc);
 
-        RHI::ComputePipelineCreateInfo createInfo;
         createInfo.layout = pipelineLayout->GetRHI();
         createInfo.computeShader = inDesc.shaders.computeShader.rhiHandle;
-        rhiHandle = inDevice.CreateComputePipeline(createInfo);
+    }
+
+    void ComputePipelineState::CreateRHI(RHI::Device& inDevice)
+    {
+        std::call_once(rhiCreateFlag, [&]() -> void {
+            rhiHandle = inDevice.CreateComputePipeline(createInfo);
+            rhiCreated = true;
+        });
+    }
+
+    bool ComputePipelineState::IsRHICreated() const
+    {
+        return rhiCreated;
     }
 
     ComputePipelineState::~ComputePipelineState() = default;
@@ -466,13 +508,13 @@ namespace Render {
 
     RasterPipelineState::RasterPipelineState(RHI::Device& inDevice, const RasterPipelineStateDesc& inDesc, size_t inHash)
         : hash(inHash)
+        , rhiCreated(false)
     {
         RasterPipelineLayoutDesc desc = { inDesc.shaders };
         pipelineLayout = PipelineLayoutCache::Get(inDevice).GetLayout(desc);
 
         Assert(inDesc.shaders.vertexShader.reflectionData);
 
-        RHI::RasterPipelineCreateInfo createInfo;
         createInfo.layout = pipelineLayout->GetRHI();
         createInfo.vertexShader = inDesc.shaders.vertexShader.rhiHandle;
         createInfo.pixelShader = inDesc.shaders.pixelShader.rhiHandle;
@@ -484,7 +526,19 @@ namespace Render {
         createInfo.depthStencilState = inDesc.depthStencilState;
         createInfo.multiSampleState = inDesc.multiSampleState;
         createInfo.fragmentState = inDesc.fragmentState;
-        rhiHandle = inDevice.CreateRasterPipeline(createInfo);
+    }
+
+    void RasterPipelineState::CreateRHI(RHI::Device& inDevice)
+    {
+        std::call_once(rhiCreateFlag, [&]() -> void {
+            rhiHandle = inDevice.CreateRasterPipeline(createInfo);
+            rhiCreated = true;
+        });
+    }
+
+    bool RasterPipelineState::IsRHICreated() const
+    {
+        return rhiCreated;
     }
 
     RasterPipelineState::~RasterPipelineState() = default;
@@ -506,8 +560,10 @@ namespace Render {
 
     SamplerCache& SamplerCache::Get(RHI::Device& device)
     {
+        static std::mutex mutex;
         static std::unordered_map<RHI::Device*, Common::UniquePtr<SamplerCache>> map;
 
+        std::unique_lock lock(mutex);
         const auto iter = map.find(&device);
         if (iter == map.end()) {
             map[&device] = Common::UniquePtr(new SamplerCache(device));
@@ -524,6 +580,7 @@ namespace Render {
 
     Sampler* SamplerCache::GetOrCreate(const RSamplerDesc& desc)
     {
+        std::unique_lock lock(mutex);
         const size_t hash = Common::HashUtils::CityHash(&desc, sizeof(RSamplerDesc));
         if (const auto iter = samplers.find(hash);
             iter == samplers.end()) {
@@ -532,10 +589,20 @@ namespace Render {
         return samplers[hash].Get();
     }
 
+    PipelineCacheStats::PipelineCacheStats()
+        : hitNum(0)
+        , syncCompiledNum(0)
+        , asyncCompiledNum(0)
+        , precachedNum(0)
+    {
+    }
+
     PipelineCache& PipelineCache::Get(RHI::Device& device)
     {
+        static std::mutex mutex;
         static std::unordered_map<RHI::Device*, Common::UniquePtr<PipelineCache>> map;
 
+        std::unique_lock lock(mutex);
         if (const auto iter = map.find(&device);
             iter == map.end()) {
             map[&device] = Common::UniquePtr(new PipelineCache(device));
@@ -548,10 +615,15 @@ namespace Render {
     {
     }
 
-    PipelineCache::~PipelineCache() = default;
+    PipelineCache::~PipelineCache()
+    {
+        WaitPendingCompiles();
+    }
 
     void PipelineCache::Invalidate()
     {
+        WaitPendingCompiles();
+        std::unique_lock lock(mutex);
         computePipelines.clear();
         rasterPipelines.clear();
         PipelineLayoutCache::Get(device).Invalidate();
@@ -559,28 +631,141 @@ namespace Render {
 
     ComputePipelineState* PipelineCache::GetOrCreate(const ComputePipelineStateDesc& desc)
     {
-        const auto hash = desc.Hash();
-        if (const auto iter = computePipelines.find(hash);
-            iter == computePipelines.end()) {
-            computePipelines[hash] = Common::UniquePtr(new ComputePipelineState(device, desc, hash));
-        }
-        return computePipelines[hash].Get();
+        return GetOrCreateInternal(computePipelines, desc, false);
     }
 
     RasterPipelineState* PipelineCache::GetOrCreate(const RasterPipelineStateDesc& desc)
     {
-        const auto hash = desc.Hash();
-        if (const auto iter = rasterPipelines.find(hash);
-            iter == rasterPipelines.end()) {
-            rasterPipelines[hash] = Common::UniquePtr(new RasterPipelineState(device, desc, hash));
+        return GetOrCreateInternal(rasterPipelines, desc, false);
+    }
+
+    ComputePipelineState* PipelineCache::GetOrCreateAsync(const ComputePipelineStateDesc& desc)
+    {
+        return GetOrCreateInternal(computePipelines, desc, true);
+    }
+
+    RasterPipelineState* PipelineCache::GetOrCreateAsync(const RasterPipelineStateDesc& desc)
+    {
+        return GetOrCreateInternal(rasterPipelines, desc, true);
+    }
+
+    bool PipelineCache::Precache(const ComputePipelineStateDesc& desc)
+    {
+        return PrecacheInternal(computePipelines, desc);
+    }
+
+    bool PipelineCache::Precache(const RasterPipelineStateDesc& desc)
+    {
+        return PrecacheInternal(rasterPipelines, desc);
+    }
+
+    void PipelineCache::SetPrecacheList(const std::vector<uint64_t>& inHashes)
+    {
+        std::unique_lock lock(mutex);
+        recordedHashes = std::unordered_set(inHashes.begin(), inHashes.end());
+    }
+
+    std::vector<uint64_t> PipelineCache::GetPrecacheList() const
+    {
+        // only pipelines requested in this run are recorded, precached ones that were never used drop out of the list
+        std::unique_lock lock(mutex);
+        std::vector<uint64_t> result(usedHashes.begin(), usedHashes.end());
+        std::ranges::sort(result);
+        return result;
+    }
+
+    void PipelineCache::WaitPendingCompiles()
+    {
+        // the tasks are taken out under the lock and waited without it, so callers of GetOrCreate are not blocked
+        // meanwhile, a compile task started after this is not waited
+        std::vector<std::future<void>> compileTasks;
+        {
+            std::unique_lock lock(mutex);
+            const auto takeTasks = [&compileTasks]<typename S>(EntryMap<S>& entries) -> void {
+                for (auto& entry : entries | std::views::values) {
+                    if (entry.compileTask.valid()) {
+                        compileTasks.emplace_back(std::move(entry.compileTask));
+                    }
+                }
+            };
+            takeTasks(computePipelines);
+            takeTasks(rasterPipelines);
         }
-        return rasterPipelines[hash].Get();
+        for (auto& compileTask : compileTasks) {
+            compileTask.get();
+        }
+    }
+
+    PipelineCacheStats PipelineCache::GetStats() const
+    {
+        std::unique_lock lock(mutex);
+        return stats;
+    }
+
+    template <typename S, typename D>
+    S* PipelineCache::GetOrCreateInternal(EntryMap<S>& inEntries, const D& inDesc, bool inAsync)
+    {
+        const auto hash = inDesc.Hash();
+        S* state;
+        {
+            std::unique_lock lock(mutex);
+            usedHashes.emplace(hash);
+
+            auto iter = inEntries.find(hash);
+            if (iter == inEntries.end()) {
+                iter = inEntries.emplace(hash, Entry<S> { Common::UniquePtr<S>(new S(device, inDesc, hash)), {} }).first;
+                if (inAsync) {
+                    CompileAsync(iter->second);
+                    stats.asyncCompiledNum++;
+                    return nullptr;
+                }
+                stats.syncCompiledNum++;
+            } else {
+                if (inAsync && !iter->second.state->IsRHICreated()) {
+                    return nullptr;
+                }
+                stats.hitNum++;
+            }
+            state = iter->second.state.Get();
+        }
+
+        // created outside the lock, so other threads are not stalled by the compile, when a worker is already
+        // compiling this state, this waits for it instead of compiling again
+        state->CreateRHI(device);
+        return state;
+    }
+
+    template <typename S, typename D>
+    bool PipelineCache::PrecacheInternal(EntryMap<S>& inEntries, const D& inDesc)
+    {
+        const auto hash = inDesc.Hash();
+        std::unique_lock lock(mutex);
+        if (!recordedHashes.contains(hash) || inEntries.contains(hash)) {
+            return false;
+        }
+
+        auto& entry = inEntries.emplace(hash, Entry<S> { Common::UniquePtr<S>(new S(device, inDesc, hash)), {} }).first->second;
+        CompileAsync(entry);
+        stats.precachedNum++;
+        return true;
+    }
+
+    template <typename S>
+    void PipelineCache::CompileAsync(Entry<S>& inEntry)
+    {
+        // the pipeline layout is already resolved by the state constructor, so the worker only touches the rhi device,
+        // and pipeline creation is thread safe in every backend
+        inEntry.compileTask = RenderWorkerThreads::Get().EmplaceTask([this, state = inEntry.state.Get()]() -> void {
+            state->CreateRHI(device);
+        });
     }
 
     ResourceViewCache& ResourceViewCache::Get(RHI::Device& device)
     {
+        static std::mutex mutex;
         static std::unordered_map<RHI::Device*, Common::UniquePtr<ResourceViewCache>> map;
 
+        std::unique_lock lock(mutex);
         if (!map.contains(&device)) {
             map.emplace(std::make_pair(&device, Common::UniquePtr(new ResourceViewCache(device))));
         }
@@ -596,7 +781,11 @@ namespace Render {
 
     RHI::BufferView* ResourceViewCache::GetOrCreate(RHI::Buffer* buffer, const RHI::BufferViewCreateInfo& inDesc)
     {
-        auto& views = bufferViewCaches[buffer].views;
+        std::unique_lock lock(mutex);
+        auto& cache = bufferViewCaches[buffer];
+        cache.valid = true;
+        cache.lastUsedFrame = Core::ThreadContext::FrameNumber();
+        auto& views = cache.views;
 
         auto hash = inDesc.Hash();
         if (const auto iter = views.find(hash);
@@ -608,7 +797,11 @@ namespace Render {
 
     RHI::TextureView* ResourceViewCache::GetOrCreate(RHI::Texture* texture, const RHI::TextureViewCreateInfo& inDesc)
     {
-        auto& views = textureViewCaches[texture].views;
+        std::unique_lock lock(mutex);
+        auto& cache = textureViewCaches[texture];
+        cache.valid = true;
+        cache.lastUsedFrame = Core::ThreadContext::FrameNumber();
+        auto& views = cache.views;
 
         auto hash = inDesc.Hash();
         if (const auto iter = views.find(hash);
@@ -618,16 +811,25 @@ namespace Render {
         return views.at(hash).Get();
     }
 
-    void ResourceViewCache::Invalidate(RHI::Buffer* buffer) // NOLINT
+    void ResourceViewCache::Invalidate()
     {
+        std::unique_lock lock(mutex);
+        bufferViewCaches.clear();
+        textureViewCaches.clear();
+    }
+
+    void ResourceViewCache::Invalidate(RHI::Buffer* buffer)
+    {
+        std::unique_lock lock(mutex);
         if (const auto iter = bufferViewCaches.find(buffer);
             iter != bufferViewCaches.end()) {
             iter->second.valid = false;
         }
     }
 
-    void ResourceViewCache::Invalidate(RHI::Texture* texture) // NOLINT
+    void ResourceViewCache::Invalidate(RHI::Texture* texture)
     {
+        std::unique_lock lock(mutex);
         if (const auto iter = textureViewCaches.find(texture);
             iter != textureViewCaches.end()) {
             iter->second.valid = false;
@@ -636,7 +838,9 @@ namespace Render {
 
     void ResourceViewCache::Forfeit()
     {
-        const auto forfeitCaches = [](auto& caches) -> void { // NOLINT
+        // the bind group cache is locked inside this lock, it never calls back into the view cache
+        std::unique_lock lock(mutex);
+        const auto forfeitCaches = [this](auto& caches) -> void { // NOLINT
             const auto currentFrameNumber = Core::ThreadContext::FrameNumber();
 
             std::vector<typename std::decay_t<decltype(caches)>::key_type> resourcesToRelease;
@@ -652,7 +856,11 @@ namespace Render {
                 }
             }
 
+            // bind groups referencing the released views must not be reused by a new view at the same address
             for (auto* resourceToRelease : resourcesToRelease) {
+                for (const auto& view : caches.at(resourceToRelease).views | std::views::values) {
+                    BindGroupCache::Get(device).Invalidate(view.Get());
+                }
                 caches.erase(resourceToRelease);
             }
         };
@@ -661,10 +869,19 @@ namespace Render {
         forfeitCaches(textureViewCaches);
     }
 
+    BindGroupCacheStats::BindGroupCacheStats()
+        : hitNum(0)
+        , missNum(0)
+        , invalidatedNum(0)
+    {
+    }
+
     BindGroupCache& BindGroupCache::Get(RHI::Device& device)
     {
+        static std::mutex mutex;
         static std::unordered_map<RHI::Device*, Common::UniquePtr<BindGroupCache>> map;
 
+        std::unique_lock lock(mutex);
         if (!map.contains(&device)) {
             map.emplace(std::make_pair(&device, Common::UniquePtr(new BindGroupCache(device))));
         }
@@ -675,31 +892,119 @@ namespace Render {
 
     RHI::BindGroup* BindGroupCache::Allocate(const RHI::BindGroupCreateInfo& inCreateInfo)
     {
-        const auto& [ptr, frameNumber] = bindGroups.emplace_back(device.CreateBindGroup(inCreateInfo), Core::ThreadContext::FrameNumber());
-        return ptr.Get();
+        auto key = Internal::ComputeBindGroupKey(inCreateInfo);
+        auto hash = Common::HashUtils::CityHash(key.data(), key.size() * sizeof(uint64_t));
+        const auto currentFrame = Core::ThreadContext::FrameNumber();
+        std::unique_lock lock(mutex);
+        // a colliding hash probes the next slot, keys are compared so a group with other entries is never returned
+        for (auto iter = bindGroups.find(hash); iter != bindGroups.end(); iter = bindGroups.find(++hash)) {
+            if (iter->second.key == key) {
+                stats.hitNum++;
+                iter->second.lastUsedFrame = currentFrame;
+                return iter->second.bindGroup.Get();
+            }
+        }
+
+        stats.missNum++;
+        std::vector<const void*> views;
+        views.reserve(inCreateInfo.entries.size());
+        for (const auto& entry : inCreateInfo.entries) {
+            if (const auto* bufferView = std::get_if<RHI::BufferView*>(&entry.entity)) {
+                views.emplace_back(*bufferView);
+            } else if (const auto* textureView = std::get_if<RHI::TextureView*>(&entry.entity)) {
+                views.emplace_back(*textureView);
+            }
+        }
+        for (const auto* view : views) {
+            viewBindGroups[view].emplace_back(hash);
+        }
+
+        const auto& [iter, emplaced] = bindGroups.emplace(hash, CachedBindGroup { device.CreateBindGroup(inCreateInfo), currentFrame, std::move(key), std::move(views) });
+        return iter->second.bindGroup.Get();
     }
 
     void BindGroupCache::Invalidate()
     {
+        std::unique_lock lock(mutex);
         bindGroups.clear();
+        viewBindGroups.clear();
+    }
+
+    void BindGroupCache::Invalidate(RHI::BufferView* inView)
+    {
+        std::unique_lock lock(mutex);
+        InvalidateByView(inView);
+    }
+
+    void BindGroupCache::Invalidate(RHI::TextureView* inView)
+    {
+        std::unique_lock lock(mutex);
+        InvalidateByView(inView);
     }
 
     void BindGroupCache::Forfeit()
     {
         const auto currentFrame = Core::ThreadContext::FrameNumber();
+        std::unique_lock lock(mutex);
 
-        for (auto i = 0; i < bindGroups.size();) {
-            const auto& [ptr, lastUsedFrame] = bindGroups[i];
-            if (currentFrame - lastUsedFrame > Internal::bindGroupCacheReleaseFrameLatency) { // NOLINT
-                bindGroups.erase(bindGroups.begin() + i);
-            } else {
-                i++;
+        std::vector<uint64_t> hashesToRelease;
+        for (const auto& [hash, cachedBindGroup] : bindGroups) {
+            if (currentFrame - cachedBindGroup.lastUsedFrame > Internal::bindGroupCacheReleaseFrameLatency) { // NOLINT
+                hashesToRelease.emplace_back(hash);
             }
         }
+        for (const auto hash : hashesToRelease) {
+            Erase(hash);
+        }
+    }
+
+    size_t BindGroupCache::Size() const
+    {
+        std::unique_lock lock(mutex);
+        return bindGroups.size();
+    }
+
+    BindGroupCacheStats BindGroupCache::GetStats() const
+    {
+        std::unique_lock lock(mutex);
+        return stats;
     }
 
     BindGroupCache::BindGroupCache(RHI::Device& inDevice)
         : device(inDevice)
     {
     }
+
+    void BindGroupCache::InvalidateByView(const void* inView)
+    {
+        const auto iter = viewBindGroups.find(inView);
+        if (iter == viewBindGroups.end()) {
+            return;
+        }
+
+        const auto hashes = std::move(iter->second);
+        viewBindGroups.erase(iter);
+        for (const auto hash : hashes) {
+            if (bindGroups.contains(hash)) {
+                stats.invalidatedNum++;
+                Erase(hash);
+            }
+        }
+    }
+
+    void BindGroupCache::Erase(uint64_t inHash)
+    {
+        const auto iter = bindGroups.find(inHash);
+        Assert(iter != bindGroups.end());
+        for (const auto* view : iter->second.views) {
+            if (const auto viewIter = viewBindGroups.find(view);
+                viewIter != viewBindGroups.end()) {
+                std::erase(viewIter->second, inHash);
+                if (viewIter->second.empty()) {
+                    viewBindGroups.erase(viewIter);
+                }
+            }
+        }
+        bindGroups.erase(iter);
+    }
 } // namespace Render
@@ -7,8 +7,16 @@
 #include <Render/RenderGraph.h>
 #include <Render/RenderThread.h>
 #include <Common/Container.h>
+#include <Core/Thread.h>
 
 namespace Render::Internal {
+    // compiled graphs only hold plans, they are cheap to keep, so topologies used every few frames are not recompiled
+    constexpr uint64_t rgCompiledGraphReleaseFrameLatency = 64;
+    // each recording group records into its own command buffer, too many groups only add submit and barrier overhead
+    constexpr size_t rgMaxParallelRecordingGroupNum = 8;
+    // the render thread runs at most one frame ahead of the GPU, objects of older frames are no longer executing
+    constexpr uint64_t rgCommandPoolReleaseFrameLatency = 2;
+
     static void ComputeReadsWritesForBindGroup(const RGBindGroupDesc& inDesc, std::unordered_set<RGResourceRef>& outReads, std::unordered_set<RGResourceRef>& outWrites)
     {
         for (const auto& [type, view] : inDesc.items | std::views::values) {
@@ -43,7 +51,7 @@ namespace Render::Internal {
         return {};
     }
 
-    static RHI::RasterPassBeginInfo GetRHIRasterPassBeginInfo(RGBuilder& builder, const RGRasterPassDesc& inDesc)
+    static RHI::RasterPassBeginInfo GetRHIRasterPassBeginInfo(const RGBuilder& builder, const RGRasterPassDesc& inDesc)
     {
         RHI::RasterPassBeginInfo result;
         if (inDesc.depthStencilAttachment.has_value()) {
@@ -55,11 +63,49 @@ namespace Render::Internal {
         }
         return result;
     }
+
+    // estimated by desc, real allocations also contain alignment and driver padding
+    static size_t GetResourceBytes(RGResourceRef inResource)
+    {
+        if (inResource->Type() == RGResType::buffer) {
+            return static_cast<RGBufferRef>(inResource)->GetDesc().size;
+        }
+        if (inResource->Type() == RGResType::texture) {
+            const auto& desc = static_cast<RGTextureRef>(inResource)->GetDesc();
+            const bool is3D = desc.dimension == RHI::TextureDimension::t3D;
+            size_t result = 0;
+            for (auto mip = 0; mip < desc.mipLevels; mip++) {
+                const size_t width = std::max(desc.width >> mip, 1u);
+                const size_t height = std::max(desc.height >> mip, 1u);
+                const size_t depthOrArraySize = is3D ? std::max(desc.depthOrArraySize >> mip, 1u) : desc.depthOrArraySize;
+                result += width * height * depthOrArraySize;
+            }
+            return result * RHI::GetBytesPerPixel(desc.format) * std::max<size_t>(desc.samples, 1);
+        }
+        Unimplement();
+        return 0;
+    }
+
+    static bool IsAliasCompatible(RGResourceRef inLhs, RGResourceRef inRhs)
+    {
+        if (inLhs->Type() != inRhs->Type()) {
+            return false;
+        }
+        if (inLhs->Type() == RGResType::buffer) {
+            return static_cast<RGBufferRef>(inLhs)->GetDesc() == static_cast<RGBufferRef>(inRhs)->GetDesc();
+        }
+        if (inLhs->Type() == RGResType::texture) {
+            return static_cast<RGTextureRef>(inLhs)->GetDesc() == static_cast<RGTextureRef>(inRhs)->GetDesc();
+        }
+        Unimplement();
+        return false;
+    }
 }
 
 namespace Render {
     RGResource::RGResource(const RGResType inType)
         : type(inType)
+        , index(0)
         , forceUsed(false)
         , imported(false)
     {
@@ -337,9 +383,19 @@ namespace Render {
     {
     }
 
+    RGTransientMemoryStats::RGTransientMemoryStats()
+        : transientResourceNum(0)
+        , physicalResourceNum(0)
+        , bytesWithoutAliasing(0)
+        , bytesWithAliasing(0)
+        , peakLiveBytes(0)
+    {
+    }
+
     RGPass::RGPass(std::string inName, RGPassType inType)
         : name(std::move(inName))
         , type(inType)
+        , index(0)
     {
     }
 
@@ -379,9 +435,176 @@ namespace Render {
 
     RGRasterPass::~RGRasterPass() = default;
 
-    RGBuilder::RGBuilder(RHI::Device& inDevice)
+    RGCompiledGraph::RGCompiledGraph() = default;
+
+    RGCompileCacheStats::RGCompileCacheStats()
+        : hitNum(0)
+        , missNum(0)
+    {
+    }
+
+    RGCompileCache& RGCompileCache::Get(RHI::Device& device)
+    {
+        static std::unordered_map<RHI::Device*, Common::UniquePtr<RGCompileCache>> map;
+
+        if (!map.contains(&device)) {
+            map.emplace(std::make_pair(&device, Common::UniquePtr(new RGCompileCache())));
+        }
+        return *map.at(&device);
+    }
+
+    RGCompileCache::~RGCompileCache() = default;
+
+    Common::SharedPtr<RGCompiledGraph> RGCompileCache::Find(uint64_t inTopologyHash)
+    {
+        const auto iter = entries.find(inTopologyHash);
+        if (iter == entries.end()) {
+            stats.missNum++;
+            return nullptr;
+        }
+        stats.hitNum++;
+        iter->second.lastUsedFrame = Core::ThreadContext::FrameNumber();
+        return iter->second.compiledGraph;
+    }
+
+    void RGCompileCache::Emplace(uint64_t inTopologyHash, Common::SharedPtr<RGCompiledGraph> inCompiledGraph)
+    {
+        entries.insert_or_assign(inTopologyHash, Entry { std::move(inCompiledGraph), Core::ThreadContext::FrameNumber() });
+    }
+
+    size_t RGCompileCache::Size() const
+    {
+        return entries.size();
+    }
+
+    const RGCompileCacheStats& RGCompileCache::GetStats() const
+    {
+        return stats;
+    }
+
+    void RGCompileCache::Invalidate()
+    {
+        entries.clear();
+    }
+
+    void RGCompileCache::Forfeit()
+    {
+        const auto currentFrame = Core::ThreadContext::FrameNumber();
+
+        for (auto iter = entries.begin(); iter != entries.end();) {
+            if (currentFrame - iter->second.lastUsedFrame > Internal::rgCompiledGraphReleaseFrameLatency) {
+                iter = entries.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
+    RGCompileCache::RGCompileCache() = default;
+
+    RGCommandPoolStats::RGCommandPoolStats()
+        : cmdBufferCreatedNum(0)
+        , cmdBufferReusedNum(0)
+        , semaphoreCreatedNum(0)
+        , semaphoreReusedNum(0)
+    {
+    }
+
+    RGCommandPool& RGCommandPool::Get(RHI::Device& device)
+    {
+        static std::unordered_map<RHI::Device*, Common::UniquePtr<RGCommandPool>> map;
+
+        if (!map.contains(&device)) {
+            map.emplace(std::make_pair(&device, Common::UniquePtr(new RGCommandPool(device))));
+        }
+        return *map.at(&device);
+    }
+
+    RGCommandPool::~RGCommandPool() = default;
+
+    RHI::CommandBuffer* RGCommandPool::AllocateCommandBuffer(RGQueueType inQueueType)
+    {
+        auto& inFlightCmdBuffers = GetInFlightQueueObjects(inQueueType).cmdBuffers;
+        if (auto& freeCmdBuffers = freeQueueObjects[inQueueType].cmdBuffers;
+            !freeCmdBuffers.empty()) {
+            // command buffers are reset by the backends when recording begins
+            inFlightCmdBuffers.emplace_back(std::move(freeCmdBuffers.back()));
+            freeCmdBuffers.pop_back();
+            stats.cmdBufferReusedNum++;
+        } else {
+            inFlightCmdBuffers.emplace_back(device.CreateCommandBuffer());
+            objectNum++;
+            stats.cmdBufferCreatedNum++;
+        }
+        return inFlightCmdBuffers.back().Get();
+    }
+
+    RHI::Semaphore* RGCommandPool::AllocateSemaphore(RGQueueType inQueueType)
+    {
+        auto& inFlightSemaphores = GetInFlightQueueObjects(inQueueType).semaphores;
+        if (auto& freeSemaphores = freeQueueObjects[inQueueType].semaphores;
+            !freeSemaphores.empty()) {
+            inFlightSemaphores.emplace_back(std::move(freeSemaphores.back()));
+            freeSemaphores.pop_back();
+            stats.semaphoreReusedNum++;
+        } else {
+            inFlightSemaphores.emplace_back(device.CreateSemaphore());
+            objectNum++;
+            stats.semaphoreCreatedNum++;
+        }
+        return inFlightSemaphores.back().Get();
+    }
+
+    size_t RGCommandPool::Size() const
+    {
+        return objectNum;
+    }
+
+    const RGCommandPoolStats& RGCommandPool::GetStats() const
+    {
+        return stats;
+    }
+
+    void RGCommandPool::Invalidate()
+    {
+        inFlightFrames.clear();
+        freeQueueObjects.clear();
+        objectNum = 0;
+    }
+
+    RGCommandPool::RGCommandPool(RHI::Device& inDevice)
+        : device(inDevice)
+        , objectNum(0)
+    {
+    }
+
+    RGCommandPool::QueueObjects& RGCommandPool::GetInFlightQueueObjects(RGQueueType inQueueType)
+    {
+        const auto currentFrame = Core::ThreadContext::FrameNumber();
+        while (!inFlightFrames.empty() && currentFrame - inFlightFrames.front().frame >= Internal::rgCommandPoolReleaseFrameLatency) {
+            for (auto& [queueType, objects] : inFlightFrames.front().queueObjects) {
+                auto& [freeCmdBuffers, freeSemaphores] = freeQueueObjects[queueType];
+                for (auto& cmdBuffer : objects.cmdBuffers) {
+                    freeCmdBuffers.emplace_back(std::move(cmdBuffer));
+                }
+                for (auto& semaphore : objects.semaphores) {
+                    freeSemaphores.emplace_back(std::move(semaphore));
+                }
+            }
+            inFlightFrames.pop_front();
+        }
+
+        if (inFlightFrames.empty() || inFlightFrames.back().frame != currentFrame) {
+            inFlightFrames.emplace_back(FrameObjects { currentFrame, {} });
+        }
+        return inFlightFrames.back().queueObjects[inQueueType];
+    }
+
+    RGBuilder::RGBuilder(RHI::Device& inDevice, bool inReuseCompiled)
         : executed(false)
         , device(inDevice)
+        , reuseCompiled(inReuseCompiled)
+        , compiledGraphReused(false)
     {
     }
 
@@ -391,6 +614,7 @@ namespace Render {
     {
         Assert(!executed);
         auto* const result = new RGBuffer(inDesc);
+        result->index = resources.size();
         resources.emplace_back(result);
         return result;
     }
@@ -399,6 +623,7 @@ namespace Render {
     {
         Assert(!executed);
         auto* const result = new RGTexture(inDesc);
+        result->index = resources.size();
         resources.emplace_back(result);
         return result;
     }
@@ -423,6 +648,7 @@ namespace Render {
     {
         Assert(!executed);
         auto* const result = new RGBuffer(inBuffer, inInitialState);
+        result->index = resources.size();
         resources.emplace_back(result);
         return result;
     }
@@ -431,6 +657,7 @@ namespace Render {
     {
         Assert(!executed);
         auto* const result = new RGTexture(inTexture, inInitialState);
+        result->index = resources.size();
         resources.emplace_back(result);
         return result;
     }
@@ -452,6 +679,7 @@ namespace Render {
     {
         Assert(!executed);
         const auto& pass = passes.emplace_back(new RGCopyPass(inName, inPassDesc, inFunc, inPreExecuteFunc, inPostExecuteFunc));
+        pass->index = passes.size() - 1;
         recordingAsyncTimeline[inAsyncCopy ? RGQueueType::asyncCopy : RGQueueType::main].emplace_back(pass.Get());
     }
 
@@ -459,6 +687,7 @@ namespace Render {
     {
         Assert(!executed);
         const auto& pass = passes.emplace_back(new RGComputePass(inName, inBindGroups, inFunc, inPreExecuteFunc, inPostExecuteFunc));
+        pass->index = passes.size() - 1;
         recordingAsyncTimeline[inAsyncCompute ? RGQueueType::asyncCompute : RGQueueType::main].emplace_back(pass.Get());
     }
 
@@ -466,6 +695,7 @@ namespace Render {
     {
         Assert(!executed);
         const auto& pass = passes.emplace_back(new RGRasterPass(inName, inPassDesc, inBindGroups, inFunc, inPreExecuteFunc, inPostExecuteFunc));
+        pass->index = passes.size() - 1;
         recordingAsyncTimeline[RGQueueType::main].emplace_back(pass.Get());
     }
 
@@ -493,7 +723,7 @@ namespace Render {
         if (inBuffer->imported) {
             return inBuffer->rhiHandleImported;
         }
-        AssertWithReason(!culledResources.contains(inBuffer), "resource has been culled");
+        AssertWithReason(!IsCulled(inBuffer), "resource has been culled");
         AssertWithReason(devirtualizedResources.contains(inBuffer), "resource was not devirtualized or has been released");
         return std::get<PooledBufferRef>(devirtualizedResources.at(inBuffer))->GetRHI();
     }
@@ -503,7 +733,7 @@ namespace Render {
         if (inTexture->imported) {
             return inTexture->rhiHandleImported;
         }
-        AssertWithReason(!culledResources.contains(inTexture), "resource has been culled");
+        AssertWithReason(!IsCulled(inTexture), "resource has been culled");
         AssertWithReason(devirtualizedResources.contains(inTexture), "resource was not devirtualized or has been released");
         return std::get<PooledTextureRef>(devirtualizedResources.at(inTexture))->GetRHI();
     }
@@ -511,7 +741,7 @@ namespace Render {
     RHI::BufferView* RGBuilder::GetRHI(RGBufferViewRef inBufferView) const
     {
         auto* resource = inBufferView->GetResource();
-        AssertWithReason(!culledResources.contains(resource), "resource has been culled");
+        AssertWithReason(!IsCulled(resource), "resource has been culled");
         AssertWithReason(resource->imported || devirtualizedResources.contains(resource), "resource was not devirtualized or has been released");
         AssertWithReason(devirtualizedResourceViews.contains(inBufferView), "resource view was not devirtualized or has been released");
         return std::get<RHI::BufferView*>(devirtualizedResourceViews.at(inBufferView));
@@ -520,7 +750,7 @@ namespace Render {
     RHI::TextureView* RGBuilder::GetRHI(RGTextureViewRef inTextureView) const
     {
         auto* resource = inTextureView->GetResource();
-        AssertWithReason(!culledResources.contains(resource), "resource has been culled");
+        AssertWithReason(!IsCulled(resource), "resource has been culled");
         AssertWithReason(resource->imported || devirtualizedResources.contains(resource), "resource was not devirtualized or has been released");
         AssertWithReason(devirtualizedResourceViews.contains(inTextureView), "resource view was not devirtualized or has been released");
         return std::get<RHI::TextureView*>(devirtualizedResourceViews.at(inTextureView));
@@ -532,6 +762,24 @@ namespace Render {
         return devirtualizedBindGroups.at(inBindGroup);
     }
 
+    const RGTransientMemoryStats& RGBuilder::GetTransientMemoryStats() const
+    {
+        Assert(executed);
+        return compiledGraph->transientMemoryStats;
+    }
+
+    bool RGBuilder::CompiledGraphReused() const
+    {
+        Assert(executed);
+        return compiledGraphReused;
+    }
+
+    const std::vector<RGCompiledGraph::Transition>& RGBuilder::GetPassTransitions(uint32_t inPassIndex) const
+    {
+        Assert(executed);
+        return compiledGraph->passTransitions[inPassIndex];
+    }
+
     RGBuilder::AsyncTimelineExecuteContext::AsyncTimelineExecuteContext() = default;
 
     RGBuilder::AsyncTimelineExecuteContext::AsyncTimelineExecuteContext(AsyncTimelineExecuteContext&& inOther) noexcept // NOLINT
@@ -542,9 +790,29 @@ namespace Render {
 
     void RGBuilder::Compile()
     {
-        CompilePassReadWrites();
-        PerformCull();
-        ComputeResourcesInitialState();
+        if (reuseCompiled) {
+            auto& compileCache = RGCompileCache::Get(device);
+            const auto topologyHash = ComputeTopologyHash();
+            compiledGraph = compileCache.Find(topologyHash);
+            compiledGraphReused = compiledGraph != nullptr;
+            if (!compiledGraphReused) {
+                compiledGraph = CompileInternal();
+                compileCache.Emplace(topologyHash, compiledGraph);
+            }
+        } else {
+            compiledGraph = CompileInternal();
+        }
+        Assert(compiledGraph->culledResources.size() == resources.size() && compiledGraph->culledPasses.size() == passes.size());
+
+        resourceReadCounts = compiledGraph->resourceReadCounts;
+        aliasSlots.reserve(compiledGraph->aliasSlotTypes.size());
+        for (const auto type : compiledGraph->aliasSlotTypes) {
+            if (type == RGResType::buffer) {
+                aliasSlots.emplace_back(PooledBufferRef());
+            } else {
+                aliasSlots.emplace_back(PooledTextureRef());
+            }
+        }
     }
 
     void RGBuilder::ExecuteInternal(const RGExecuteInfo& inExecuteInfo) // NOLINT
@@ -570,7 +838,7 @@ namespace Render {
                 // wait all cmd buffers in last async timeline executed
                 for (const AsyncTimelineExecuteContext& lastContext = asyncTimelineExecuteContexts.back();
                     const auto& semaphore : lastContext.queueSemaphoreToSignalMap | std::views::values) {
-                    semaphoresToWait.emplace_back(semaphore.Get());
+                    semaphoresToWait.emplace_back(semaphore);
                 }
             }
 
@@ -580,32 +848,13 @@ namespace Render {
             commandBufferMap.reserve(queueNumInAsyncTimeline);
             semaphoreMap.reserve(queueNumInAsyncTimeline);
 
+            auto& commandPool = RGCommandPool::Get(device);
             for (const auto& [queueType, passes] : queuePasses) {
-                commandBufferMap.emplace(queueType, device.CreateCommandBuffer());
-                semaphoreMap.emplace(queueType, isLastAsyncTimeline ? nullptr : device.CreateSemaphore());
-
-                auto& commandBufferToRecord = commandBufferMap.at(queueType);
-                auto& semaphoreToSignal = semaphoreMap.at(queueType);
-
-                {
-                    auto commandRecorder = commandBufferToRecord->Begin();
-                    for (auto* pass : passes) {
-                        if (culledPasses.contains(pass)) {
-                            continue;
-                        }
+                semaphoreMap.emplace(queueType, isLastAsyncTimeline ? nullptr : commandPool.AllocateSemaphore(queueType));
 
-                        if (pass->type == RGPassType::copy) {
-                            ExecuteCopyPass(*commandRecorder, static_cast<RGCopyPass*>(pass));
-                        } else if (pass->type == RGPassType::compute) {
-                            ExecuteComputePass(*commandRecorder, static_cast<RGComputePass*>(pass));
-                        } else if (pass->type == RGPassType::raster) {
-                            ExecuteRasterPass(*commandRecorder, static_cast<RGRasterPass*>(pass));
-                        } else {
-                            Unimplement();
-                        }
-                    }
-                    commandRecorder->End();
-                }
+                auto& commandBuffersToRecord = commandBufferMap[queueType];
+                auto* semaphoreToSignal = semaphoreMap.at(queueType);
+                RecordQueuePasses(commandBuffersToRecord, queueType, passes, inExecuteInfo.parallelRecording);
 
                 auto [rhiQueueType, rhiQueueIndex] = Internal::GetRHIQueueTypeAndIndex(queueType);
                 auto submitInfo = RHI::QueueSubmitInfo()
@@ -617,7 +866,7 @@ namespace Render {
                     }
                 } else {
                     // if within the builder, just wait last async timeline commands executed
-                    submitInfo.AddSignalSemaphore(semaphoreToSignal.Get());
+                    submitInfo.AddSignalSemaphore(semaphoreToSignal);
                 }
                 if (queueType == RGQueueType::main && isLastAsyncTimeline && inExecuteInfo.inFenceToSignal != nullptr) {
                     // if is last async timeline, also need signal fence to notify CPU if needed
@@ -626,21 +875,147 @@ namespace Render {
 
                 device
                     .GetQueue(rhiQueueType, rhiQueueIndex)
-                    ->Submit(commandBufferToRecord.Get(), submitInfo);
+                    ->Submit(commandBuffersToRecord, submitInfo);
             }
         }
     }
 
-    void RGBuilder::CompilePassReadWrites() // NOLINT
+    uint64_t RGBuilder::ComputeTopologyHash() const
     {
+        // everything compile reads, per frame data like imported handles, views, bind group layouts and pass functions are
+        // bound while executing, so they are not hashed
+        constexpr uint64_t noResource = std::numeric_limits<uint64_t>::max();
+        std::vector<uint64_t> values;
+        values.reserve(resources.size() * 4 + passes.size() * 8);
+
+        const auto appendResource = [&](RGResourceRef inResource) -> void {
+            values.emplace_back(inResource->index);
+        };
+        const auto appendBindGroups = [&](const std::vector<RGBindGroupRef>& inBindGroups) -> void {
+            values.emplace_back(inBindGroups.size());
+            for (const auto* bindGroup : inBindGroups) {
+                // items are sorted by name hash, so the hash is independent of the map iteration order
+                std::vector<std::tuple<uint64_t, uint64_t, uint64_t>> items;
+                items.reserve(bindGroup->desc.items.size());
+                for (const auto& [name, item] : bindGroup->desc.items) {
+                    uint64_t resourceIndex = noResource;
+                    if (item.type == RHI::BindingType::uniformBuffer || item.type == RHI::BindingType::storageBuffer || item.type == RHI::BindingType::rwStorageBuffer) {
+                        resourceIndex = std::get<RGBufferViewRef>(item.view)->GetResource()->index;
+                    } else if (item.type == RHI::BindingType::texture || item.type == RHI::BindingType::storageTexture) {
+                        resourceIndex = std::get<RGTextureViewRef>(item.view)->GetResource()->index;
+                    }
+                    items.emplace_back(Common::HashUtils::CityHash(name.data(), name.size()), static_cast<uint64_t>(item.type), resourceIndex);
+                }
+                std::ranges::sort(items);
+
+                values.emplace_back(items.size());
+                for (const auto& [nameHash, type, resourceIndex] : items) {
+                    values.emplace_back(nameHash);
+                    values.emplace_back(type);
+                    values.emplace_back(resourceIndex);
+                }
+            }
+        };
+
+        values.emplace_back(resources.size());
+        for (const auto& resource : resources) {
+            values.emplace_back(static_cast<uint64_t>(resource->type));
+            values.emplace_back(resource->imported);
+            values.emplace_back(resource->forceUsed);
+            if (resource->type == RGResType::buffer) {
+                values.emplace_back(static_cast<RGBufferRef>(resource.Get())->desc.Hash());
+            } else if (resource->type == RGResType::texture) {
+                values.emplace_back(static_cast<RGTextureRef>(resource.Get())->desc.Hash());
+            } else {
+                Unimplement();
+            }
+        }
+
+        values.emplace_back(passes.size());
+        for (const auto& pass : passes) {
+            values.emplace_back(static_cast<uint64_t>(pass->type));
+            if (pass->type == RGPassType::copy) {
+                const auto& [copySrcs, copyDsts] = static_cast<RGCopyPass*>(pass.Get())->passDesc;
+                values.emplace_back(copySrcs.size());
+                std::ranges::for_each(copySrcs, appendResource);
+                values.emplace_back(copyDsts.size());
+                std::ranges::for_each(copyDsts, appendResource);
+            } else if (pass->type == RGPassType::compute) {
+                appendBindGroups(static_cast<RGComputePass*>(pass.Get())->bindGroups);
+            } else if (pass->type == RGPassType::raster) {
+                const auto* rasterPass = static_cast<RGRasterPass*>(pass.Get());
+                appendBindGroups(rasterPass->bindGroups);
+
+                const auto& [colorAttachments, depthStencilAttachment] = rasterPass->passDesc;
+                values.emplace_back(depthStencilAttachment.has_value());
+                if (depthStencilAttachment.has_value()) {
+                    appendResource(depthStencilAttachment->view->GetResource());
+                    values.emplace_back(depthStencilAttachment->depthReadOnly);
+                }
+                values.emplace_back(colorAttachments.size());
+                for (const auto& colorAttachment : colorAttachments) {
+                    appendResource(colorAttachment.view->GetResource());
+                }
+            } else {
+                Unimplement();
+            }
+        }
+
+        // queue passes are hashed in map order, which is also the execute order
+        values.emplace_back(asyncTimelines.size());
+        for (const auto& queuePasses : asyncTimelines) {
+            values.emplace_back(queuePasses.size());
+            for (const auto& [queueType, queuePassRefs] : queuePasses) {
+                values.emplace_back(static_cast<uint64_t>(queueType));
+                values.emplace_back(queuePassRefs.size());
+                for (const auto* pass : queuePassRefs) {
+                    values.emplace_back(pass->index);
+                }
+            }
+        }
+
+        std::vector<uint64_t> uploadedBuffers;
+        uploadedBuffers.reserve(bufferUploads.size());
+        for (const auto* buffer : bufferUploads | std::views::keys) {
+            uploadedBuffers.emplace_back(buffer->index);
+        }
+        std::ranges::sort(uploadedBuffers);
+        values.emplace_back(uploadedBuffers.size());
+        values.insert(values.end(), uploadedBuffers.begin(), uploadedBuffers.end());
+
+        return Common::HashUtils::CityHash(values.data(), values.size() * sizeof(uint64_t));
+    }
+
+    Common::SharedPtr<RGCompiledGraph> RGBuilder::CompileInternal() const
+    {
+        auto result = Common::MakeShared<RGCompiledGraph>();
+        CompilePassReadWrites(*result);
+        PerformCull(*result);
+        const auto lifetimes = ComputeResourceLifetimes(*result);
+        std::vector<std::optional<uint32_t>> aliasPredecessors(resources.size());
+        PlanTransientAliasing(*result, lifetimes, aliasPredecessors);
+        PlanTransitions(*result, aliasPredecessors);
+        return result;
+    }
+
+    void RGBuilder::CompilePassReadWrites(RGCompiledGraph& outGraph) const
+    {
+        const auto toSortedIndices = [](const std::unordered_set<RGResourceRef>& inResources) -> std::vector<uint32_t> {
+            std::vector<uint32_t> result;
+            result.reserve(inResources.size());
+            for (const auto* resource : inResources) {
+                result.emplace_back(resource->index);
+            }
+            std::ranges::sort(result);
+            return result;
+        };
+
+        outGraph.passReads.reserve(passes.size());
+        outGraph.passWrites.reserve(passes.size());
         for (const auto& pass : passes) {
             auto* passRef = pass.Get();
-            Assert(!passReadsMap.contains(passRef));
-            Assert(!passWritesMap.contains(passRef));
-            passReadsMap.emplace(std::make_pair(passRef, std::unordered_set<RGResourceRef> {}));
-            passWritesMap.emplace(std::make_pair(passRef, std::unordered_set<RGResourceRef> {}));
-            auto& passReads = passReadsMap.at(passRef);
-            auto& passWrites = passWritesMap.at(passRef);
+            std::unordered_set<RGResourceRef> passReads;
+            std::unordered_set<RGResourceRef> passWrites;
 
             if (passRef->type == RGPassType::copy) {
                 const auto* copyPass = static_cast<RGCopyPass*>(passRef);
@@ -671,30 +1046,34 @@ namespace Render {
             } else {
                 Unimplement();
             }
+
+            outGraph.passReads.emplace_back(toSortedIndices(passReads));
+            outGraph.passWrites.emplace_back(toSortedIndices(passWrites));
         }
 
+        outGraph.resourceReadCounts.reserve(resources.size());
         for (const auto& resource : resources) {
-            resourceReadCounts[resource.Get()] = resource->forceUsed || resource->imported ? 1 : 0;
+            outGraph.resourceReadCounts.emplace_back(resource->forceUsed || resource->imported ? 1 : 0);
         }
-        for (const auto& pass : passes) {
-            for (auto* read : passReadsMap.at(pass.Get())) {
-                resourceReadCounts[read]++;
+        for (const auto& passReads : outGraph.passReads) {
+            for (const auto read : passReads) {
+                outGraph.resourceReadCounts[read]++;
             }
         }
     }
 
     void RGBuilder::PerformSyncCheck() const
     {
-        auto collectQueueReadWrites = [this](const std::vector<RGPassRef>& passes, std::unordered_set<RGResourceRef>& outReads, std::unordered_set<RGResourceRef>& outWrites) -> void {
-            for (auto* pass : passes) {
-                Common::SetUtils::GetUnionInplace(outReads, passReadsMap.at(pass));
-                Common::SetUtils::GetUnionInplace(outWrites, passWritesMap.at(pass));
+        auto collectQueueReadWrites = [this](const std::vector<RGPassRef>& passes, std::unordered_set<uint32_t>& outReads, std::unordered_set<uint32_t>& outWrites) -> void {
+            for (const auto* pass : passes) {
+                outReads.insert(compiledGraph->passReads[pass->index].begin(), compiledGraph->passReads[pass->index].end());
+                outWrites.insert(compiledGraph->passWrites[pass->index].begin(), compiledGraph->passWrites[pass->index].end());
             }
         };
 
         for (const auto& queuePasses : asyncTimelines) {
-            std::vector<std::unordered_set<RGResourceRef>> queueReadsVec;
-            std::vector<std::unordered_set<RGResourceRef>> queueWritesVec;
+            std::vector<std::unordered_set<uint32_t>> queueReadsVec;
+            std::vector<std::unordered_set<uint32_t>> queueWritesVec;
             queueReadsVec.reserve(queuePasses.size());
             queueWritesVec.reserve(queuePasses.size());
 
@@ -721,125 +1100,430 @@ namespace Render {
         }
     }
 
-    void RGBuilder::PerformCull()
+    void RGBuilder::PerformCull(RGCompiledGraph& outGraph) const
     {
+        auto& culledResources = outGraph.culledResources;
+        auto& culledPasses = outGraph.culledPasses;
+        auto& resourceReadCounts = outGraph.resourceReadCounts;
+
         // initial cull
-        for (const auto& resource : resources) {
-            if (auto* resourceRef = resource.Get();
-                resourceReadCounts.at(resourceRef) == 0) {
-                culledResources.emplace(resourceRef);
-            }
+        culledResources.resize(resources.size(), false);
+        culledPasses.resize(passes.size(), false);
+        for (auto i = 0; i < resources.size(); i++) {
+            culledResources[i] = resourceReadCounts[i] == 0;
         }
 
         // iterative cull
         for (auto riter = passes.rbegin(); riter != passes.rend(); ++riter) {
-            const auto& pass = riter->Get();
-            const auto& passWrites = passWritesMap.at(pass);
-
-            bool allWritesCulled = true;
-            for (auto* write : passWrites) {
-                if (!culledResources.contains(write)) {
-                    allWritesCulled = false;
-                    break;
-                }
-            }
+            const auto passIndex = (*riter)->index;
+            const bool allWritesCulled = std::ranges::all_of(outGraph.passWrites[passIndex], [&](uint32_t write) -> bool {
+                return culledResources[write];
+            });
 
             if (!allWritesCulled) {
                 continue;
             }
-            culledPasses.emplace(pass);
-            for (const auto& passReads = passReadsMap.at(pass);
-                auto* read : passReads) {
-                if (auto& readCount = resourceReadCounts.at(read);
+            culledPasses[passIndex] = true;
+            for (const auto read : outGraph.passReads[passIndex]) {
+                if (auto& readCount = resourceReadCounts[read];
                     --readCount == 0) {
-                    culledResources.emplace(read);
+                    culledResources[read] = true;
                 }
             }
         }
     }
 
-    void RGBuilder::ComputeResourcesInitialState()
+    std::vector<std::optional<RGBuilder::ResourceLifetime>> RGBuilder::ComputeResourceLifetimes(const RGCompiledGraph& inGraph) const
     {
-        for (const auto& resource : resources) {
-            auto* resourceRef = resource.Get();
-            if (culledResources.contains(resourceRef)) {
+        std::vector<std::optional<ResourceLifetime>> result(resources.size());
+        const auto updateLifetime = [&](uint32_t inResource, uint32_t inFirstStep, uint32_t inLastStep) -> void {
+            if (resources[inResource]->imported || inGraph.culledResources[inResource]) {
+                return;
+            }
+            if (auto& lifetime = result[inResource];
+                !lifetime.has_value()) {
+                lifetime = ResourceLifetime { inFirstStep, inLastStep };
+            } else {
+                lifetime->firstStep = std::min(lifetime->firstStep, inFirstStep);
+                lifetime->lastStep = std::max(lifetime->lastStep, inLastStep);
+            }
+        };
+
+        uint32_t stepBase = 0;
+        for (const auto& queuePasses : asyncTimelines) {
+            uint32_t stepNum = 0;
+            for (const auto& passes : queuePasses | std::views::values) {
+                stepNum = std::max(stepNum, static_cast<uint32_t>(passes.size()));
+            }
+            if (stepNum == 0) {
                 continue;
             }
 
-            if (resourceRef->type == RGResType::buffer) {
-                resourceStates[resourceRef] = static_cast<RGBufferRef>(resourceRef)->desc.initialState;
-            } else if (resourceRef->type == RGResType::texture) {
-                resourceStates[resourceRef] = static_cast<RGTextureRef>(resourceRef)->desc.initialState;
-            } else {
-                Unimplement();
+            const bool concurrent = queuePasses.size() > 1;
+            for (const auto& passes : queuePasses | std::views::values) {
+                for (auto i = 0; i < passes.size(); i++) {
+                    const auto passIndex = passes[i]->index;
+                    if (inGraph.culledPasses[passIndex]) {
+                        continue;
+                    }
+                    const uint32_t firstStep = concurrent ? stepBase : stepBase + i;
+                    const uint32_t lastStep = concurrent ? stepBase + stepNum - 1 : stepBase + i;
+                    for (const auto read : inGraph.passReads[passIndex]) {
+                        updateLifetime(read, firstStep, lastStep);
+                    }
+                    for (const auto write : inGraph.passWrites[passIndex]) {
+                        updateLifetime(write, firstStep, lastStep);
+                    }
+                }
+            }
+            stepBase += stepNum;
+        }
+
+        // uploaded buffers are devirtualized before any pass is executed, resources used by no pass are kept for the
+        // whole graph, both of them never share memory with others
+        for (auto i = 0; i < resources.size(); i++) {
+            auto* resourceRef = resources[i].Get();
+            if (resourceRef->imported || inGraph.culledResources[i]) {
+                continue;
+            }
+            const bool uploaded = resourceRef->type == RGResType::buffer && bufferUploads.contains(static_cast<RGBufferRef>(resourceRef));
+            if (uploaded || !result[i].has_value()) {
+                result[i] = ResourceLifetime { 0, std::max(stepBase, 1u) - 1 };
             }
         }
+        return result;
     }
 
-    void RGBuilder::ExecuteCopyPass(RHI::CommandRecorder& inRecoder, RGCopyPass* inCopyPass)
+    void RGBuilder::PlanTransientAliasing(RGCompiledGraph& outGraph, const std::vector<std::optional<ResourceLifetime>>& inLifetimes, std::vector<std::optional<uint32_t>>& outAliasPredecessors) const
     {
-        DevirtualizeResources(passWritesMap.at(inCopyPass));
-        {
-            TransitionResourcesForCopyPassDesc(inRecoder, inCopyPass->passDesc);
-            if (inCopyPass->prePassFunc) {
-                inCopyPass->prePassFunc(*this, inRecoder);
+        // the pooled RHI objects can not be placed in user heaps, so the plan aliases by object: transient resources with
+        // the same desc and disjoint lifetimes share one pooled object, assigned greedily by first step, which reaches the
+        // minimum object count for each desc
+        auto& stats = outGraph.transientMemoryStats;
+        outGraph.resourceAliasSlots.resize(resources.size(), RGCompiledGraph::noAliasSlot);
+
+        std::vector<uint32_t> transientResources;
+        transientResources.reserve(resources.size());
+        for (auto i = 0; i < resources.size(); i++) {
+            if (inLifetimes[i].has_value()) {
+                transientResources.emplace_back(i);
             }
-            {
-                const auto copyPassRecoder = inRecoder.BeginCopyPass();
-                inCopyPass->passFunc(*this, *copyPassRecoder);
-                copyPassRecoder->EndPass();
+        }
+        std::ranges::stable_sort(transientResources, [&](uint32_t lhs, uint32_t rhs) -> bool {
+            return inLifetimes[lhs]->firstStep < inLifetimes[rhs]->firstStep;
+        });
+
+        struct SlotState {
+            uint32_t lastResource;
+            uint32_t lastStep;
+            size_t bytes;
+        };
+        std::vector<SlotState> slotStates;
+
+        for (const auto resource : transientResources) {
+            auto* resourceRef = resources[resource].Get();
+            const auto& lifetime = inLifetimes[resource].value();
+            const auto bytes = Internal::GetResourceBytes(resourceRef);
+
+            // prefer the slot released most recently, so slots released early stay free for resources starting early
+            std::optional<size_t> bestSlot;
+            for (auto i = 0; i < slotStates.size(); i++) {
+                const auto& slotState = slotStates[i];
+                if (slotState.lastStep >= lifetime.firstStep || !Internal::IsAliasCompatible(resources[slotState.lastResource].Get(), resourceRef)) {
+                    continue;
+                }
+                if (!bestSlot.has_value() || slotState.lastStep > slotStates[bestSlot.value()].lastStep) {
+                    bestSlot = i;
+                }
             }
-            if (inCopyPass->postPassFunc) {
-                inCopyPass->postPassFunc(*this, inRecoder);
+
+            if (bestSlot.has_value()) {
+                auto& slotState = slotStates[bestSlot.value()];
+                outAliasPredecessors[resource] = slotState.lastResource;
+                slotState.lastResource = resource;
+                slotState.lastStep = lifetime.lastStep;
+                outGraph.resourceAliasSlots[resource] = bestSlot.value();
+            } else {
+                outGraph.resourceAliasSlots[resource] = slotStates.size();
+                slotStates.emplace_back(SlotState { resource, lifetime.lastStep, bytes });
+                outGraph.aliasSlotTypes.emplace_back(resourceRef->type);
             }
+            stats.bytesWithoutAliasing += bytes;
+        }
+
+        stats.transientResourceNum = transientResources.size();
+        stats.physicalResourceNum = slotStates.size();
+        for (const auto& slotState : slotStates) {
+            stats.bytesWithAliasing += slotState.bytes;
+        }
+
+        std::vector<std::pair<uint32_t, int64_t>> liveBytesEvents;
+        liveBytesEvents.reserve(transientResources.size() * 2);
+        for (const auto resource : transientResources) {
+            const auto& lifetime = inLifetimes[resource].value();
+            const auto bytes = static_cast<int64_t>(Internal::GetResourceBytes(resources[resource].Get()));
+            liveBytesEvents.emplace_back(lifetime.firstStep, bytes);
+            liveBytesEvents.emplace_back(lifetime.lastStep + 1, -bytes);
+        }
+        // releases sort before allocations at the same step
+        std::ranges::sort(liveBytesEvents);
+        int64_t liveBytes = 0;
+        for (const auto& delta : liveBytesEvents | std::views::values) {
+            liveBytes += delta;
+            stats.peakLiveBytes = std::max(stats.peakLiveBytes, static_cast<size_t>(liveBytes));
         }
-        FinalizePassResources(passReadsMap.at(inCopyPass));
     }
 
-    void RGBuilder::ExecuteComputePass(RHI::CommandRecorder& inRecoder, RGComputePass* inComputePass)
+    void RGBuilder::PlanTransitions(RGCompiledGraph& outGraph, const std::vector<std::optional<uint32_t>>& inAliasPredecessors) const
     {
-        DevirtualizeResources(passWritesMap.at(inComputePass));
-        DevirtualizeBindGroupsAndViews(inComputePass->bindGroups);
-        {
-            TransitionResourcesForBindGroups(inRecoder, inComputePass->bindGroups);
-            if (inComputePass->prePassFunc) {
-                inComputePass->prePassFunc(*this, inRecoder);
+        // resource states are simulated in execute order, culled resources have no state and are never transitioned
+        std::vector<std::optional<RGResourceState>> resourceStates(resources.size());
+        std::vector<bool> devirtualized(resources.size(), false);
+        std::vector<bool> aliasBarrierPending(resources.size(), false);
+        for (auto i = 0; i < resources.size(); i++) {
+            if (outGraph.culledResources[i]) {
+                continue;
+            }
+            if (auto* resourceRef = resources[i].Get();
+                resourceRef->type == RGResType::buffer) {
+                resourceStates[i] = static_cast<RGBufferRef>(resourceRef)->desc.initialState;
+            } else if (resourceRef->type == RGResType::texture) {
+                resourceStates[i] = static_cast<RGTextureRef>(resourceRef)->desc.initialState;
+            } else {
+                Unimplement();
+            }
+        }
+        for (const auto* buffer : bufferUploads | std::views::keys) {
+            devirtualized[buffer->index] = true;
+        }
+
+        outGraph.passTransitions.resize(passes.size());
+        const auto transition = [&](std::vector<RGCompiledGraph::Transition>& outTransitions, RGResourceRef inResource, const RGResourceState& inState) -> void {
+            // the first use of an aliased resource always has a barrier, even in the state its predecessor was left in,
+            // otherwise its writes may overlap the predecessor accesses
+            auto& currentState = resourceStates[inResource->index];
+            if (!currentState.has_value() || (currentState.value() == inState && !aliasBarrierPending[inResource->index])) {
+                return;
             }
-            {
-                const auto computePassRecoder = inRecoder.BeginComputePass();
-                inComputePass->passFunc(*this, *computePassRecoder);
-                computePassRecoder->EndPass();
+            outTransitions.emplace_back(RGCompiledGraph::Transition { inResource->index, currentState.value(), inState });
+            currentState = inState;
+            aliasBarrierPending[inResource->index] = false;
+        };
+        const auto transitionBindGroups = [&](std::vector<RGCompiledGraph::Transition>& outTransitions, const std::vector<RGBindGroupRef>& inBindGroups) -> void {
+            for (const auto* bindGroup : inBindGroups) {
+                for (const auto& [type, view] : bindGroup->desc.items | std::views::values) {
+                    if (type == RHI::BindingType::uniformBuffer) {
+                        transition(outTransitions, std::get<RGBufferViewRef>(view)->GetResource(), RHI::BufferState::shaderReadOnly);
+                    } else if (type == RHI::BindingType::storageBuffer) {
+                        transition(outTransitions, std::get<RGBufferViewRef>(view)->GetResource(), RHI::BufferState::storage);
+                    } else if (type == RHI::BindingType::rwStorageBuffer) {
+                        transition(outTransitions, std::get<RGBufferViewRef>(view)->GetResource(), RHI::BufferState::rwStorage);
+                    } else if (type == RHI::BindingType::texture) {
+                        transition(outTransitions, std::get<RGTextureViewRef>(view)->GetResource(), RHI::TextureState::shaderReadOnly);
+                    } else if (type == RHI::BindingType::storageTexture) {
+                        transition(outTransitions, std::get<RGTextureViewRef>(view)->GetResource(), RHI::TextureState::storage);
+                    } else if (type == RHI::BindingType::sampler) {} else {
+                        Unimplement();
+                    }
+                }
             }
-            if (inComputePass->postPassFunc) {
-                inComputePass->postPassFunc(*this, inRecoder);
+        };
+
+        for (const auto& queuePasses : asyncTimelines) {
+            for (const auto& queuePassRefs : queuePasses | std::views::values) {
+                for (auto* pass : queuePassRefs) {
+                    if (outGraph.culledPasses[pass->index]) {
+                        continue;
+                    }
+
+                    // aliasing barrier, the first transition of an aliased resource starts from the last state of its
+                    // predecessor, which makes the GPU finish the predecessor accesses before the memory is reused
+                    for (const auto write : outGraph.passWrites[pass->index]) {
+                        if (devirtualized[write] || outGraph.culledResources[write]) {
+                            continue;
+                        }
+                        devirtualized[write] = true;
+                        if (const auto& predecessor = inAliasPredecessors[write];
+                            predecessor.has_value()) {
+                            resourceStates[write] = resourceStates[predecessor.value()];
+                            aliasBarrierPending[write] = true;
+                        }
+                    }
+
+                    auto& transitions = outGraph.passTransitions[pass->index];
+                    if (pass->type == RGPassType::copy) {
+                        const auto& [copySrcs, copyDsts] = static_cast<RGCopyPass*>(pass)->passDesc;
+                        for (auto* copySrc : copySrcs) {
+                            transition(transitions, copySrc, copySrc->type == RGResType::buffer ? RGResourceState(RHI::BufferState::copySrc) : RGResourceState(RHI::TextureState::copySrc));
+                        }
+                        for (auto* copyDst : copyDsts) {
+                            transition(transitions, copyDst, copyDst->type == RGResType::buffer ? RGResourceState(RHI::BufferState::copyDst) : RGResourceState(RHI::TextureState::copyDst));
+                        }
+                    } else if (pass->type == RGPassType::compute) {
+                        transitionBindGroups(transitions, static_cast<RGComputePass*>(pass)->bindGroups);
+                    } else if (pass->type == RGPassType::raster) {
+                        const auto* rasterPass = static_cast<RGRasterPass*>(pass);
+                        transitionBindGroups(transitions, rasterPass->bindGroups);
+
+                        const auto& [colorAttachments, depthStencilAttachment] = rasterPass->passDesc;
+                        if (depthStencilAttachment.has_value()) {
+                            transition(transitions, depthStencilAttachment->view->GetResource(), depthStencilAttachment->depthReadOnly ? RHI::TextureState::depthStencilReadonly : RHI::TextureState::depthStencilWrite);
+                        }
+                        for (const auto& colorAttachment : colorAttachments) {
+                            transition(transitions, colorAttachment.view->GetResource(), RHI::TextureState::renderTarget);
+                        }
+                    } else {
+                        Unimplement();
+                    }
+                }
             }
         }
-        FinalizePassResources(passReadsMap.at(inComputePass));
-        FinalizePassBindGroups(inComputePass->bindGroups);
     }
 
-    void RGBuilder::ExecuteRasterPass(RHI::CommandRecorder& inRecoder, RGRasterPass* inRasterPass)
+    bool RGBuilder::IsCulled(RGResourceRef inResource) const
     {
-        DevirtualizeResources(passWritesMap.at(inRasterPass));
-        DevirtualizeAttachmentViews(inRasterPass->passDesc);
-        DevirtualizeBindGroupsAndViews(inRasterPass->bindGroups);
-        {
-            TransitionResourcesForBindGroups(inRecoder, inRasterPass->bindGroups);
-            TransitionResourcesForRasterPassDesc(inRecoder, inRasterPass->passDesc);
-            if (inRasterPass->prePassFunc) {
-                inRasterPass->prePassFunc(*this, inRecoder);
-            }
-            {
-                const auto rasterPassRecoder = inRecoder.BeginRasterPass(Internal::GetRHIRasterPassBeginInfo(*this, inRasterPass->passDesc));
-                inRasterPass->passFunc(*this, *rasterPassRecoder);
-                rasterPassRecoder->EndPass();
+        return compiledGraph->culledResources[inResource->index];
+    }
+
+    void RGBuilder::RecordQueuePasses(std::vector<RHI::CommandBuffer*>& outCmdBuffers, RGQueueType inQueueType, const std::vector<RGPassRef>& inPasses, bool inParallel)
+    {
+        std::vector<RGPassRef> passesToRecord;
+        passesToRecord.reserve(inPasses.size());
+        for (auto* pass : inPasses) {
+            if (!compiledGraph->culledPasses[pass->index]) {
+                passesToRecord.emplace_back(pass);
             }
-            if (inRasterPass->postPassFunc) {
-                inRasterPass->postPassFunc(*this, inRecoder);
+        }
+
+        // devirtualization and finalization mutate the execute context, so they run serially around recording, pass
+        // functions only read the context while recording
+        for (auto* pass : passesToRecord) {
+            PreparePass(pass);
+        }
+
+        // contiguous groups of passes are recorded into command buffers submitted in order, so the order of commands is
+        // the same as a single command buffer
+        const auto passNum = passesToRecord.size();
+        const auto groupNum = inParallel ? std::clamp<size_t>(passNum, 1, Internal::rgMaxParallelRecordingGroupNum) : 1;
+        outCmdBuffers.reserve(groupNum);
+        for (auto i = 0; i < groupNum; i++) {
+            outCmdBuffers.emplace_back(RGCommandPool::Get(device).AllocateCommandBuffer(inQueueType));
+        }
+
+        const auto recordGroup = [&](size_t inGroupIndex) -> void {
+            const auto passBegin = passNum * inGroupIndex / groupNum;
+            const auto passEnd = passNum * (inGroupIndex + 1) / groupNum;
+            const auto commandRecorder = outCmdBuffers[inGroupIndex]->Begin();
+            for (auto i = passBegin; i < passEnd; i++) {
+                RecordPass(*commandRecorder, passesToRecord[i]);
             }
+            commandRecorder->End();
+        };
+        if (groupNum > 1) {
+            RenderWorkerThreads::Get().ExecuteTasks(groupNum, [&](size_t inGroupIndex) -> void {
+                Core::ScopedThreadTag threadTag(Core::ThreadTag::renderWorker);
+                recordGroup(inGroupIndex);
+            });
+        } else {
+            recordGroup(0);
+        }
+
+        for (auto* pass : passesToRecord) {
+            FinalizePass(pass);
+        }
+    }
+
+    void RGBuilder::PreparePass(RGPassRef inPass)
+    {
+        DevirtualizeResources(compiledGraph->passWrites[inPass->index]);
+        if (inPass->type == RGPassType::copy) {
+            return;
+        }
+        if (inPass->type == RGPassType::compute) {
+            DevirtualizeBindGroupsAndViews(static_cast<RGComputePass*>(inPass)->bindGroups);
+        } else if (inPass->type == RGPassType::raster) {
+            auto* rasterPass = static_cast<RGRasterPass*>(inPass);
+            DevirtualizeAttachmentViews(rasterPass->passDesc);
+            DevirtualizeBindGroupsAndViews(rasterPass->bindGroups);
+        } else {
+            Unimplement();
+        }
+    }
+
+    void RGBuilder::RecordPass(RHI::CommandRecorder& inRecoder, RGPassRef inPass) const
+    {
+        if (inPass->type == RGPassType::copy) {
+            RecordCopyPass(inRecoder, static_cast<RGCopyPass*>(inPass));
+        } else if (inPass->type == RGPassType::compute) {
+            RecordComputePass(inRecoder, static_cast<RGComputePass*>(inPass));
+        } else if (inPass->type == RGPassType::raster) {
+            RecordRasterPass(inRecoder, static_cast<RGRasterPass*>(inPass));
+        } else {
+            Unimplement();
+        }
+    }
+
+    void RGBuilder::FinalizePass(RGPassRef inPass)
+    {
+        FinalizePassResources(compiledGraph->passReads[inPass->index]);
+        if (inPass->type == RGPassType::copy) {
+            return;
+        }
+        if (inPass->type == RGPassType::compute) {
+            FinalizePassBindGroups(static_cast<RGComputePass*>(inPass)->bindGroups);
+        } else if (inPass->type == RGPassType::raster) {
+            FinalizePassBindGroups(static_cast<RGRasterPass*>(inPass)->bindGroups);
+        } else {
+            Unimplement();
+        }
+    }
+
+    void RGBuilder::RecordCopyPass(RHI::CommandRecorder& inRecoder, RGCopyPass* inCopyPass) const
+    {
+        TransitionResourcesForPass(inRecoder, inCopyPass);
+        if (inCopyPass->prePassFunc) {
+            inCopyPass->prePassFunc(*this, inRecoder);
+        }
+        {
+            const auto copyPassRecoder = inRecoder.BeginCopyPass();
+            inCopyPass->passFunc(*this, *copyPassRecoder);
+            copyPassRecoder->EndPass();
+        }
+        if (inCopyPass->postPassFunc) {
+            inCopyPass->postPassFunc(*this, inRecoder);
+        }
+    }
+
+    void RGBuilder::RecordComputePass(RHI::CommandRecorder& inRecoder, RGComputePass* inComputePass) const
+    {
+        TransitionResourcesForPass(inRecoder, inComputePass);
+        if (inComputePass->prePassFunc) {
+            inComputePass->prePassFunc(*this, inRecoder);
+        }
+        {
+            const auto computePassRecoder = inRecoder.BeginComputePass();
+            inComputePass->passFunc(*this, *computePassRecoder);
+            computePassRecoder->EndPass();
+        }
+        if (inComputePass->postPassFunc) {
+            inComputePass->postPassFunc(*this, inRecoder);
+        }
+    }
+
+    void RGBuilder::RecordRasterPass(RHI::CommandRecorder& inRecoder, RGRasterPass* inRasterPass) const
+    {
+        TransitionResourcesForPass(inRecoder, inRasterPass);
+        if (inRasterPass->prePassFunc) {
+            inRasterPass->prePassFunc(*this, inRecoder);
+        }
+        {
+            const auto rasterPassRecoder = inRecoder.BeginRasterPass(Internal::GetRHIRasterPassBeginInfo(*this, inRasterPass->passDesc));
+            inRasterPass->passFunc(*this, *rasterPassRecoder);
+            rasterPassRecoder->EndPass();
+        }
+        if (inRasterPass->postPassFunc) {
+            inRasterPass->postPassFunc(*this, inRecoder);
         }
-        FinalizePassResources(passReadsMap.at(inRasterPass));
-        FinalizePassBindGroups(inRasterPass->bindGroups);
     }
 
     void RGBuilder::PerformBufferUploads()
@@ -890,24 +1574,35 @@ namespace Render {
     void RGBuilder::DevirtualizeResource(RGResourceRef inResource)
     {
         if (inResource->imported
-            || culledResources.contains(inResource)
+            || IsCulled(inResource)
             || devirtualizedResources.contains(inResource)) {
             return;
         }
 
+        // pooled object of an alias slot is kept by the slot until the graph is destroyed, so it is never handed to another
+        // resource by the pool while a queue of the graph may still access it
+        auto& aliasSlot = aliasSlots.at(compiledGraph->resourceAliasSlots[inResource->index]);
         if (inResource->type == RGResType::buffer) {
-            devirtualizedResources.emplace(std::make_pair(inResource, BufferPool::Get(device).Allocate(static_cast<RGBufferRef>(inResource)->desc)));
+            auto& pooledBuffer = std::get<PooledBufferRef>(aliasSlot);
+            if (pooledBuffer == nullptr) {
+                pooledBuffer = BufferPool::Get(device).Allocate(static_cast<RGBufferRef>(inResource)->desc);
+            }
+            devirtualizedResources.emplace(std::make_pair(inResource, pooledBuffer));
         } else if (inResource->type == RGResType::texture) {
-            devirtualizedResources.emplace(std::make_pair(inResource, TexturePool::Get(device).Allocate(static_cast<RGTextureRef>(inResource)->desc)));
+            auto& pooledTexture = std::get<PooledTextureRef>(aliasSlot);
+            if (pooledTexture == nullptr) {
+                pooledTexture = TexturePool::Get(device).Allocate(static_cast<RGTextureRef>(inResource)->desc);
+            }
+            devirtualizedResources.emplace(std::make_pair(inResource, pooledTexture));
         } else {
             Unimplement();
         }
     }
 
-    void RGBuilder::DevirtualizeResources(const std::unordered_set<RGResourceRef>& inResources)
+    void RGBuilder::DevirtualizeResources(const std::vector<uint32_t>& inResources)
     {
-        for (auto* resource : inResources) {
-            DevirtualizeResource(resource);
+        for (const auto resource : inResources) {
+            DevirtualizeResource(resources[resource].Get());
         }
     }
 
@@ -959,11 +1654,12 @@ namespace Render {
         }
     }
 
-    void RGBuilder::FinalizePassResources(const std::unordered_set<RGResourceRef>& inResources)
+    void RGBuilder::FinalizePassResources(const std::vector<uint32_t>& inResources)
     {
-        for (auto* resource : inResources) {
-            if (auto& readCount = resourceReadCounts.at(resource);
+        for (const auto index : inResources) {
+            if (auto& readCount = resourceReadCounts[index];
                 --readCount == 0) {
+                auto* resource = resources[index].Get();
                 if (resource->type == RGResType::buffer) {
                     ResourceViewCache::Get(device).Invalidate(std::get<PooledBufferRef>(devirtualizedResources.at(resource))->GetRHI());
                 } else if (resource->type == RGResType::texture) {
@@ -983,77 +1679,17 @@ namespace Render {
         }
     }
 
-    void RGBuilder::TransitionResourcesForCopyPassDesc(RHI::CommandCommandRecorder& inRecoder, const RGCopyPassDesc& inDesc)
+    void RGBuilder::TransitionResourcesForPass(RHI::CommandCommandRecorder& inRecoder, RGPassRef inPass) const
     {
-        for (auto* copySrc : inDesc.copySrcs) {
-            if (copySrc->type == RGResType::buffer) {
-                TransitionBuffer(inRecoder, static_cast<RGBufferRef>(copySrc), RHI::BufferState::copySrc);
-            } else if (copySrc->type == RGResType::texture) {
-                TransitionTexture(inRecoder, static_cast<RGTextureRef>(copySrc), RHI::TextureState::copySrc);
-            } else {
-                Unimplement();
-            }
-        }
-        for (auto* copyDst : inDesc.copyDsts) {
-            if (copyDst->type == RGResType::buffer) {
-                TransitionBuffer(inRecoder, static_cast<RGBufferRef>(copyDst), RHI::BufferState::copyDst);
-            } else if (copyDst->type == RGResType::texture) {
-                TransitionTexture(inRecoder, static_cast<RGTextureRef>(copyDst), RHI::TextureState::copyDst);
+        for (const auto& [resource, before, after] : compiledGraph->passTransitions[inPass->index]) {
+            if (auto* resourceRef = resources[resource].Get();
+                resourceRef->type == RGResType::buffer) {
+                inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(static_cast<RGBufferRef>(resourceRef)), std::get<RHI::BufferState>(before), std::get<RHI::BufferState>(after)));
+            } else if (resourceRef->type == RGResType::texture) {
+                inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(static_cast<RGTextureRef>(resourceRef)), std::get<RHI::TextureState>(before), std::get<RHI::TextureState>(after)));
             } else {
                 Unimplement();
             }
         }
     }
-
-    void RGBuilder::TransitionResourcesForRasterPassDesc(RHI::CommandCommandRecorder& inRecoder, const RGRasterPassDesc& inDesc)
-    {
-        if (inDesc.depthStencilAttachment.has_value()) {
-            const auto& dsa = inDesc.depthStencilAttachment.value();
-            TransitionTexture(inRecoder, dsa.view->GetTexture(), dsa.depthReadOnly ? RHI::TextureState::depthStencilReadonly : RHI::TextureState::depthStencilWrite);
-        }
-        for (const auto& ca : inDesc.colorAttachments) {
-            TransitionTexture(inRecoder, ca.view->GetTexture(), RHI::TextureState::renderTarget);
-        }
-    }
-
-    void RGBuilder::TransitionResourcesForBindGroups(RHI::CommandCommandRecorder& inRecoder, const std::vector<RGBindGroupRef>& inBindGroups)
-    {
-        for (auto* bindGroup : inBindGroups) {
-            for (const auto& [type, view] : bindGroup->desc.items | std::views::values) {
-                if (type == RHI::BindingType::uniformBuffer) {
-                    TransitionBuffer(inRecoder, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::shaderReadOnly);
-                } else if (type == RHI::BindingType::storageBuffer) {
-                    TransitionBuffer(inRecoder, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::storage);
-                } else if (type == RHI::BindingType::rwStorageBuffer) {
-                    TransitionBuffer(inRecoder, std::get<RGBufferViewRef>(view)->GetBuffer(), RHI::BufferState::rwStorage);
-                } else if (type == RHI::BindingType::texture) {
-                    TransitionTexture(inRecoder, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::shaderReadOnly);
-                } else if (type == RHI::BindingType::storageTexture) {
-                    TransitionTexture(inRecoder, std::get<RGTextureViewRef>(view)->GetTexture(), RHI::TextureState::storage);
-                } else if (type == RHI::BindingType::sampler) {} else {
-                    Unimplement();
-                }
-            }
-        }
-    }
-
-    void RGBuilder::TransitionBuffer(RHI::CommandCommandRecorder& inRecoder, RGBufferRef inBuffer, RHI::BufferState inState)
-    {
-        auto& currentState = std::get<RHI::BufferState>(resourceStates.at(inBuffer));
-        if (currentState == inState) {
-            return;
-        }
-        inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(inBuffer), currentState, inState));
-        currentState = inState;
-    }
-
-    void RGBuilder::TransitionTexture(RHI::CommandCommandRecorder& inRecoder, RGTextureRef inTexture, RHI::TextureState inState)
-    {
-        auto& currentState = std::get<RHI::TextureState>(resourceStates.at(inTexture));
-        if (currentState == inState) {
-            return;
-        }
-        inRecoder.ResourceBarrier(RHI::Barrier::Transition(GetRHI(inTexture), currentState, inState));
-        currentState = inState;
-    }
 }
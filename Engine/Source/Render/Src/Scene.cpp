@@ -5,7 +5,16 @@
 #include <Render/Scene.h>
 
 namespace Render {
-    Scene::Scene() = default;
+    Scene::Scene()
+        : appliedDeltasNum(0)
+    {
+    }
 
     Scene::~Scene() = default;
+
+    uint64_t Scene::GetAppliedDeltasNum() const
+    {
+        Assert(Core::ThreadContext::IsRenderThread());
+        return appliedDeltasNum;
+    }
 }
@@ -3,9 +3,13 @@
 //
 
 #include <unordered_map>
+#include <unordered_set>
 #include <tuple>
 #include <utility>
 #include <format>
+#include <filesystem>
+#include <thread>
+#include <algorithm>
 
 #if PLATFORM_WINDOWS
 #include <windows.h>
@@ -28,9 +32,16 @@ using namespace Microsoft::WRL;
 #include <spirv_cross/spirv_cross.hpp>
 #include <spirv_cross/spirv_msl.hpp>
 
+// defined by build system from the spirv-cross package version
+#ifndef SPIRV_CROSS_VERSION
+#define SPIRV_CROSS_VERSION "unknown"
+#endif
+
 #include <Render/ShaderCompiler.h>
 #include <Common/Debug.h>
 #include <Common/String.h>
+#include <Common/Serialization.h>
+#include <Core/Paths.h>
 
 namespace Render {
 #if PLATFORM_WINDOWS
@@ -320,19 +331,330 @@ namespace Render {
     }
 }
 
+namespace Render {
+    // bump when the compile pipeline or the cache file layout changes, so stale entries are never read
+    static constexpr uint32_t shaderByteCodeCacheVersion = 1;
+
+    // quoted includes are searched in the directory of the including file first like dxc does, the root source has no
+    // file, so its directory is the working directory
+    static void HashIncludes(const std::string& inSource, const Common::Path& inSourceDir, const std::vector<std::string>& inIncludePaths, std::unordered_set<std::string>& ioVisited, std::vector<uint64_t>& outHashes)
+    {
+        size_t lineBegin = 0;
+        while (lineBegin < inSource.size()) {
+            size_t lineEnd = inSource.find('\n', lineBegin);
+            lineEnd = lineEnd == std::string::npos ? inSource.size() : lineEnd;
+            const std::string_view line(inSource.data() + lineBegin, lineEnd - lineBegin);
+            lineBegin = lineEnd + 1;
+
+            const auto directiveBegin = line.find_first_not_of(" \t");
+            if (directiveBegin == std::string_view::npos || !line.substr(directiveBegin).starts_with("#include")) {
+                continue;
+            }
+            const auto nameBegin = line.find_first_of("\"<", directiveBegin);
+            const auto nameEnd = nameBegin == std::string_view::npos ? std::string_view::npos : line.find_first_of("\">", nameBegin + 1);
+            if (nameEnd == std::string_view::npos) {
+                continue;
+            }
+
+            const std::string name(line.substr(nameBegin + 1, nameEnd - nameBegin - 1));
+            outHashes.emplace_back(Common::HashUtils::CityHash(name.data(), name.size()));
+
+            std::vector<Common::Path> searchDirs;
+            searchDirs.reserve(inIncludePaths.size() + 1);
+            if (line[nameBegin] == '"') {
+                searchDirs.emplace_back(inSourceDir);
+            }
+            for (const auto& includePath : inIncludePaths) {
+                searchDirs.emplace_back(includePath);
+            }
+
+            for (const auto& searchDir : searchDirs) {
+                const auto includeFile = searchDir.Empty() ? Common::Path(name) : searchDir / name;
+                if (!includeFile.Exists()) {
+                    continue;
+                }
+                if (const auto includeFileString = includeFile.Absolute().String();
+                    ioVisited.emplace(includeFileString).second) {
+                    const auto includeSource = Common::FileUtils::ReadTextFile(includeFileString);
+                    outHashes.emplace_back(Common::HashUtils::CityHash(includeSource.data(), includeSource.size()));
+                    HashIncludes(includeSource, includeFile.Parent(), inIncludePaths, ioVisited, outHashes);
+                }
+                break;
+            }
+        }
+    }
+
+    // a compiler update may change the output for the same source, so compiler versions are part of the cache key
+    static uint64_t GetCompilerVersionHash()
+    {
+        static const uint64_t versionHash = []() -> uint64_t {
+            std::vector<uint64_t> values;
+
+            ComPtr<IDxcCompiler3> compiler;
+            Assert(SUCCEEDED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&compiler))));
+            ComPtr<IDxcVersionInfo> versionInfo;
+            if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&versionInfo)))) {
+                uint32_t major = 0;
+                uint32_t minor = 0;
+                Assert(SUCCEEDED(versionInfo->GetVersion(&major, &minor)));
+                values.emplace_back(static_cast<uint64_t>(major) << 32 | minor);
+            }
+            ComPtr<IDxcVersionInfo2> versionInfo2;
+            if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&versionInfo2)))) {
+                uint32_t commitCount = 0;
+                char* commitHash = nullptr;
+                Assert(SUCCEEDED(versionInfo2->GetCommitInfo(&commitCount, &commitHash)));
+                values.emplace_back(commitCount);
+                if (commitHash != nullptr) {
+                    values.emplace_back(Common::HashUtils::CityHash(commitHash, std::strlen(commitHash)));
+                    CoTaskMemFree(commitHash);
+                }
+            }
+
+            const std::string spirvCrossVersion = SPIRV_CROSS_VERSION;
+            values.emplace_back(Common::HashUtils::CityHash(spirvCrossVersion.data(), spirvCrossVersion.size()));
+            return Common::HashUtils::CityHash(values.data(), values.size() * sizeof(uint64_t));
+        }();
+        return versionHash;
+    }
+
+    static void SerializeReflectionData(Common::BinarySerializeStream& inStream, const ShaderReflectionData& inReflectionData)
+    {
+        inStream.Write<uint64_t>(inReflectionData.vertexBindings.size());
+        for (const auto& [semantic, platformBinding] : inReflectionData.vertexBindings) {
+            Common::Serializer<std::string>::Serialize(inStream, semantic);
+            inStream.Write<uint8_t>(static_cast<uint8_t>(platformBinding.index()));
+            if (const auto* hlslBinding = std::get_if<RHI::HlslVertexBinding>(&platformBinding)) {
+                Common::Serializer<std::string>::Serialize(inStream, hlslBinding->semanticName);
+                inStream.Write<uint8_t>(hlslBinding->semanticIndex);
+            } else {
+                inStream.Write<uint8_t>(std::get<RHI::GlslVertexBinding>(platformBinding).location);
+            }
+        }
+
+        inStream.Write<uint64_t>(inReflectionData.resourceBindings.size());
+        for (const auto& [name, layoutAndBinding] : inReflectionData.resourceBindings) {
+            const auto& [layoutIndex, binding] = layoutAndBinding;
+            Common::Serializer<std::string>::Serialize(inStream, name);
+            inStream.Write<uint8_t>(layoutIndex);
+            inStream.Write<uint8_t>(static_cast<uint8_t>(binding.type));
+            inStream.Write<uint8_t>(static_cast<uint8_t>(binding.platformBinding.index()));
+            if (const auto* hlslBinding = std::get_if<RHI::HlslBinding>(&binding.platformBinding)) {
+                inStream.Write<uint8_t>(static_cast<uint8_t>(hlslBinding->rangeType));
+                inStream.Write<uint8_t>(hlslBinding->index);
+            } else {
+                inStream.Write<uint8_t>(std::get<RHI::GlslBinding>(binding.platformBinding).index);
+            }
+        }
+    }
+
+    static void DeserializeReflectionData(Common::BinaryDeserializeStream& inStream, ShaderReflectionData& outReflectionData)
+    {
+        uint64_t vertexBindingNum;
+        inStream.Read<uint64_t>(vertexBindingNum);
+        for (auto i = 0; i < vertexBindingNum; i++) {
+            std::string semantic;
+            uint8_t platformIndex;
+            Common::Serializer<std::string>::Deserialize(inStream, semantic);
+            inStream.Read<uint8_t>(platformIndex);
+            if (platformIndex == 0) {
+                RHI::HlslVertexBinding hlslBinding;
+                Common::Serializer<std::string>::Deserialize(inStream, hlslBinding.semanticName);
+                inStream.Read<uint8_t>(hlslBinding.semanticIndex);
+                outReflectionData.vertexBindings.emplace(std::move(semantic), hlslBinding);
+            } else {
+                RHI::GlslVertexBinding glslBinding;
+                inStream.Read<uint8_t>(glslBinding.location);
+                outReflectionData.vertexBindings.emplace(std::move(semantic), glslBinding);
+            }
+        }
+
+        uint64_t resourceBindingNum;
+        inStream.Read<uint64_t>(resourceBindingNum);
+        for (auto i = 0; i < resourceBindingNum; i++) {
+            std::string name;
+            uint8_t layoutIndex;
+            uint8_t bindingType;
+            uint8_t platformIndex;
+            Common::Serializer<std::string>::Deserialize(inStream, name);
+            inStream.Read<uint8_t>(layoutIndex);
+            inStream.Read<uint8_t>(bindingType);
+            inStream.Read<uint8_t>(platformIndex);
+
+            std::variant<RHI::HlslBinding, RHI::GlslBinding> platformBinding = RHI::GlslBinding(0);
+            if (platformIndex == 0) {
+                uint8_t rangeType;
+                uint8_t index;
+                inStream.Read<uint8_t>(rangeType);
+                inStream.Read<uint8_t>(index);
+                platformBinding = RHI::HlslBinding(static_cast<RHI::HlslBindingRangeType>(rangeType), index);
+            } else {
+                uint8_t index;
+                inStream.Read<uint8_t>(index);
+                platformBinding = RHI::GlslBinding(index);
+            }
+            outReflectionData.resourceBindings.emplace(std::move(name), std::make_pair(layoutIndex, RHI::ResourceBinding(static_cast<RHI::BindingType>(bindingType), platformBinding)));
+        }
+    }
+}
+
 namespace Render {
     size_t ShaderTypeAndVariantHashProvider::operator()(const std::pair<ShaderTypeKey, VariantKey>& value) const
     {
         return Common::HashUtils::CityHash(&value, sizeof(std::pair<ShaderTypeKey, VariantKey>));
     }
 
+    ShaderByteCodeCacheStats::ShaderByteCodeCacheStats()
+        : hitNum(0)
+        , missNum(0)
+    {
+    }
+
+    ShaderByteCodeCache& ShaderByteCodeCache::Get()
+    {
+        static ShaderByteCodeCache instance;
+        return instance;
+    }
+
+    ShaderByteCodeCache::ShaderByteCodeCache()
+        : directory(Core::Paths::EngineCacheDir() / "Shader")
+        , hitNum(0)
+        , missNum(0)
+    {
+    }
+
+    ShaderByteCodeCache::~ShaderByteCodeCache() = default;
+
+    void ShaderByteCodeCache::SetDirectory(const Common::Path& inDirectory)
+    {
+        std::unique_lock lock(mutex);
+        directory = inDirectory;
+    }
+
+    Common::Path ShaderByteCodeCache::GetDirectory() const
+    {
+        std::unique_lock lock(mutex);
+        return directory;
+    }
+
+    uint64_t ShaderByteCodeCache::ComputeKey(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions) const // NOLINT
+    {
+        std::vector<uint64_t> values = {
+            shaderByteCodeCacheVersion,
+            GetCompilerVersionHash(),
+            Common::HashUtils::CityHash(inInput.source.data(), inInput.source.size()),
+            Common::HashUtils::CityHash(inInput.entryPoint.data(), inInput.entryPoint.size()),
+            static_cast<uint64_t>(inInput.stage),
+            static_cast<uint64_t>(inOptions.byteCodeType),
+            static_cast<uint64_t>(inOptions.withDebugInfo)
+        };
+        for (const auto& definition : inInput.definitions) {
+            values.emplace_back(Common::HashUtils::CityHash(definition.data(), definition.size()));
+        }
+        values.emplace_back(inInput.definitions.size());
+        for (const auto& includePath : inOptions.includePaths) {
+            values.emplace_back(Common::HashUtils::CityHash(includePath.data(), includePath.size()));
+        }
+        values.emplace_back(inOptions.includePaths.size());
+
+        std::unordered_set<std::string> visitedIncludes;
+        HashIncludes(inInput.source, Common::Path(), inOptions.includePaths, visitedIncludes, values);
+        return Common::HashUtils::CityHash(values.data(), values.size() * sizeof(uint64_t));
+    }
+
+    bool ShaderByteCodeCache::Load(uint64_t inKey, ShaderCompileOutput& outOutput)
+    {
+        const auto filePath = GetFilePath(inKey);
+        if (filePath.Empty() || !filePath.Exists()) {
+            missNum++;
+            return false;
+        }
+
+        constexpr size_t headerSize = sizeof(uint32_t) + sizeof(uint64_t) * 2;
+        std::error_code errorCode;
+        const auto fileSize = std::filesystem::file_size(filePath.String(), errorCode);
+        if (errorCode || fileSize < headerSize) {
+            missNum++;
+            return false;
+        }
+
+        Common::BinaryFileDeserializeStream stream(filePath.String());
+        uint32_t version;
+        uint64_t key;
+        uint64_t contentSize;
+        stream.Read<uint32_t>(version);
+        stream.Read<uint64_t>(key);
+        stream.Read<uint64_t>(contentSize);
+        if (version != shaderByteCodeCacheVersion || key != inKey || headerSize + contentSize != fileSize) {
+            missNum++;
+            return false;
+        }
+
+        outOutput.success = true;
+        outOutput.errorInfo.clear();
+        outOutput.reflectionData = ShaderReflectionData();
+        Common::Serializer<std::vector<uint8_t>>::Deserialize(stream, outOutput.byteCode);
+        DeserializeReflectionData(stream, outOutput.reflectionData);
+        hitNum++;
+        return true;
+    }
+
+    void ShaderByteCodeCache::Save(uint64_t inKey, const ShaderCompileOutput& inOutput) const
+    {
+        Assert(inOutput.success);
+        const auto filePath = GetFilePath(inKey);
+        if (filePath.Empty()) {
+            return;
+        }
+
+        std::vector<uint8_t> content;
+        {
+            Common::MemorySerializeStream stream(content);
+            Common::Serializer<std::vector<uint8_t>>::Serialize(stream, inOutput.byteCode);
+            SerializeReflectionData(stream, inOutput.reflectionData);
+        }
+
+        // written to a temporary file first, a reader in another thread or process never sees a partial entry
+        const auto tempFilePath = Common::Path(std::format("{}.{}.tmp", filePath.String(), std::hash<std::thread::id> {}(std::this_thread::get_id())));
+        {
+            Common::BinaryFileSerializeStream stream(tempFilePath.String());
+            stream.Write<uint32_t>(shaderByteCodeCacheVersion);
+            stream.Write<uint64_t>(inKey);
+            stream.Write<uint64_t>(content.size());
+            stream.WriteBulk(content.data(), content.size());
+        }
+        std::error_code errorCode;
+        std::filesystem::rename(tempFilePath.String(), filePath.String(), errorCode);
+        if (errorCode) {
+            std::filesystem::remove(tempFilePath.String(), errorCode);
+        }
+    }
+
+    ShaderByteCodeCacheStats ShaderByteCodeCache::GetStats() const
+    {
+        ShaderByteCodeCacheStats result;
+        result.hitNum = hitNum.load();
+        result.missNum = missNum.load();
+        return result;
+    }
+
+    Common::Path ShaderByteCodeCache::GetFilePath(uint64_t inKey) const
+    {
+        std::unique_lock lock(mutex);
+        if (directory.Empty()) {
+            return {};
+        }
+        return directory / std::format("{:016x}.bin", inKey);
+    }
+
     ShaderCompiler& ShaderCompiler::Get()
     {
         static ShaderCompiler instance;
         return instance;
     }
 
-    ShaderCompiler::ShaderCompiler() : threadPool("ShaderCompiler", 4)
+    ShaderCompiler::ShaderCompiler()
+        : threadPool("ShaderCompiler", static_cast<uint8_t>(std::clamp(std::thread::hardware_concurrency(), 1u, 255u)))
     {
     }
 
@@ -341,73 +663,100 @@ namespace Render {
     std::future<ShaderCompileOutput> ShaderCompiler::Compile(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions)
     {
         return threadPool.EmplaceTask([inInput, inOptions]() -> ShaderCompileOutput {
-            ShaderCompileOutput output;
-            CompileDxilOrSpriv(inInput, inOptions, output);
-            return output;
+            return CompileOrLoadCached(inInput, inOptions);
         });
     }
 
+    ShaderCompileOutput ShaderCompiler::CompileOrLoadCached(const ShaderCompileInput& inInput, const ShaderCompileOptions& inOptions)
+    {
+        auto& cache = ShaderByteCodeCache::Get();
+        const auto key = cache.ComputeKey(inInput, inOptions);
+
+        ShaderCompileOutput output;
+        if (cache.Load(key, output)) {
+            return output;
+        }
+        CompileDxilOrSpriv(inInput, inOptions, output);
+        if (output.success) {
+            cache.Save(key, output);
+        }
+        return output;
+    }
+
     ShaderTypeCompiler& ShaderTypeCompiler::Get()
     {
         static ShaderTypeCompiler instance;
         return instance;
     }
 
-    ShaderTypeCompiler::ShaderTypeCompiler()
-        : threadPool("ShaderTypeCompiler", 4)
-    {
-    }
+    ShaderTypeCompiler::ShaderTypeCompiler() = default;
 
     ShaderTypeCompiler::~ShaderTypeCompiler() = default;
 
     std::future<ShaderTypeCompileResult> ShaderTypeCompiler::Compile(const std::vector<IShaderType*>& inShaderTypes, const ShaderCompileOptions& inOptions)
     {
-        return threadPool.EmplaceTask([inShaderTypes, inOptions]() -> ShaderTypeCompileResult {
-            std::unordered_map<ShaderTypeKey, std::unordered_map<VariantKey, std::future<ShaderCompileOutput>>> compileOutputs;
-            compileOutputs.reserve(inShaderTypes.size());
-            for (auto* shaderType : inShaderTypes) {
-                auto typeKey = shaderType->GetKey();
-                auto stage = shaderType->GetStage();
-                const auto& entryPoint = shaderType->GetEntryPoint();
-                const auto& code = shaderType->GetCode();
-
-                Assert(!compileOutputs.contains(typeKey));
-                compileOutputs.emplace(std::make_pair(typeKey, std::unordered_map<VariantKey, std::future<ShaderCompileOutput>> {}));
-                auto& variantCompileOutputs = compileOutputs.at(typeKey);
-
-                for ( const auto& variants = shaderType->GetVariants();
-                    const auto& variantKey : variants) {
-                    ShaderCompileInput input {};
-                    input.source = code;
-                    input.entryPoint = entryPoint;
-                    input.stage = stage;
-                    input.definitions = shaderType->GetDefinitions(variantKey);
-
-                    variantCompileOutputs.emplace(std::make_pair(variantKey, ShaderCompiler::Get().Compile(input, inOptions)));
-                }
+        // the last finished variant assembles the result, so no thread is blocked while variants are compiling
+        struct CompileContext {
+            std::mutex mutex;
+            std::atomic<size_t> pendingNum;
+            std::unordered_map<ShaderTypeKey, ShaderArchivePackage> archivePackages;
+            ShaderTypeCompileResult result;
+            std::promise<ShaderTypeCompileResult> promise;
+        };
+
+        const auto context = std::make_shared<CompileContext>();
+        context->result.success = true;
+        const auto finish = [](CompileContext& inContext) -> void {
+            for (auto& [typeKey, archivePackage] : inContext.archivePackages) {
+                ShaderArchiveStorage::Get().UpdateShaderArchivePackage(typeKey, std::move(archivePackage));
             }
+            inContext.result.success = inContext.result.errorInfos.empty();
+            inContext.promise.set_value(std::move(inContext.result));
+        };
 
-            ShaderTypeCompileResult result;
-            for (auto& [typeKey, variantCompileOutputs] : compileOutputs) {
-                ShaderArchivePackage archivePackage;
-
-                for (auto& [variantKey, compileFuture] : variantCompileOutputs) {
-                    ShaderCompileOutput output = compileFuture.get(); // NOLINT
-                    if (output.success) {
-                        ShaderArchive archive;
-                        archive.byteCode = std::move(output.byteCode);
-                        archive.reflectionData = std::move(output.reflectionData);
-
-                        archivePackage.emplace(std::make_pair(variantKey, std::move(archive)));
-                    } else {
-                        result.errorInfos.emplace(std::make_pair(std::make_pair(typeKey, variantKey), output.errorInfo));
+        size_t variantNum = 0;
+        for (auto* shaderType : inShaderTypes) {
+            const auto typeKey = shaderType->GetKey();
+            Assert(!context->archivePackages.contains(typeKey));
+            context->archivePackages.emplace(typeKey, ShaderArchivePackage {});
+            variantNum += shaderType->GetVariants().size();
+        }
+        context->pendingNum = variantNum;
+
+        auto resultFuture = context->promise.get_future();
+        if (variantNum == 0) {
+            finish(*context);
+            return resultFuture;
+        }
+
+        for (auto* shaderType : inShaderTypes) {
+            const auto typeKey = shaderType->GetKey();
+            for (const auto& variantKey : shaderType->GetVariants()) {
+                ShaderCompileInput input {};
+                input.source = shaderType->GetCode();
+                input.entryPoint = shaderType->GetEntryPoint();
+                input.stage = shaderType->GetStage();
+                input.definitions = shaderType->GetDefinitions(variantKey);
+
+                ShaderCompiler::Get().Compile(input, inOptions, [context, finish, typeKey, variantKey](ShaderCompileOutput&& inOutput) -> void {
+                    {
+                        std::unique_lock lock(context->mutex);
+                        if (inOutput.success) {
+                            ShaderArchive archive;
+                            archive.byteCode = std::move(inOutput.byteCode);
+                            archive.reflectionData = std::move(inOutput.reflectionData);
+                            context->archivePackages.at(typeKey).emplace(variantKey, std::move(archive));
+                        } else {
+                            context->result.errorInfos.emplace(std::make_pair(typeKey, variantKey), std::move(inOutput.errorInfo));
+                        }
                     }
-                }
-                ShaderArchiveStorage::Get().UpdateShaderArchivePackage(typeKey, std::move(archivePackage));
+                    if (context->pendingNum.fetch_sub(1) == 1) {
+                        finish(*context);
+                    }
+                });
             }
-            result.success = result.errorInfos.empty();
-            return result;
-        });
+        }
+        return resultFuture;
     }
 
     std::future<ShaderTypeCompileResult> ShaderTypeCompiler::CompileGlobalShaderTypes(const ShaderCompileOptions& inOptions)
@@ -0,0 +1,223 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <Test/Test.h>
+
+#include <Common/Serialization.h>
+#include <Core/Thread.h>
+#include <Render/RenderCache.h>
+#include <Render/RenderThread.h>
+
+using namespace Render;
+
+struct RenderCacheTest : testing::Test {
+    void SetUp() override
+    {
+        instance = RHI::Instance::GetByType(RHI::RHIType::dummy);
+
+        device = instance->GetGpu(0)->RequestDevice(
+            RHI::DeviceCreateInfo()
+                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1)));
+    }
+
+    void TearDown() override {}
+
+    RHI::Instance* instance;
+    Common::UniquePtr<RHI::Device> device;
+};
+
+TEST_F(RenderCacheTest, BindGroupCacheTest)
+{
+    const RHI::ResourceBinding binding0(RHI::BindingType::uniformBuffer, RHI::GlslBinding(0));
+    const RHI::ResourceBinding binding1(RHI::BindingType::uniformBuffer, RHI::GlslBinding(1));
+    const Common::UniquePtr<RHI::BindGroupLayout> layout = device->CreateBindGroupLayout(
+        RHI::BindGroupLayoutCreateInfo(0)
+            .AddEntry(RHI::BindGroupLayoutEntry(binding0, RHI::ShaderStageBits::sVertex))
+            .AddEntry(RHI::BindGroupLayoutEntry(binding1, RHI::ShaderStageBits::sVertex)));
+    const auto bufferCreateInfo = RHI::BufferCreateInfo()
+        .SetSize(256)
+        .SetUsages(RHI::BufferUsageBits::uniform)
+        .SetInitialState(RHI::BufferState::staging);
+    const Common::UniquePtr<RHI::Buffer> buffer0 = device->CreateBuffer(bufferCreateInfo);
+    const Common::UniquePtr<RHI::Buffer> buffer1 = device->CreateBuffer(bufferCreateInfo);
+    const auto viewCreateInfo = RHI::BufferViewCreateInfo(RHI::BufferViewType::uniformBinding, 256);
+
+    auto& resourceViewCache = ResourceViewCache::Get(*device);
+    auto& bindGroupCache = BindGroupCache::Get(*device);
+    bindGroupCache.Invalidate();
+    const auto stats = bindGroupCache.GetStats();
+
+    auto* view0 = resourceViewCache.GetOrCreate(buffer0.Get(), viewCreateInfo);
+    auto* view1 = resourceViewCache.GetOrCreate(buffer1.Get(), viewCreateInfo);
+    auto* bindGroup0 = bindGroupCache.Allocate(RHI::BindGroupCreateInfo(layout.Get())
+        .AddEntry(RHI::BindGroupEntry(binding0, view0))
+        .AddEntry(RHI::BindGroupEntry(binding1, view1)));
+    // same entries in another order hit the cached group
+    auto* bindGroup1 = bindGroupCache.Allocate(RHI::BindGroupCreateInfo(layout.Get())
+        .AddEntry(RHI::BindGroupEntry(binding1, view1))
+        .AddEntry(RHI::BindGroupEntry(binding0, view0)));
+    auto* bindGroup2 = bindGroupCache.Allocate(RHI::BindGroupCreateInfo(layout.Get())
+        .AddEntry(RHI::BindGroupEntry(binding0, view1))
+        .AddEntry(RHI::BindGroupEntry(binding1, view0)));
+    ASSERT_EQ(bindGroup0, bindGroup1);
+    ASSERT_NE(bindGroup0, bindGroup2);
+    ASSERT_EQ(bindGroupCache.Size(), 2);
+    ASSERT_EQ(bindGroupCache.GetStats().hitNum, stats.hitNum + 1);
+    ASSERT_EQ(bindGroupCache.GetStats().missNum, stats.missNum + 2);
+
+    // releasing the views of buffer0 destroys both groups referencing them
+    resourceViewCache.Invalidate(buffer0.Get());
+    for (auto i = 0; i < 3; i++) {
+        Core::ThreadContext::IncFrameNumber();
+    }
+    resourceViewCache.Forfeit();
+    ASSERT_EQ(bindGroupCache.Size(), 0);
+    ASSERT_EQ(bindGroupCache.GetStats().invalidatedNum, stats.invalidatedNum + 2);
+
+    resourceViewCache.Invalidate(buffer1.Get());
+    for (auto i = 0; i < 3; i++) {
+        Core::ThreadContext::IncFrameNumber();
+    }
+    resourceViewCache.Forfeit();
+}
+
+TEST_F(RenderCacheTest, BindGroupCacheInvalidateAllTest)
+{
+    const RHI::ResourceBinding binding0(RHI::BindingType::uniformBuffer, RHI::GlslBinding(0));
+    const Common::UniquePtr<RHI::BindGroupLayout> layout = device->CreateBindGroupLayout(
+        RHI::BindGroupLayoutCreateInfo(0)
+            .AddEntry(RHI::BindGroupLayoutEntry(binding0, RHI::ShaderStageBits::sVertex)));
+    const Common::UniquePtr<RHI::Buffer> buffer = device->CreateBuffer(RHI::BufferCreateInfo()
+        .SetSize(256)
+        .SetUsages(RHI::BufferUsageBits::uniform)
+        .SetInitialState(RHI::BufferState::staging));
+    const auto viewCreateInfo = RHI::BufferViewCreateInfo(RHI::BufferViewType::uniformBinding, 256);
+
+    auto& resourceViewCache = ResourceViewCache::Get(*device);
+    auto& bindGroupCache = BindGroupCache::Get(*device);
+    bindGroupCache.Invalidate();
+    const auto stats = bindGroupCache.GetStats();
+
+    auto* view = resourceViewCache.GetOrCreate(buffer.Get(), viewCreateInfo);
+    bindGroupCache.Allocate(RHI::BindGroupCreateInfo(layout.Get()).AddEntry(RHI::BindGroupEntry(binding0, view)));
+    ASSERT_EQ(bindGroupCache.Size(), 1);
+
+    // what render module does before releasing the device
+    bindGroupCache.Invalidate();
+    resourceViewCache.Invalidate();
+    ASSERT_EQ(bindGroupCache.Size(), 0);
+
+    view = resourceViewCache.GetOrCreate(buffer.Get(), viewCreateInfo);
+    bindGroupCache.Allocate(RHI::BindGroupCreateInfo(layout.Get()).AddEntry(RHI::BindGroupEntry(binding0, view)));
+    ASSERT_EQ(bindGroupCache.GetStats().missNum, stats.missNum + 2);
+    bindGroupCache.Invalidate();
+    resourceViewCache.Invalidate();
+}
+
+TEST_F(RenderCacheTest, PipelineCacheTest)
+{
+    RenderWorkerThreads::Get().Start();
+
+    const ShaderReflectionData reflectionData;
+    const Common::UniquePtr<RHI::ShaderModule> shaderModule = device->CreateShaderModule(RHI::ShaderModuleCreateInfo("main", nullptr, 0));
+    const auto makeDesc = [&](VariantKey inVariantKey) -> ComputePipelineStateDesc {
+        ComputePipelineStateDesc desc;
+        desc.shaders.computeShader = ShaderInstance { shaderModule.Get(), 1, inVariantKey, &reflectionData };
+        return desc;
+    };
+    const auto desc0 = makeDesc(0);
+    const auto desc1 = makeDesc(1);
+    const auto desc2 = makeDesc(2);
+
+    auto& pipelineCache = PipelineCache::Get(*device);
+    pipelineCache.Invalidate();
+    const auto stats = pipelineCache.GetStats();
+
+    // the sync variant waits for a pending compile instead of compiling twice
+    ASSERT_EQ(pipelineCache.GetOrCreateAsync(desc1), nullptr);
+    const auto* pipeline1 = pipelineCache.GetOrCreate(desc1);
+    ASSERT_NE(pipeline1, nullptr);
+    ASSERT_NE(pipeline1->GetRHI(), nullptr);
+
+    const ComputePipelineState* pipeline2 = nullptr;
+    while (pipeline2 == nullptr) {
+        pipeline2 = pipelineCache.GetOrCreateAsync(desc2);
+    }
+    ASSERT_NE(pipeline2->GetRHI(), nullptr);
+    ASSERT_EQ(pipelineCache.GetOrCreateAsync(desc2), pipeline2);
+    ASSERT_NE(pipelineCache.GetOrCreate(desc0), nullptr);
+
+    ASSERT_EQ(pipelineCache.GetStats().asyncCompiledNum, stats.asyncCompiledNum + 2);
+    ASSERT_EQ(pipelineCache.GetStats().syncCompiledNum, stats.syncCompiledNum + 1);
+
+    pipelineCache.Invalidate();
+    RenderWorkerThreads::Get().Stop();
+}
+
+TEST_F(RenderCacheTest, PrecacheListTest)
+{
+    static Common::Path fileName = "../Test/Generated/Render/RenderCacheTest.PrecacheListTest.bin";
+    RenderWorkerThreads::Get().Start();
+
+    const ShaderReflectionData reflectionData;
+    const Common::UniquePtr<RHI::ShaderModule> shaderModule = device->CreateShaderModule(RHI::ShaderModuleCreateInfo("main", nullptr, 0));
+    const auto makeDesc = [&](VariantKey inVariantKey) -> ComputePipelineStateDesc {
+        ComputePipelineStateDesc desc;
+        desc.shaders.computeShader = ShaderInstance { shaderModule.Get(), 2, inVariantKey, &reflectionData };
+        return desc;
+    };
+    const auto desc0 = makeDesc(0);
+    const auto desc1 = makeDesc(1);
+    const auto desc2 = makeDesc(2);
+
+    // the last run uses desc0 and desc1, its list is saved the same way as PrecacheList.bin
+    auto& pipelineCache = PipelineCache::Get(*device);
+    pipelineCache.Invalidate();
+    ASSERT_NE(pipelineCache.GetOrCreate(desc0), nullptr);
+    ASSERT_NE(pipelineCache.GetOrCreate(desc1), nullptr);
+    const auto savedList = pipelineCache.GetPrecacheList();
+    ASSERT_NE(std::ranges::find(savedList, desc0.Hash()), savedList.end());
+    ASSERT_NE(std::ranges::find(savedList, desc1.Hash()), savedList.end());
+    ASSERT_EQ(std::ranges::find(savedList, desc2.Hash()), savedList.end());
+    {
+        Common::BinaryFileSerializeStream stream(fileName.String());
+        Common::Serialize(stream, savedList);
+    }
+
+    // the next run loads the list and the renderer supplies all its candidate descs, only recorded ones are compiled
+    pipelineCache.Invalidate();
+    std::vector<uint64_t> loadedList;
+    {
+        Common::BinaryFileDeserializeStream stream(fileName.String());
+        ASSERT_TRUE(Common::Deserialize(stream, loadedList).first);
+    }
+    ASSERT_EQ(loadedList, savedList);
+    pipelineCache.SetPrecacheList(loadedList);
+
+    const auto stats = pipelineCache.GetStats();
+    ASSERT_TRUE(pipelineCache.Precache(desc0));
+    ASSERT_TRUE(pipelineCache.Precache(desc1));
+    ASSERT_FALSE(pipelineCache.Precache(desc2));
+    ASSERT_FALSE(pipelineCache.Precache(desc0));
+    pipelineCache.WaitPendingCompiles();
+    ASSERT_EQ(pipelineCache.GetStats().precachedNum, stats.precachedNum + 2);
+
+    // precached pipelines are ready on the first async request
+    ASSERT_NE(pipelineCache.GetOrCreateAsync(desc0), nullptr);
+    ASSERT_NE(pipelineCache.GetOrCreateAsync(desc1), nullptr);
+    ASSERT_EQ(pipelineCache.GetStats().asyncCompiledNum, stats.asyncCompiledNum);
+
+    pipelineCache.Invalidate();
+    RenderWorkerThreads::Get().Stop();
+}
+
+TEST_F(RenderCacheTest, PipelineCacheDataTest)
+{
+    const std::vector<uint8_t> data = { 1, 2, 3, 4 };
+    const Common::UniquePtr<RHI::Device> cachedDevice = instance->GetGpu(0)->RequestDevice(
+        RHI::DeviceCreateInfo()
+            .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1))
+            .SetPipelineCacheData(data));
+    ASSERT_EQ(cachedDevice->GetPipelineCacheData(), data);
+}
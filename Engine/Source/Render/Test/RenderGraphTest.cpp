@@ -0,0 +1,325 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <Test/Test.h>
+
+#include <Render/RenderGraph.h>
+#include <Render/RenderThread.h>
+
+using namespace Render;
+
+struct RenderGraphTest : testing::Test {
+    void SetUp() override
+    {
+        instance = RHI::Instance::GetByType(RHI::RHIType::dummy);
+
+        device = instance->GetGpu(0)->RequestDevice(
+            RHI::DeviceCreateInfo()
+                .AddQueueRequest(RHI::QueueRequestInfo(RHI::QueueType::graphics, 1)));
+    }
+
+    void TearDown() override {}
+
+    RHI::Instance* instance;
+    Common::UniquePtr<RHI::Device> device;
+};
+
+TEST_F(RenderGraphTest, TransientAliasingTest)
+{
+    const auto textureDesc = RGTextureDesc()
+        .SetDimension(RHI::TextureDimension::t2D)
+        .SetWidth(256)
+        .SetHeight(256)
+        .SetDepthOrArraySize(1)
+        .SetFormat(RHI::PixelFormat::rgba8Unorm)
+        .SetUsages(RHI::TextureUsageBits::copySrc | RHI::TextureUsageBits::copyDst)
+        .SetMipLevels(1)
+        .SetSamples(1)
+        .SetInitialState(RHI::TextureState::undefined);
+    const auto largeTextureDesc = RGTextureDesc(textureDesc)
+        .SetWidth(512);
+    const Common::UniquePtr<RHI::Texture> output = device->CreateTexture(textureDesc);
+
+    RHI::Texture* rhiTexture0 = nullptr;
+    RHI::Texture* rhiTexture2 = nullptr;
+    {
+        RGBuilder builder(*device);
+        auto* texture0 = builder.CreateTexture(textureDesc);
+        auto* texture1 = builder.CreateTexture(textureDesc);
+        auto* texture2 = builder.CreateTexture(textureDesc);
+        auto* largeTexture = builder.CreateTexture(largeTextureDesc);
+        auto* outputTexture = builder.ImportTexture(output.Get(), RHI::TextureState::undefined);
+
+        builder.AddCopyPass("Pass0", RGCopyPassDesc { {}, { texture0 } }, [&](const RGBuilder& rg, RHI::CopyPassCommandRecorder&) -> void {
+            rhiTexture0 = rg.GetRHI(texture0);
+        });
+        builder.AddCopyPass("Pass1", RGCopyPassDesc { { texture0 }, { texture1 } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+        builder.AddCopyPass("Pass2", RGCopyPassDesc { { texture1 }, { texture2, largeTexture } }, [&](const RGBuilder& rg, RHI::CopyPassCommandRecorder&) -> void {
+            rhiTexture2 = rg.GetRHI(texture2);
+        });
+        builder.AddCopyPass("Pass3", RGCopyPassDesc { { texture2, largeTexture }, { outputTexture } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+        builder.Execute(RGExecuteInfo {});
+
+        // texture0 [0, 1] and texture2 [2, 3] have the same desc and disjoint lifetimes, texture1 [1, 2] overlaps both,
+        // largeTexture has another desc
+        constexpr size_t textureBytes = 256 * 256 * 4;
+        const auto& stats = builder.GetTransientMemoryStats();
+        ASSERT_EQ(stats.transientResourceNum, 4);
+        ASSERT_EQ(stats.physicalResourceNum, 3);
+        ASSERT_EQ(stats.bytesWithoutAliasing, textureBytes * 5);
+        ASSERT_EQ(stats.bytesWithAliasing, textureBytes * 4);
+        ASSERT_EQ(stats.peakLiveBytes, textureBytes * 4);
+    }
+    ASSERT_NE(rhiTexture0, nullptr);
+    ASSERT_EQ(rhiTexture0, rhiTexture2);
+    RGCommandPool::Get(*device).Invalidate();
+    TexturePool::Get(*device).Invalidate();
+}
+
+TEST_F(RenderGraphTest, SameStateAliasingBarrierTest)
+{
+    const auto textureDesc = RGTextureDesc()
+        .SetDimension(RHI::TextureDimension::t2D)
+        .SetWidth(256)
+        .SetHeight(256)
+        .SetDepthOrArraySize(1)
+        .SetFormat(RHI::PixelFormat::rgba8Unorm)
+        .SetUsages(RHI::TextureUsageBits::copySrc | RHI::TextureUsageBits::renderAttachment)
+        .SetMipLevels(1)
+        .SetSamples(1)
+        .SetInitialState(RHI::TextureState::undefined);
+    const auto outputDesc = RGTextureDesc(textureDesc)
+        .SetUsages(RHI::TextureUsageBits::copyDst);
+    const auto viewDesc = RGTextureViewDesc(RHI::TextureViewType::colorAttachment, RHI::TextureViewDimension::tv2D);
+    const Common::UniquePtr<RHI::Texture> output0 = device->CreateTexture(outputDesc);
+    const Common::UniquePtr<RHI::Texture> output1 = device->CreateTexture(outputDesc);
+
+    RHI::Texture* rhiTexture0 = nullptr;
+    RHI::Texture* rhiTexture1 = nullptr;
+    {
+        RGBuilder builder(*device);
+        auto* texture0 = builder.CreateTexture(textureDesc);
+        auto* texture1 = builder.CreateTexture(textureDesc);
+        auto* textureView0 = builder.CreateTextureView(texture0, viewDesc);
+        auto* textureView1 = builder.CreateTextureView(texture1, viewDesc);
+        auto* outputTexture0 = builder.ImportTexture(output0.Get(), RHI::TextureState::undefined);
+        auto* outputTexture1 = builder.ImportTexture(output1.Get(), RHI::TextureState::undefined);
+
+        // texture0 is left as render target by Pass2, texture1 reuses its object and starts as render target in Pass3
+        builder.AddRasterPass("Pass0", RGRasterPassDesc().AddColorAttachment(RGColorAttachment(textureView0)), {}, [](const RGBuilder&, RHI::RasterPassCommandRecorder&) -> void {});
+        builder.AddCopyPass("Pass1", RGCopyPassDesc { { texture0 }, { outputTexture0 } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+        builder.AddRasterPass("Pass2", RGRasterPassDesc().AddColorAttachment(RGColorAttachment(textureView0)), {}, [&](const RGBuilder& rg, RHI::RasterPassCommandRecorder&) -> void {
+            rhiTexture0 = rg.GetRHI(texture0);
+        });
+        builder.AddRasterPass("Pass3", RGRasterPassDesc().AddColorAttachment(RGColorAttachment(textureView1)), {}, [&](const RGBuilder& rg, RHI::RasterPassCommandRecorder&) -> void {
+            rhiTexture1 = rg.GetRHI(texture1);
+        });
+        builder.AddCopyPass("Pass4", RGCopyPassDesc { { texture1 }, { outputTexture1 } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+        builder.Execute(RGExecuteInfo {});
+
+        ASSERT_EQ(builder.GetTransientMemoryStats().physicalResourceNum, 1);
+        // Pass3 only uses texture1, its aliasing barrier is kept though both states are render target
+        const auto& transitions = builder.GetPassTransitions(3);
+        ASSERT_EQ(transitions.size(), 1);
+        ASSERT_EQ(transitions[0].before, RGResourceState(RHI::TextureState::renderTarget));
+        ASSERT_EQ(transitions[0].after, RGResourceState(RHI::TextureState::renderTarget));
+    }
+    ASSERT_NE(rhiTexture0, nullptr);
+    ASSERT_EQ(rhiTexture0, rhiTexture1);
+    RGCommandPool::Get(*device).Invalidate();
+    TexturePool::Get(*device).Invalidate();
+}
+
+TEST_F(RenderGraphTest, CompiledGraphReuseTest)
+{
+    const auto textureDesc = RGTextureDesc()
+        .SetDimension(RHI::TextureDimension::t2D)
+        .SetWidth(256)
+        .SetHeight(256)
+        .SetDepthOrArraySize(1)
+        .SetFormat(RHI::PixelFormat::rgba8Unorm)
+        .SetUsages(RHI::TextureUsageBits::copySrc | RHI::TextureUsageBits::copyDst)
+        .SetMipLevels(1)
+        .SetSamples(1)
+        .SetInitialState(RHI::TextureState::undefined);
+    const Common::UniquePtr<RHI::Texture> output0 = device->CreateTexture(textureDesc);
+    const Common::UniquePtr<RHI::Texture> output1 = device->CreateTexture(textureDesc);
+
+    // imported handles differ between frames, the topology is the same
+    const auto buildAndExecute = [&](RHI::Texture* inOutput, uint32_t inWidth, bool& outReused, RHI::Texture*& outRhiTexture0, RHI::Texture*& outRhiTexture2) -> void {
+        RGBuilder builder(*device, true);
+        const auto desc = RGTextureDesc(textureDesc).SetWidth(inWidth);
+        auto* texture0 = builder.CreateTexture(desc);
+        auto* texture1 = builder.CreateTexture(desc);
+        auto* texture2 = builder.CreateTexture(desc);
+        auto* culledTexture = builder.CreateTexture(desc);
+        auto* outputTexture = builder.ImportTexture(inOutput, RHI::TextureState::undefined);
+
+        builder.AddCopyPass("Pass0", RGCopyPassDesc { {}, { texture0 } }, [&](const RGBuilder& rg, RHI::CopyPassCommandRecorder&) -> void {
+            outRhiTexture0 = rg.GetRHI(texture0);
+        });
+        builder.AddCopyPass("Pass1", RGCopyPassDesc { { texture0 }, { texture1 } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+        builder.AddCopyPass("Pass2", RGCopyPassDesc { { texture1 }, { texture2 } }, [&](const RGBuilder& rg, RHI::CopyPassCommandRecorder&) -> void {
+            outRhiTexture2 = rg.GetRHI(texture2);
+        });
+        builder.AddCopyPass("Pass3", RGCopyPassDesc { { texture2 }, { outputTexture } }, [&](const RGBuilder& rg, RHI::CopyPassCommandRecorder&) -> void {
+            ASSERT_EQ(rg.GetRHI(outputTexture), inOutput);
+        });
+        builder.AddCopyPass("CulledPass", RGCopyPassDesc { { texture2 }, { culledTexture } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {
+            FAIL();
+        });
+        builder.Execute(RGExecuteInfo {});
+
+        outReused = builder.CompiledGraphReused();
+        ASSERT_EQ(builder.GetTransientMemoryStats().transientResourceNum, 3);
+        ASSERT_EQ(builder.GetTransientMemoryStats().physicalResourceNum, 2);
+    };
+
+    RGCompileCache::Get(*device).Invalidate();
+    const auto hitNum = RGCompileCache::Get(*device).GetStats().hitNum;
+    bool reused = false;
+    RHI::Texture* rhiTexture0 = nullptr;
+    RHI::Texture* rhiTexture2 = nullptr;
+
+    buildAndExecute(output0.Get(), 256, reused, rhiTexture0, rhiTexture2);
+    ASSERT_FALSE(reused);
+    ASSERT_EQ(RGCompileCache::Get(*device).Size(), 1);
+
+    buildAndExecute(output1.Get(), 256, reused, rhiTexture0, rhiTexture2);
+    ASSERT_TRUE(reused);
+    ASSERT_EQ(rhiTexture0, rhiTexture2);
+    ASSERT_EQ(RGCompileCache::Get(*device).GetStats().hitNum, hitNum + 1);
+
+    // a different resource desc changes the topology
+    buildAndExecute(output0.Get(), 128, reused, rhiTexture0, rhiTexture2);
+    ASSERT_FALSE(reused);
+    ASSERT_EQ(RGCompileCache::Get(*device).Size(), 2);
+
+    RGCompileCache::Get(*device).Invalidate();
+    RGCommandPool::Get(*device).Invalidate();
+    TexturePool::Get(*device).Invalidate();
+}
+
+TEST_F(RenderGraphTest, ParallelRecordingTest)
+{
+    RenderWorkerThreads::Get().Start();
+
+    const auto textureDesc = RGTextureDesc()
+        .SetDimension(RHI::TextureDimension::t2D)
+        .SetWidth(256)
+        .SetHeight(256)
+        .SetDepthOrArraySize(1)
+        .SetFormat(RHI::PixelFormat::rgba8Unorm)
+        .SetUsages(RHI::TextureUsageBits::copySrc | RHI::TextureUsageBits::copyDst)
+        .SetMipLevels(1)
+        .SetSamples(1)
+        .SetInitialState(RHI::TextureState::undefined);
+    const Common::UniquePtr<RHI::Texture> output = device->CreateTexture(textureDesc);
+
+    // a chain of passes, each pass checks it sees the same texture its predecessor wrote
+    constexpr uint32_t passNum = 20;
+    std::vector<RHI::Texture*> writtenTextures(passNum, nullptr);
+    std::vector<RHI::Texture*> readTextures(passNum, nullptr);
+    std::vector<Core::ThreadTag> recordThreadTags(passNum, Core::ThreadTag::max);
+    auto& commandPool = RGCommandPool::Get(*device);
+    commandPool.Invalidate();
+    const auto stats = commandPool.GetStats();
+    {
+        RGBuilder builder(*device);
+        std::vector<RGTextureRef> textures;
+        textures.reserve(passNum);
+        for (auto i = 0; i < passNum - 1; i++) {
+            textures.emplace_back(builder.CreateTexture(textureDesc));
+        }
+        textures.emplace_back(builder.ImportTexture(output.Get(), RHI::TextureState::undefined));
+
+        for (auto i = 0; i < passNum; i++) {
+            RGCopyPassDesc passDesc;
+            if (i > 0) {
+                passDesc.copySrcs.emplace_back(textures[i - 1]);
+            }
+            passDesc.copyDsts.emplace_back(textures[i]);
+            builder.AddCopyPass("Pass" + std::to_string(i), passDesc, [&, i](const RGBuilder& rg, RHI::CopyPassCommandRecorder&) -> void {
+                if (i > 0) {
+                    readTextures[i] = rg.GetRHI(textures[i - 1]);
+                }
+                writtenTextures[i] = rg.GetRHI(textures[i]);
+                recordThreadTags[i] = Core::ThreadContext::Tag();
+            });
+        }
+
+        RGExecuteInfo executeInfo;
+        executeInfo.parallelRecording = true;
+        builder.Execute(executeInfo);
+    }
+
+    for (auto i = 0; i < passNum; i++) {
+        ASSERT_NE(writtenTextures[i], nullptr);
+        if (i > 0) {
+            ASSERT_EQ(readTextures[i], writtenTextures[i - 1]);
+        }
+    }
+    ASSERT_EQ(writtenTextures[passNum - 1], output.Get());
+    // passes are split into the max group num, each group is recorded on a render worker into its own command buffer
+    ASSERT_EQ(commandPool.GetStats().cmdBufferCreatedNum - stats.cmdBufferCreatedNum, 8);
+    for (const auto tag : recordThreadTags) {
+        ASSERT_EQ(tag, Core::ThreadTag::renderWorker);
+    }
+    RGCommandPool::Get(*device).Invalidate();
+    TexturePool::Get(*device).Invalidate();
+    RenderWorkerThreads::Get().Stop();
+}
+
+TEST_F(RenderGraphTest, CommandPoolTest)
+{
+    const auto textureDesc = RGTextureDesc()
+        .SetDimension(RHI::TextureDimension::t2D)
+        .SetWidth(256)
+        .SetHeight(256)
+        .SetDepthOrArraySize(1)
+        .SetFormat(RHI::PixelFormat::rgba8Unorm)
+        .SetUsages(RHI::TextureUsageBits::copySrc | RHI::TextureUsageBits::copyDst)
+        .SetMipLevels(1)
+        .SetSamples(1)
+        .SetInitialState(RHI::TextureState::undefined);
+    const Common::UniquePtr<RHI::Texture> output = device->CreateTexture(textureDesc);
+
+    // two async timelines, each needs a command buffer, the first one also signals a semaphore
+    const auto buildAndExecute = [&]() -> void {
+        RGBuilder builder(*device);
+        auto* texture = builder.CreateTexture(textureDesc);
+        auto* outputTexture = builder.ImportTexture(output.Get(), RHI::TextureState::undefined);
+
+        builder.AddCopyPass("Pass0", RGCopyPassDesc { {}, { texture } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+        builder.AddSyncPoint();
+        builder.AddCopyPass("Pass1", RGCopyPassDesc { { texture }, { outputTexture } }, [](const RGBuilder&, RHI::CopyPassCommandRecorder&) -> void {});
+        builder.Execute(RGExecuteInfo {});
+    };
+
+    auto& commandPool = RGCommandPool::Get(*device);
+    commandPool.Invalidate();
+    const auto stats = commandPool.GetStats();
+
+    // objects of a frame are reused two frames later, so the first two frames fill the pool
+    for (auto i = 0; i < 2; i++) {
+        buildAndExecute();
+        Core::ThreadContext::IncFrameNumber();
+    }
+    ASSERT_EQ(commandPool.GetStats().cmdBufferCreatedNum, stats.cmdBufferCreatedNum + 4);
+    ASSERT_EQ(commandPool.GetStats().semaphoreCreatedNum, stats.semaphoreCreatedNum + 2);
+    ASSERT_EQ(commandPool.Size(), 6);
+
+    for (auto i = 0; i < 8; i++) {
+        buildAndExecute();
+        Core::ThreadContext::IncFrameNumber();
+    }
+    ASSERT_EQ(commandPool.GetStats().cmdBufferCreatedNum, stats.cmdBufferCreatedNum + 4);
+    ASSERT_EQ(commandPool.GetStats().semaphoreCreatedNum, stats.semaphoreCreatedNum + 2);
+    ASSERT_EQ(commandPool.GetStats().cmdBufferReusedNum, stats.cmdBufferReusedNum + 16);
+    ASSERT_EQ(commandPool.GetStats().semaphoreReusedNum, stats.semaphoreReusedNum + 8);
+    ASSERT_EQ(commandPool.Size(), 6);
+
+    commandPool.Invalidate();
+    TexturePool::Get(*device).Invalidate();
+}
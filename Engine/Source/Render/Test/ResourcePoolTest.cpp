@@ -75,3 +75,54 @@ TEST_F(ResourcePoolTest, BasicTest)
     texturePool.Forfeit();
     ASSERT_EQ(texturePool.Size(), 1);
 }
+
+TEST_F(ResourcePoolTest, StatsTest)
+{
+    auto& bufferPool = BufferPool::Get(*device);
+    bufferPool.Invalidate();
+    const auto baseStats = bufferPool.GetStats();
+
+    const PooledBufferDesc bufferDesc(1024, RHI::BufferUsageBits::storage, RHI::BufferState::undefined);
+    PooledBufferRef b0 = bufferPool.Allocate(bufferDesc);
+    PooledBufferRef b1 = bufferPool.Allocate(bufferDesc);
+    b0.Reset();
+    PooledBufferRef b2 = bufferPool.Allocate(bufferDesc);
+    ASSERT_EQ(bufferPool.GetStats().missNum - baseStats.missNum, 2);
+    ASSERT_EQ(bufferPool.GetStats().hitNum - baseStats.hitNum, 1);
+
+    b1.Reset();
+    b2.Reset();
+    for (auto i = 0; i <= Internal::pooledResourceReleaseFrameLatency; i++) {
+        Core::ThreadContext::IncFrameNumber();
+        bufferPool.Forfeit();
+    }
+    ASSERT_EQ(bufferPool.Size(), 0);
+    ASSERT_EQ(bufferPool.GetStats().evictedNum - baseStats.evictedNum, 2);
+}
+
+TEST_F(ResourcePoolTest, EmptyBucketRemoveTest)
+{
+    auto& bufferPool = BufferPool::Get(*device);
+    bufferPool.Invalidate();
+
+    PooledBufferRef b0 = bufferPool.Allocate(PooledBufferDesc(256, RHI::BufferUsageBits::storage, RHI::BufferState::undefined));
+    PooledBufferRef b1 = bufferPool.Allocate(PooledBufferDesc(512, RHI::BufferUsageBits::storage, RHI::BufferState::undefined));
+    PooledBufferRef b2 = bufferPool.Allocate(PooledBufferDesc(1024, RHI::BufferUsageBits::storage, RHI::BufferState::undefined));
+    ASSERT_EQ(bufferPool.BucketNum(), 3);
+
+    b0.Reset();
+    b2.Reset();
+    for (auto i = 0; i <= Internal::pooledResourceReleaseFrameLatency; i++) {
+        Core::ThreadContext::IncFrameNumber();
+        bufferPool.Forfeit();
+    }
+    ASSERT_EQ(bufferPool.Size(), 1);
+    ASSERT_EQ(bufferPool.BucketNum(), 1);
+
+    // the index of the bucket moved by the removal is still valid
+    auto* bufferPtr = b1.Get();
+    b1.Reset();
+    const PooledBufferRef b3 = bufferPool.Allocate(PooledBufferDesc(512, RHI::BufferUsageBits::storage, RHI::BufferState::undefined));
+    ASSERT_EQ(bufferPtr, b3.Get());
+    ASSERT_EQ(bufferPool.BucketNum(), 1);
+}
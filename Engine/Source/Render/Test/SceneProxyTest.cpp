@@ -0,0 +1,96 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <Test/Test.h>
+
+#include <Core/Thread.h>
+#include <Render/Scene.h>
+#include <Render/SceneProxy/Light.h>
+
+using namespace Render;
+
+struct TestSceneProxy {
+    Common::FMat4x4 localToWorld;
+    uint32_t value;
+};
+
+static LightSceneProxy MakeLight(LightType inType, float inIntensity)
+{
+    LightSceneProxy result;
+    result.type = inType;
+    result.intensity = inIntensity;
+    return result;
+}
+
+TEST(SceneProxyTest, ContainerTest)
+{
+    SceneProxyContainer<TestSceneProxy> container;
+    container.Add(1, TestSceneProxy { Common::FMat4x4Consts::identity, 1 });
+    container.Add(2, TestSceneProxy { Common::FMat4x4Consts::identity, 2 });
+    container.Add(3, TestSceneProxy { Common::FMat4x4Consts::identity, 3 });
+    ASSERT_EQ(container.Count(), 3);
+
+    container.Remove(1);
+    ASSERT_EQ(container.Count(), 2);
+    ASSERT_FALSE(container.Contains(1));
+    ASSERT_EQ(container.Get(2).value, 2);
+    ASSERT_EQ(container.Get(3).value, 3);
+    ASSERT_EQ(container.Entities().size(), container.SceneProxies().size());
+
+    container.Update(3, TestSceneProxy { Common::FMat4x4Consts::identity, 4 });
+    ASSERT_EQ(container.Get(3).value, 4);
+}
+
+TEST(SceneProxyTest, LightContainerTest)
+{
+    SceneProxyContainer<LightSceneProxy> container;
+    container.Add(1, MakeLight(LightType::directional, 1.0f));
+    container.Add(2, MakeLight(LightType::point, 2.0f));
+    container.Add(3, MakeLight(LightType::spot, 3.0f));
+
+    container.Remove(2);
+    ASSERT_EQ(container.Count(), 2);
+    ASSERT_EQ(container.Intensities().size(), 2);
+    ASSERT_EQ(container.Get(1).type, LightType::directional);
+    ASSERT_EQ(container.Get(3).type, LightType::spot);
+    ASSERT_EQ(container.Get(3).intensity, 3.0f);
+
+    for (auto i = 0; i < container.Count(); i++) {
+        ASSERT_EQ(container.Get(container.Entities()[i]).intensity, container.Intensities()[i]);
+    }
+
+    auto light = container.Get(1);
+    light.intensity = 5.0f;
+    container.Update(1, std::move(light));
+    ASSERT_EQ(container.Get(1).intensity, 5.0f);
+}
+
+TEST(SceneProxyTest, SceneApplyDeltasTest)
+{
+    Core::ScopedThreadTag tag(Core::ThreadTag::render);
+    Scene scene;
+    scene.Add(1, MakeLight(LightType::directional, 1.0f));
+
+    // adds, then updates, then removes, then transform updates, an entity added and removed in one frame is gone,
+    // and a transform update is not overwritten by the content update of the same frame
+    const auto localToWorld = Common::FMat4x4Consts::identity * 2.0f;
+    SceneProxyDeltas<LightSceneProxy> deltas;
+    deltas.transformUpdates.emplace_back(2, localToWorld);
+    deltas.removes.emplace_back(3);
+    deltas.updates.emplace_back(2, MakeLight(LightType::point, 4.0f));
+    deltas.updates.emplace_back(1, MakeLight(LightType::spot, 5.0f));
+    deltas.adds.emplace_back(2, MakeLight(LightType::point, 2.0f));
+    deltas.adds.emplace_back(3, MakeLight(LightType::spot, 3.0f));
+    ASSERT_FALSE(deltas.Empty());
+    scene.Apply(std::move(deltas));
+
+    const auto& lights = scene.GetSceneProxies<LightSceneProxy>();
+    ASSERT_EQ(lights.Count(), 2);
+    ASSERT_FALSE(lights.Contains(3));
+    ASSERT_EQ(scene.Get<LightSceneProxy>(1).type, LightType::spot);
+    ASSERT_EQ(scene.Get<LightSceneProxy>(1).intensity, 5.0f);
+    ASSERT_EQ(scene.Get<LightSceneProxy>(2).intensity, 4.0f);
+    ASSERT_EQ(scene.Get<LightSceneProxy>(2).localToWorld, localToWorld);
+    ASSERT_EQ(scene.GetAppliedDeltasNum(), 1);
+}
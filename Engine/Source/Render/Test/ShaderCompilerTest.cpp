@@ -0,0 +1,178 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <fstream>
+
+#include <Test/Test.h>
+
+#include <Render/ShaderCompiler.h>
+
+using namespace Render;
+
+class TestShaderType final : public IShaderType {
+public:
+    TestShaderType(ShaderTypeKey inKey, uint32_t inVariantNum)
+        : name("TestShaderType")
+        , key(inKey)
+        , entryPoint("PSMain")
+        , code("float4 PSMain() : SV_TARGET { return VARIANT; }")
+    {
+        for (VariantKey i = 0; i < inVariantNum; i++) {
+            variants.emplace_back(i);
+            definitions.emplace(i, std::vector<std::string> { std::format("VARIANT={}", i) });
+        }
+    }
+
+    const std::string& GetName() override { return name; }
+    ShaderTypeKey GetKey() override { return key; }
+    RHI::ShaderStageBits GetStage() override { return RHI::ShaderStageBits::sPixel; }
+    const std::string& GetEntryPoint() override { return entryPoint; }
+    const std::string& GetCode() override { return code; }
+    uint32_t GetVariantNum() override { return variants.size(); }
+    const std::vector<VariantKey>& GetVariants() override { return variants; }
+    const std::vector<std::string>& GetDefinitions(VariantKey variantKey) override { return definitions.at(variantKey); }
+    void Reload() override {}
+    void Invalidate() override {}
+
+private:
+    std::string name;
+    ShaderTypeKey key;
+    std::string entryPoint;
+    std::string code;
+    std::vector<VariantKey> variants;
+    std::unordered_map<VariantKey, std::vector<std::string>> definitions;
+};
+
+static void WriteTextFile(const Common::Path& inPath, const std::string& inContent)
+{
+    std::ofstream file(inPath.String());
+    file << inContent;
+}
+
+TEST(ShaderCompilerTest, ByteCodeCacheTest)
+{
+    auto& cache = ShaderByteCodeCache::Get();
+    const auto directory = cache.GetDirectory();
+    cache.SetDirectory("../Test/Generated/Render/ShaderCompilerTest.ByteCodeCacheTest");
+    const auto stats = cache.GetStats();
+
+    ShaderCompileInput input;
+    input.source = "float4 PSMain() : SV_TARGET { return 1; }";
+    input.entryPoint = "PSMain";
+    input.stage = RHI::ShaderStageBits::sPixel;
+    input.definitions = { "TEST_DEFINITION=1" };
+    ShaderCompileOptions options;
+    options.byteCodeType = ShaderByteCodeType::spirv;
+
+    auto otherInput = input;
+    otherInput.definitions = { "TEST_DEFINITION=2" };
+    auto otherOptions = options;
+    otherOptions.withDebugInfo = true;
+    const auto key = cache.ComputeKey(input, options);
+    ASSERT_EQ(key, cache.ComputeKey(input, options));
+    ASSERT_NE(key, cache.ComputeKey(otherInput, options));
+    ASSERT_NE(key, cache.ComputeKey(input, otherOptions));
+
+    ShaderCompileOutput output;
+    output.success = true;
+    output.byteCode = { 1, 2, 3, 4 };
+    output.reflectionData.vertexBindings.emplace("POSITION0", RHI::GlslVertexBinding(2));
+    output.reflectionData.resourceBindings.emplace("color", std::make_pair(1, RHI::ResourceBinding(RHI::BindingType::uniformBuffer, RHI::GlslBinding(3))));
+    cache.Save(key, output);
+
+    ShaderCompileOutput cachedOutput;
+    ASSERT_TRUE(cache.Load(key, cachedOutput));
+    ASSERT_FALSE(cache.Load(cache.ComputeKey(otherInput, options), cachedOutput));
+    ASSERT_TRUE(cachedOutput.success);
+    ASSERT_EQ(cachedOutput.byteCode, output.byteCode);
+    ASSERT_EQ(std::get<RHI::GlslVertexBinding>(cachedOutput.reflectionData.QueryVertexBindingChecked("POSITION0")).location, 2);
+    const auto& [layoutIndex, binding] = cachedOutput.reflectionData.QueryResourceBindingChecked("color");
+    ASSERT_EQ(layoutIndex, 1);
+    ASSERT_EQ(binding.type, RHI::BindingType::uniformBuffer);
+    ASSERT_EQ(std::get<RHI::GlslBinding>(binding.platformBinding).index, 3);
+
+    ASSERT_EQ(cache.GetStats().hitNum, stats.hitNum + 1);
+    ASSERT_EQ(cache.GetStats().missNum, stats.missNum + 1);
+    cache.SetDirectory(directory);
+}
+
+TEST(ShaderCompilerTest, IncludeKeyTest)
+{
+    const Common::Path directory = "../Test/Generated/Render/ShaderCompilerTest.IncludeKeyTest";
+    const auto localDirectory = directory / "Local";
+    const auto includeDirectory = directory / "Include";
+    localDirectory.MakeDir();
+    includeDirectory.MakeDir();
+    WriteTextFile(localDirectory / "Main.esh", "#include \"Common.esh\"");
+    WriteTextFile(localDirectory / "Common.esh", "float LocalValue() { return 0; }");
+    WriteTextFile(includeDirectory / "Main.esh", "#include \"Common.esh\"");
+    WriteTextFile(includeDirectory / "Common.esh", "float IncludeValue() { return 0; }");
+
+    auto& cache = ShaderByteCodeCache::Get();
+    ShaderCompileInput input;
+    input.source = "#include \"Local/Main.esh\"\nfloat4 PSMain() : SV_TARGET { return 1; }";
+    input.entryPoint = "PSMain";
+    input.stage = RHI::ShaderStageBits::sPixel;
+    ShaderCompileOptions options;
+    options.byteCodeType = ShaderByteCodeType::spirv;
+    options.includePaths = { directory.String(), includeDirectory.String() };
+    const auto key = cache.ComputeKey(input, options);
+
+    // the quoted include of Local/Main.esh resolves to the Common.esh beside it, not the one in the include path
+    WriteTextFile(includeDirectory / "Common.esh", "float IncludeValue() { return 1; }");
+    ASSERT_EQ(key, cache.ComputeKey(input, options));
+    WriteTextFile(localDirectory / "Common.esh", "float LocalValue() { return 1; }");
+    ASSERT_NE(key, cache.ComputeKey(input, options));
+}
+
+TEST(ShaderCompilerTest, ShaderTypeCompileZeroVariantTest)
+{
+    const auto emptyResult = ShaderTypeCompiler::Get().Compile({}, ShaderCompileOptions {}).get();
+    ASSERT_TRUE(emptyResult.success);
+    ASSERT_TRUE(emptyResult.errorInfos.empty());
+
+    TestShaderType shaderType(1, 0);
+    const auto result = ShaderTypeCompiler::Get().Compile({ &shaderType }, ShaderCompileOptions {}).get();
+    ASSERT_TRUE(result.success);
+    ASSERT_TRUE(ShaderArchiveStorage::Get().GetShaderArchivePackage(shaderType.GetKey()).empty());
+    ShaderArchiveStorage::Get().Invalidate(shaderType.GetKey());
+}
+
+TEST(ShaderCompilerTest, ShaderTypeCompileTest)
+{
+    constexpr uint32_t variantNum = 16;
+
+    auto& cache = ShaderByteCodeCache::Get();
+    const auto directory = cache.GetDirectory();
+    cache.SetDirectory("../Test/Generated/Render/ShaderCompilerTest.ShaderTypeCompileTest");
+
+    // outputs of all variants are cached, so the variants finish on compiler threads in any order without dxc
+    TestShaderType shaderType(2, variantNum);
+    ShaderCompileOptions options;
+    options.byteCodeType = ShaderByteCodeType::spirv;
+    for (const auto variantKey : shaderType.GetVariants()) {
+        ShaderCompileInput input;
+        input.source = shaderType.GetCode();
+        input.entryPoint = shaderType.GetEntryPoint();
+        input.stage = shaderType.GetStage();
+        input.definitions = shaderType.GetDefinitions(variantKey);
+
+        ShaderCompileOutput output;
+        output.success = true;
+        output.byteCode = { static_cast<uint8_t>(variantKey) };
+        cache.Save(cache.ComputeKey(input, options), output);
+    }
+
+    // the last finished variant fulfills the promise with all archives stored
+    const auto result = ShaderTypeCompiler::Get().Compile({ &shaderType }, options).get();
+    ASSERT_TRUE(result.success);
+    const auto& package = ShaderArchiveStorage::Get().GetShaderArchivePackage(shaderType.GetKey());
+    ASSERT_EQ(package.size(), variantNum);
+    for (const auto variantKey : shaderType.GetVariants()) {
+        ASSERT_EQ(package.at(variantKey).byteCode, std::vector<uint8_t> { static_cast<uint8_t>(variantKey) });
+    }
+
+    ShaderArchiveStorage::Get().Invalidate(shaderType.GetKey());
+    cache.SetDirectory(directory);
+}
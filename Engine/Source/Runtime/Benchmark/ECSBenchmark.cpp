@@ -0,0 +1,31 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#include <chrono>
+#include <iostream>
+
+#include <ECSBenchmark.h>
+
+using namespace Runtime;
+
+int main(int argc, char* argv[])
+{
+    constexpr uint32_t cycleNum = 1000000;
+
+    ECRegistry registry;
+    const auto begin = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < cycleNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<BenchmarkComp>(entity, i);
+        registry.Destroy(entity);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const auto timeUs = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    std::cout << "cycleNum: " << cycleNum << std::endl;
+    std::cout << "entityNum: " << registry.Count() << std::endl;
+    std::cout << "timeUs: " << timeUs << std::endl;
+    std::cout << "nsPerCycle: " << static_cast<double>(timeUs) * 1000.0 / cycleNum << std::endl;
+    return 0;
+}
@@ -0,0 +1,24 @@
+//
+// Created by agent on 2026/10/18.
+//
+
+#pragma once
+
+#include <Runtime/Meta.h>
+#include <Runtime/ECS.h>
+
+struct EClass() BenchmarkComp {
+    EClassBody(BenchmarkComp)
+
+    BenchmarkComp()
+        : value(0)
+    {
+    }
+
+    explicit BenchmarkComp(uint32_t inValue)
+        : value(inValue)
+    {
+    }
+
+    EProperty() uint32_t value;
+};
@@ -8,6 +8,14 @@
 #include <functional>
 #include <unordered_map>
 #include <utility>
+#include <array>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <list>
+#include <set>
+#include <optional>
+#include <filesystem>
 
 #include <Common/Memory.h>
 #include <Common/Serialization.h>
@@ -110,6 +118,65 @@ namespace Runtime {
     template <Common::DerivedFrom<Asset> A> using OnAssetLoaded = std::function<void(AssetPtr<A>)>;
     template <Common::DerivedFrom<Asset> A> using OnSoftAssetLoaded = std::function<void()>;
 
+    // higher priority is streamed first
+    using AssetStreamPriority = int32_t;
+
+    enum class AssetStreamState : uint8_t {
+        pending,
+        loading,
+        loaded,
+        cancelled,
+        max
+    };
+
+    // a streaming load waiting in queue, all fields except state are guarded by the streaming mutex of asset manager
+    struct AssetStreamRequest {
+        Core::Uri uri;
+        AssetStreamPriority priority;
+        uint64_t sequence;
+        uint64_t requestTimeUs;
+        std::atomic<AssetStreamState> state;
+        std::function<AssetPtr<Asset>()> loader;
+        std::function<void(AssetPtr<Asset>)> onLoaded;
+    };
+
+    class RUNTIME_API AssetStreamHandle {
+    public:
+        AssetStreamHandle();
+        explicit AssetStreamHandle(Common::SharedPtr<AssetStreamRequest> inRequest);
+
+        bool Valid() const;
+        AssetStreamState State() const;
+        // only affects a pending request
+        void SetPriority(AssetStreamPriority inPriority) const;
+        // returns false if the request was already picked by a worker, then the load completes and callback is invoked
+        bool Cancel() const;
+
+    private:
+        Common::SharedPtr<AssetStreamRequest> request;
+    };
+
+    struct AssetResidency {
+        AssetResidency();
+
+        // serialized bytes of the asset, it is what the streaming budget accounts
+        size_t residentSize;
+        // from the stream request to the asset is loaded, time waiting in queue included
+        uint64_t loadLatencyUs;
+    };
+
+    struct AssetStreamingStats {
+        AssetStreamingStats();
+
+        size_t budget;
+        size_t residentSize;
+        size_t residentNum;
+        size_t pendingNum;
+        uint64_t loadedNum;
+        uint64_t cancelledNum;
+        uint64_t evictedNum;
+    };
+
     class RUNTIME_API AssetManager {
     public:
         static AssetManager& Get();
@@ -121,14 +188,92 @@ namespace Runtime {
         template <Common::DerivedFrom<Asset> A> void AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const OnSoftAssetLoaded<A>& onSoftAssetLoaded);
         template <Common::DerivedFrom<Asset> A> void Save(const AssetPtr<A>& assetRef);
         template <Common::DerivedFrom<Asset> A> void SaveSoft(const SoftAssetPtr<A>& softAssetRef);
+        // used by asset references met while deserializing, inside a load the referenced asset is loaded in parallel on
+        // the pool and the referencing asset completes after it, outside a load it is the same as SyncLoad
+        template <Common::DerivedFrom<Asset> A> AssetPtr<A> LoadDependency(const Core::Uri& uri);
+        // streaming requests are picked by priority (FIFO among same priority) when a worker is free, the streamed asset is
+        // kept resident by asset manager instead of the soft ref, and resident assets are evicted in LRU order once the
+        // streaming budget is exceeded, GetStreamed() fetches a resident asset and marks it as recently used
+        template <Common::DerivedFrom<Asset> A> AssetStreamHandle StreamSoft(const SoftAssetPtr<A>& softAssetRef, AssetStreamPriority priority, const OnAssetLoaded<A>& onAssetLoaded = {});
+        template <Common::DerivedFrom<Asset> A> AssetPtr<A> GetStreamed(const SoftAssetPtr<A>& softAssetRef);
+        void SetStreamingBudget(size_t inBudget);
+        std::optional<AssetResidency> QueryResidency(const Core::Uri& uri) const;
+        AssetStreamingStats GetStreamingStats() const;
 
     private:
-        template <Common::DerivedFrom<Asset> A> AssetPtr<A> LoadInternal(const Core::Uri& uri);
+        friend class AssetStreamHandle;
+
+        // one in-flight load of an uri, shared by all requests of the uri, the asset object is created before it is
+        // deserialized so dependents can point to it at once, it is published to cache only when its dependencies are loaded
+        struct LoadTask {
+            Core::Uri uri;
+            AssetPtr<Asset> asset;
+            // the class the asset object is created as, later requests of the uri must ask for it or one of its bases
+            const Mirror::Class* assetClass;
+            // returns serialized bytes of the asset
+            std::function<size_t()> deserializer;
+            size_t residentSize;
+            std::atomic<bool> started;
+            // the dependency this task is blocked on while waiting for its dependencies, guarded by load wait mutex
+            LoadTask* waitingOn;
+            std::promise<void> promise;
+            std::shared_future<void> future;
+        };
+
+        struct CachedAsset {
+            WeakAssetPtr<Asset> asset;
+            const Mirror::Class* assetClass;
+            size_t residentSize;
+        };
+
+        struct CacheShard {
+            std::mutex mutex;
+            std::unordered_map<Core::Uri, CachedAsset> cachedAssets;
+            std::unordered_map<Core::Uri, Common::SharedPtr<LoadTask>> loadTasks;
+        };
+
+        struct ResidentAsset {
+            AssetPtr<Asset> asset;
+            AssetResidency residency;
+            std::list<Core::Uri>::iterator lruIter;
+        };
+
+        struct StreamRequestCompare {
+            bool operator()(const Common::SharedPtr<AssetStreamRequest>& lhs, const Common::SharedPtr<AssetStreamRequest>& rhs) const;
+        };
+
+        static constexpr size_t cacheShardNum = 16;
+        static std::vector<Common::SharedPtr<LoadTask>>*& CurrentLoadDependencies();
 
         AssetManager();
 
-        std::mutex mutex;
-        std::unordered_map<Core::Uri, WeakAssetPtr<Asset>> weakAssetRefs;
+        // returns nullptr with outLoaded set when the asset is in cache
+        template <Common::DerivedFrom<Asset> A> Common::SharedPtr<LoadTask> AcquireLoadTask(const Core::Uri& uri, AssetPtr<A>& outLoaded, bool& outCreated);
+        static void CheckRequestedClass(const Mirror::Class* assetClass, const Mirror::Class* requestedClass);
+        CacheShard& GetCacheShard(const Core::Uri& uri);
+        void RunLoadTask(const Common::SharedPtr<LoadTask>& task);
+        void WaitLoadTask(const Common::SharedPtr<LoadTask>& task);
+        bool TryBeginWaitDependency(LoadTask& task, const Common::SharedPtr<LoadTask>& dependency);
+        void EndWaitDependency(LoadTask& task);
+        bool TryDeferLoadDependency(const Common::SharedPtr<LoadTask>& task, bool created);
+        size_t GetCachedResidentSize(const Core::Uri& uri);
+        AssetStreamHandle SubmitStreamRequest(const Core::Uri& uri, AssetStreamPriority priority, std::function<AssetPtr<Asset>()>&& loader, std::function<void(AssetPtr<Asset>)>&& onLoaded);
+        void PumpStreamRequest();
+        void SetStreamRequestPriority(const Common::SharedPtr<AssetStreamRequest>& request, AssetStreamPriority priority);
+        bool CancelStreamRequest(const Common::SharedPtr<AssetStreamRequest>& request);
+        AssetPtr<Asset> TouchResidentAsset(const Core::Uri& uri);
+        // must be called with stream mutex held, evicted assets are moved out to be released after unlock
+        void EvictOverBudget(std::vector<AssetPtr<Asset>>& outEvicted);
+
+        std::array<CacheShard, cacheShardNum> cacheShards;
+        std::mutex loadWaitMutex;
+        mutable std::mutex streamMutex;
+        std::set<Common::SharedPtr<AssetStreamRequest>, StreamRequestCompare> pendingStreamRequests;
+        std::unordered_map<Core::Uri, ResidentAsset> residentAssets;
+        // front is the most recently used
+        std::list<Core::Uri> residentLru;
+        uint64_t streamSequence;
+        AssetStreamingStats streamingStats;
         Common::ThreadPool threadPool;
     };
 }
@@ -147,7 +292,7 @@ namespace Common {
         {
             Core::Uri uri;
             const auto deserialized = Serializer<Core::Uri>::Deserialize(stream, uri);
-            value = Runtime::AssetManager::Get().SyncLoad<A>(uri);
+            value = Runtime::AssetManager::Get().LoadDependency<A>(uri);
             return deserialized;
         }
     };
@@ -485,19 +630,14 @@ namespace Runtime {
     template <Common::DerivedFrom<Asset> A>
     AssetPtr<A> AssetManager::SyncLoad(const Core::Uri& uri)
     {
-        auto iter = weakAssetRefs.find(uri);
-        if (iter != weakAssetRefs.end() && !iter->second.Expired()) {
-            return iter->second.Lock().StaticCast<A>();
+        AssetPtr<A> loaded;
+        bool created = false;
+        const auto task = AcquireLoadTask<A>(uri, loaded, created);
+        if (task == nullptr) {
+            return loaded;
         }
-
-        AssetPtr<A> result = LoadInternal<A>(uri);
-        AssetPtr<Asset> tempRef = result.template StaticCast<Asset>();
-        if (iter == weakAssetRefs.end()) {
-            weakAssetRefs.emplace(std::make_pair(uri, WeakAssetPtr<Asset>(tempRef)));
-        } else {
-            iter->second = tempRef;
-        }
-        return result;
+        WaitLoadTask(task);
+        return task->asset.template StaticCast<A>();
     }
 
     template <Common::DerivedFrom<Asset> A>
@@ -509,46 +649,63 @@ namespace Runtime {
     template <Common::DerivedFrom<Asset> A>
     void AssetManager::AsyncLoad(const Core::Uri& uri, const OnAssetLoaded<A>& onAssetLoaded)
     {
-        threadPool.EmplaceTask([=, this]() -> void {
-            AssetPtr<A> result = nullptr;
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                auto iter = weakAssetRefs.find(uri);
-                if (iter != weakAssetRefs.end() && !iter->second.Expired()) {
-                    result = iter->second.Lock().StaticCast<A>();
-                }
-            }
+        AssetPtr<A> loaded;
+        bool created = false;
+        auto task = AcquireLoadTask<A>(uri, loaded, created);
 
-            if (result == nullptr) {
-                result = LoadInternal<A>(uri);
+        threadPool.EmplaceDetachedTask([this, task = std::move(task), loaded, onAssetLoaded]() mutable -> void {
+            if (task != nullptr) {
+                WaitLoadTask(task);
+                loaded = task->asset.template StaticCast<A>();
             }
-
-            AssetPtr<Asset> tempRef = result.template StaticCast<Asset>();
-            {
-                std::unique_lock<std::mutex> lock(mutex);
-                auto iter = weakAssetRefs.find(uri);
-                if (iter == weakAssetRefs.end()) {
-                    weakAssetRefs.emplace(std::make_pair(uri, WeakAssetPtr<Asset>(tempRef)));
-                } else {
-                    iter->second = tempRef;
-                }
-            }
-
-            onAssetLoaded(result);
+            onAssetLoaded(loaded);
         });
     }
 
     template <Common::DerivedFrom<Asset> A>
     void AssetManager::AsyncLoadSoft(SoftAssetPtr<A>& softAssetRef, const OnSoftAssetLoaded<A>& onSoftAssetLoaded)
     {
-        threadPool.EmplaceTask([this, softAssetRef, onSoftAssetLoaded]() -> void {
-            AsyncLoad(softAssetRef.Uri(), [&](AssetPtr<A>& ref) -> void {
-                softAssetRef = ref;
-                onSoftAssetLoaded();
-            });
+        AsyncLoad<A>(softAssetRef.Uri(), [&softAssetRef, onSoftAssetLoaded](AssetPtr<A> ref) -> void {
+            softAssetRef = ref;
+            onSoftAssetLoaded();
         });
     }
 
+    template <Common::DerivedFrom<Asset> A>
+    AssetPtr<A> AssetManager::LoadDependency(const Core::Uri& uri)
+    {
+        AssetPtr<A> loaded;
+        bool created = false;
+        const auto task = AcquireLoadTask<A>(uri, loaded, created);
+        if (task == nullptr) {
+            return loaded;
+        }
+        if (!TryDeferLoadDependency(task, created)) {
+            WaitLoadTask(task);
+        }
+        return task->asset.template StaticCast<A>();
+    }
+
+    template <Common::DerivedFrom<Asset> A>
+    AssetStreamHandle AssetManager::StreamSoft(const SoftAssetPtr<A>& softAssetRef, AssetStreamPriority priority, const OnAssetLoaded<A>& onAssetLoaded)
+    {
+        std::function<void(AssetPtr<Asset>)> onLoaded;
+        if (onAssetLoaded) {
+            onLoaded = [onAssetLoaded](AssetPtr<Asset> asset) -> void {
+                onAssetLoaded(asset.template StaticCast<A>());
+            };
+        }
+        return SubmitStreamRequest(softAssetRef.Uri(), priority, [this, uri = softAssetRef.Uri()]() -> AssetPtr<Asset> {
+            return SyncLoad<A>(uri).template StaticCast<Asset>();
+        }, std::move(onLoaded));
+    }
+
+    template <Common::DerivedFrom<Asset> A>
+    AssetPtr<A> AssetManager::GetStreamed(const SoftAssetPtr<A>& softAssetRef)
+    {
+        return TouchResidentAsset(softAssetRef.Uri()).template StaticCast<A>();
+    }
+
     template <Common::DerivedFrom<Asset> A>
     void AssetManager::Save(const AssetPtr<A>& assetRef)
     {
@@ -556,11 +713,19 @@ namespace Runtime {
             return;
         }
 
+        // write aside and replace, a loaded asset may still map the old file, truncating it in place faults the reader
         const Core::AssetUriParser parser(assetRef.Uri());
-        Common::BinaryFileSerializeStream stream(parser.Parse().Absolute().String());
+        const std::string fileName = parser.Parse().Absolute().String();
+        const std::string tempFileName = fileName + ".tmp";
+        {
+            Common::BinaryFileSerializeStream stream(tempFileName);
+            Mirror::Any ref = std::ref(*assetRef.Get());
+            ref.Serialize(stream);
+        }
 
-        Mirror::Any ref = std::ref(*assetRef.Get());
-        ref.Serialize(stream);
+        std::error_code errorCode;
+        std::filesystem::rename(tempFileName, fileName, errorCode);
+        AssertWithReason(!errorCode, "failed to replace asset file");
     }
 
     template <Common::DerivedFrom<Asset> A>
@@ -570,17 +735,49 @@ namespace Runtime {
     }
 
     template <Common::DerivedFrom<Asset> A>
-    AssetPtr<A> AssetManager::LoadInternal(const Core::Uri& uri)
+    Common::SharedPtr<AssetManager::LoadTask> AssetManager::AcquireLoadTask(const Core::Uri& uri, AssetPtr<A>& outLoaded, bool& outCreated)
     {
-        const Core::AssetUriParser parser(uri);
-        Common::BinaryFileDeserializeStream stream(parser.Parse().Absolute().String());
+        auto& shard = GetCacheShard(uri);
+        std::unique_lock<std::mutex> lock(shard.mutex);
 
-        AssetPtr<A> result = Common::SharedPtr<A>(new A(uri));
-        Mirror::Any ref = std::ref(*result.Get());
-        ref.Deserialize(stream);
+        if (const auto iter = shard.cachedAssets.find(uri);
+            iter != shard.cachedAssets.end() && !iter->second.asset.Expired()) {
+            CheckRequestedClass(iter->second.assetClass, &Mirror::Class::Get<A>());
+            outLoaded = iter->second.asset.Lock().template StaticCast<A>();
+            return nullptr;
+        }
+        if (const auto iter = shard.loadTasks.find(uri);
+            iter != shard.loadTasks.end()) {
+            // the task is typed by the first requester, the asset is static casted to A once it is loaded
+            CheckRequestedClass(iter->second->assetClass, &Mirror::Class::Get<A>());
+            outCreated = false;
+            return iter->second;
+        }
 
-        // reset uri is useful for moved asset
-        result->uri = uri;
-        return result;
+        AssetPtr<A> asset = Common::SharedPtr<A>(new A(uri));
+        Common::SharedPtr<LoadTask> task = Common::MakeShared<LoadTask>();
+        task->uri = uri;
+        task->asset = asset.template StaticCast<Asset>();
+        task->assetClass = &Mirror::Class::Get<A>();
+        task->deserializer = [asset, uri]() -> size_t {
+            const Core::AssetUriParser parser(uri);
+            // editor saves assets over the files they are loaded from, so only game builds borrow bulk data in place
+            Common::MappedFileDeserializeStream stream(parser.Parse().Absolute().String(), !BUILD_EDITOR);
+
+            Mirror::Any ref = std::ref(*asset.Get());
+            ref.Deserialize(stream);
+
+            // reset uri is useful for moved asset
+            asset->uri = uri;
+            return stream.Loc();
+        };
+        task->residentSize = 0;
+        task->started = false;
+        task->waitingOn = nullptr;
+        task->future = task->promise.get_future().share();
+
+        shard.loadTasks.emplace(uri, task);
+        outCreated = true;
+        return task;
     }
 }
@@ -16,12 +16,14 @@ namespace Runtime {
 
         EProperty() uint32_t vertexCount;
         EProperty() uint32_t indexCount;
-        EProperty() std::vector<Common::FVec3> positions;
-        EProperty() std::vector<Common::FVec3> tangents;
-        EProperty() std::vector<Common::FVec2> uv0;
+        // in non-editor builds vertex streams of a loaded mesh view the mapped asset file in place, editor builds copy
+        // them, as the editor saves assets over the files they are loaded from
+        EProperty() Common::BulkArray<Common::FVec3> positions;
+        EProperty() Common::BulkArray<Common::FVec3> tangents;
+        EProperty() Common::BulkArray<Common::FVec2> uv0;
         // optional
-        EProperty() std::vector<Common::FVec2> uv1;
-        EProperty() std::vector<Common::FVec3> colors;
+        EProperty() Common::BulkArray<Common::FVec2> uv1;
+        EProperty() Common::BulkArray<Common::FVec3> colors;
     };
 
     struct RUNTIME_API EClass() StaticMeshLOD {
@@ -5,6 +5,9 @@
 #pragma once
 
 #include <set>
+#include <array>
+#include <mutex>
+#include <iterator>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -15,8 +18,14 @@
 #include <Runtime/Meta.h>
 #include <Runtime/Api.h>
 
+namespace tf {
+    class Taskflow;
+}
+
 namespace Runtime {
-    using Entity = uint32_t;
+    // low 32 bits are the index of entity slot, high 32 bits are the generation of slot, so a destroyed entity handle is never
+    // valid again even if its slot is reused
+    using Entity = uint64_t;
     static constexpr Entity entityNull = 0;
 
     using CompClass = const Mirror::Class*;
@@ -45,7 +54,10 @@ namespace Runtime {
 
 namespace Runtime::Internal {
     using ArchetypeId = Mirror::TypeId;
-    using ElemPtr = void*;
+    using ArchetypeIndex = size_t;
+    using CompPtr = void*;
+    using ElemIndex = size_t;
+    static constexpr ArchetypeIndex archetypeIndexNull = std::numeric_limits<ArchetypeIndex>::max();
 
     template <typename T> const Mirror::Class* GetClass();
     template <typename T> struct MemberFuncPtrTraits;
@@ -54,42 +66,66 @@ namespace Runtime::Internal {
     public:
         explicit CompRtti(CompClass inClass);
         void Bind(size_t inOffset);
-        Mirror::Any MoveConstruct(ElemPtr inElem, const Mirror::Any& inOther) const;
-        Mirror::Any MoveAssign(ElemPtr inElem, const Mirror::Any& inOther) const;
-        void Destruct(ElemPtr inElem) const;
-        Mirror::Any Get(ElemPtr inElem) const;
+        Mirror::Any MoveConstruct(CompPtr inComp, const Mirror::Any& inOther) const;
+        Mirror::Any CopyConstruct(CompPtr inComp, const Mirror::Any& inOther) const;
+        Mirror::Any MoveAssign(CompPtr inComp, const Mirror::Any& inOther) const;
+        void Destruct(CompPtr inComp) const;
+        Mirror::Any Get(CompPtr inComp) const;
         CompClass Class() const;
+        // offset of the component column from chunk begin
         size_t Offset() const;
         size_t MemorySize() const;
 
     private:
-        using MoveConstructFunc = Mirror::Any(ElemPtr, size_t, const Mirror::Any&);
-        using MoveAssignFunc = Mirror::Any(ElemPtr, size_t, const Mirror::Any&);
-        using DestructorFunc = void(ElemPtr, size_t);
-        using GetFunc = Mirror::Any(ElemPtr, size_t);
-
         CompClass clazz;
+        size_t size;
+        const Mirror::Constructor* moveCtor;
+        const Mirror::Constructor* copyCtor;
         // runtime, need Bind()
         bool bound;
         size_t offset;
     };
 
+    // entities are stored in fixed size chunks, each chunk holds one contiguous column per component, so adding elements
+    // never relocates existing ones, elements are indexed globally as chunkIndex * chunkCapacity + indexInChunk
     class RUNTIME_API Archetype {
     public:
+        static constexpr size_t chunkBytes = 16 * 1024;
+        static constexpr size_t columnAlignment = alignof(std::max_align_t);
+
         explicit Archetype(const std::vector<CompRtti>& inRttiVec);
+        ~Archetype();
+
+        Archetype(const Archetype& inOther);
+        Archetype(Archetype&& inOther) noexcept;
+        Archetype& operator=(const Archetype& inOther);
+        Archetype& operator=(Archetype&& inOther) noexcept;
 
         bool Contains(CompClass inClazz) const;
         bool ContainsAll(const std::vector<CompClass>& inClasses) const;
         bool NotContainsAny(const std::vector<CompClass>& inClasses) const;
-        ElemPtr EmplaceElem(Entity inEntity);
-        ElemPtr EmplaceElem(Entity inEntity, ElemPtr inSrcElem, const std::vector<CompRtti>& inSrcRttiVec);
-        Mirror::Any EmplaceComp(Entity inEntity, CompClass inCompClass, const Mirror::Any& inCompRef);
-        void EraseElem(Entity inEntity);
-        ElemPtr GetElem(Entity inEntity) const;
-        Mirror::Any GetComp(Entity inEntity, CompClass inCompClass);
-        Mirror::Any GetComp(Entity inEntity, CompClass inCompClass) const;
+        ElemIndex EmplaceElem(Entity inEntity);
+        ElemIndex EmplaceElem(Entity inEntity, Archetype& inSrcArchetype, ElemIndex inSrcElem);
+        // appends rows for all entities at once without constructing components, returns the first new element
+        ElemIndex EmplaceElems(const std::vector<Entity>& inEntities);
+        // raw copy of a component column between elements [inBegin, inBegin + inNum) and contiguous memory,
+        // only valid for trivially copyable components
+        void ReadColumn(CompClass inCompClass, ElemIndex inBegin, size_t inNum, uint8_t* outData) const;
+        void WriteColumn(CompClass inCompClass, ElemIndex inBegin, size_t inNum, const uint8_t* inData);
+        Mirror::Any EmplaceComp(ElemIndex inElem, CompClass inCompClass, const Mirror::Any& inCompRef);
+        // swap-remove, returns the entity moved into inElem, or entityNull if inElem was the last element
+        Entity EraseElem(ElemIndex inElem);
+        Mirror::Any GetComp(ElemIndex inElem, CompClass inCompClass);
+        Mirror::Any GetComp(ElemIndex inElem, CompClass inCompClass) const;
         size_t Count() const;
-        auto All() const;
+        const std::vector<Entity>& All() const;
+        size_t ChunkNum() const;
+        size_t ChunkCapacity() const;
+        size_t ChunkElemCount(size_t inChunkIndex) const;
+        const Entity* ChunkEntities(size_t inChunkIndex) const;
+        uint8_t* ChunkBegin(size_t inChunkIndex) const;
+        size_t ColumnOffset(CompClass inCompClass) const;
+        CompPtr ChunkColumn(size_t inChunkIndex, CompClass inCompClass) const;
         const std::vector<CompRtti>& GetRttiVec() const;
         ArchetypeId Id() const;
         std::vector<CompRtti> NewRttiVecByAdd(const CompRtti& inRtti) const;
@@ -97,30 +133,49 @@ namespace Runtime::Internal {
 
     private:
         using CompRttiIndex = size_t;
-        using ElemIndex = size_t;
 
         const CompRtti* FindCompRtti(CompClass clazz) const;
         const CompRtti& GetCompRtti(CompClass clazz) const;
-        size_t Capacity() const;
-        void Reserve(float inRatio = 1.5f);
-        ElemPtr AllocateNewElemBack();
-        ElemPtr ElemAt(std::vector<uint8_t>& inMemory, size_t inIndex) const;
-        ElemPtr ElemAt(size_t inIndex) const;
+        size_t ComputeChunkMemorySize(size_t inChunkCapacity) const;
+        void BuildLayout();
+        CompPtr CompAt(const CompRtti& inRtti, ElemIndex inIndex) const;
+        ElemIndex AllocateNewElemBack();
+        void CopyElemsFrom(const Archetype& inOther);
+        void DestructAllElems();
 
         ArchetypeId id;
         size_t count;
-        size_t elemSize;
+        size_t chunkCapacity;
+        size_t chunkMemorySize;
         std::vector<CompRtti> rttiVec;
         std::unordered_map<CompClass, CompRttiIndex> rttiMap;
-        std::unordered_map<Entity, ElemIndex> entityMap;
-        std::unordered_map<ElemIndex, Entity> elemMap;
-        std::vector<uint8_t> memory;
+        std::vector<Entity> entities;
+        std::vector<std::vector<uint8_t>> chunks;
     };
 
+    using ArchetypeList = std::vector<Archetype>;
+
+    struct ChunkBatch {
+        const Archetype* archetype;
+        size_t chunkIndex;
+    };
+
+    // runs inTask(batchIndex) for each batch on game worker threads, falls back to calling thread if workers not started
+    RUNTIME_API void ParallelFor(size_t inBatchNum, const std::function<void(size_t)>& inTask);
+
+    // dense entity table, slot i holds the generation and the archetype location of entity with index i, allocate, free
+    // and lookup are all O(1), freed slots are recycled with generation increased
     class EntityPool {
     public:
         using EntityTraverseFunc = std::function<void(Entity)>;
-        using ConstIter = std::set<Entity>::const_iterator;
+        using ConstIter = std::vector<Entity>::const_iterator;
+
+        // the highest bit of generation is never used by pool, CommandBuffer uses it to mark placeholder entities
+        static constexpr uint32_t generationMask = 0x7fffffff;
+
+        static uint32_t GetIndex(Entity inEntity);
+        static uint32_t GetGeneration(Entity inEntity);
+        static Entity MakeEntity(uint32_t inIndex, uint32_t inGeneration);
 
         EntityPool();
 
@@ -131,19 +186,34 @@ namespace Runtime::Internal {
         void Free(Entity inEntity);
         void Clear();
         void Each(const EntityTraverseFunc& inFunc) const;
-        void SetArchetype(Entity inEntity, ArchetypeId inArchetypeId);
-        ArchetypeId GetArchetype(Entity inEntity) const;
+        void SetLocation(Entity inEntity, ArchetypeIndex inArchetypeIndex, ElemIndex inElemIndex);
+        void SetElem(Entity inEntity, ElemIndex inElemIndex);
+        ArchetypeIndex GetArchetype(Entity inEntity) const;
+        ElemIndex GetElem(Entity inEntity) const;
         ConstIter Begin() const;
         ConstIter End() const;
 
     private:
-        uint32_t counter;
-        std::set<Entity> free;
-        std::set<Entity> allocated;
-        std::unordered_map<Entity, ArchetypeId> archetypeMap;
+        static constexpr uint32_t aliveIndexNull = UINT32_MAX;
+
+        struct Slot {
+            uint32_t generation;
+            // index in alive list, aliveIndexNull if slot is free
+            uint32_t aliveIndex;
+            ArchetypeIndex archetypeIndex;
+            ElemIndex elemIndex;
+        };
+
+        void EnsureSlot(uint32_t inIndex);
+        void MarkAlive(uint32_t inIndex);
+
+        std::vector<Slot> slots;
+        // may contain indices already reused by Allocate(Entity), they are skipped when popped
+        std::vector<uint32_t> freeIndices;
+        std::vector<Entity> alive;
     };
 
-    class SystemFactory {
+    class RUNTIME_API SystemFactory {
     public:
         explicit SystemFactory(SystemClass inClass);
         Common::UniquePtr<System> Build(ECRegistry& inRegistry, const SystemSetupContext& inSetupContext) const;
@@ -151,11 +221,30 @@ namespace Runtime::Internal {
         const std::unordered_map<std::string, Mirror::Any>& GetArguments() const;
         SystemClass GetClass() const;
 
+        // component (and global component) access declaration, systems without any declaration are treated as touching everything
+        template <typename C> SystemFactory& Reads();
+        template <typename C> SystemFactory& Writes();
+        SystemFactory& ReadsDyn(CompClass inClass);
+        SystemFactory& WritesDyn(CompClass inClass);
+        // structural changes mutate storage shared by all components, so structural systems are ordered against all others,
+        // declared systems without it must not make structural changes while the pipeline performs
+        SystemFactory& WritesStructure();
+        bool HasAccessDeclared() const;
+        bool HasStructuralWrites() const;
+        const std::unordered_set<CompClass>& GetReads() const;
+        const std::unordered_set<CompClass>& GetWrites() const;
+        bool ConflictsWith(const SystemFactory& inOther) const;
+
     private:
         void BuildArgumentLists();
+        void BuildAccessesFromMeta();
 
         SystemClass clazz;
         std::unordered_map<std::string, Mirror::Any> arguments;
+        bool accessDeclared;
+        bool structuralWrites;
+        std::unordered_set<CompClass> reads;
+        std::unordered_set<CompClass> writes;
     };
 }
 
@@ -231,22 +320,72 @@ namespace Runtime {
 
     template <typename... T>
     struct Exclude {};
+}
+
+namespace Runtime::Internal {
+    template <typename... T>
+    struct StaticArchetypeFilter;
+
+    template <typename... C, typename... E>
+    struct StaticArchetypeFilter<Exclude<E...>, C...> {
+        using ColumnOffsets = std::array<size_t, sizeof...(C)>;
+
+        static bool Match(const Archetype& inArchetype);
+        static ColumnOffsets GetColumnOffsets(const Archetype& inArchetype);
+        template <typename F> static void EachInArchetype(const Archetype& inArchetype, F&& inFunc);
+        template <typename F> static void ParallelEachInBatches(const std::vector<ChunkBatch>& inBatches, F&& inFunc);
+
+    private:
+        template <typename F, size_t... I> static void EachInChunk(const Archetype& inArchetype, size_t inChunkIndex, const ColumnOffsets& inColumnOffsets, F&& inFunc, std::index_sequence<I...>);
+    };
+}
+
+namespace Runtime {
 
     template <typename... T>
     class BasicView;
 
+    // views iterate archetype chunks in place and allocate nothing, component pointers are resolved once per archetype
+    // chunk, structural changes (create, destroy, emplace, remove) are not allowed while iterating
     template <ECRegistryOrConst R, typename... C, typename... E>
     class BasicView<R, Exclude<E...>, C...> {
     public:
-        using ResultVector = std::vector<std::tuple<Entity, C&...>>;
-        using ConstIter = typename ResultVector::const_iterator;
+        using ValueType = std::tuple<Entity, C&...>;
+
+        class ConstIter {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = ValueType;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = ValueType;
+
+            ConstIter(const BasicView& inView, Internal::ArchetypeList::const_iterator inArchetypeIter);
+
+            ValueType operator*() const;
+            ConstIter& operator++();
+            ConstIter operator++(int);
+            bool operator==(const ConstIter& inOther) const;
+            bool operator!=(const ConstIter& inOther) const;
+
+        private:
+            template <size_t... I> ValueType Deref(std::index_sequence<I...>) const;
+            void SeekValid();
+
+            const BasicView* view;
+            Internal::ArchetypeList::const_iterator archetypeIter;
+            Internal::ElemIndex elemIndex;
+            std::array<size_t, sizeof...(C)> columnOffsets;
+        };
 
         explicit BasicView(R& inRegistry);
         NonCopyable(BasicView)
         NonMovable(BasicView)
 
         template <typename F> void Each(F&& inFunc) const;
-        const ResultVector& All() const;
+        // one chunk per batch, inFunc can write components of the entity it receives but must record structural changes
+        // into a CommandBuffer and play it back after iteration
+        template <typename F> void ParallelEach(F&& inFunc) const;
         size_t Count() const;
         ConstIter Begin() const;
         ConstIter End() const;
@@ -254,14 +393,45 @@ namespace Runtime {
         ConstIter end() const;
 
     private:
-        void Evaluate(R& inRegistry);
+        using Filter = Internal::StaticArchetypeFilter<Exclude<E...>, C...>;
 
-        ResultVector result;
+        const Internal::ArchetypeList& archetypes;
     };
 
     template <typename R, typename E, typename... C> using View = BasicView<R, E, C...>;
     template <typename R, typename E, typename... C> using ConstView = BasicView<const R, E, const C...>;
 
+    template <typename... T>
+    class BasicQuery;
+
+    // query caches the archetypes matching its filter, and rescans registry only after new archetypes were created,
+    // prefer it over view for iteration running every tick, e.g. as a member of system
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    class BasicQuery<R, Exclude<E...>, C...> {
+    public:
+        explicit BasicQuery(R& inRegistry);
+        NonCopyable(BasicQuery)
+        NonMovable(BasicQuery)
+
+        template <typename F> void Each(F&& inFunc);
+        template <typename F> void ParallelEach(F&& inFunc);
+        size_t Count();
+        size_t ArchetypeNum();
+
+    private:
+        using Filter = Internal::StaticArchetypeFilter<Exclude<E...>, C...>;
+
+        void Refresh();
+        void Rescan();
+
+        R& registry;
+        uint64_t archetypeVersion;
+        std::vector<const Internal::Archetype*> archetypes;
+    };
+
+    template <typename R, typename E, typename... C> using Query = BasicQuery<R, E, C...>;
+    template <typename R, typename E, typename... C> using ConstQuery = BasicQuery<const R, E, const C...>;
+
     class RUNTIME_API RuntimeFilter {
     public:
         RuntimeFilter();
@@ -280,8 +450,29 @@ namespace Runtime {
     template <ECRegistryOrConst R>
     class BasicRuntimeView {
     public:
-        using ResultEntitiesVector = std::vector<Entity>;
-        using ConstIter = typename ResultEntitiesVector::const_iterator;
+        class ConstIter {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Entity;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Entity;
+
+            ConstIter(const BasicRuntimeView& inView, Internal::ArchetypeList::const_iterator inArchetypeIter);
+
+            Entity operator*() const;
+            ConstIter& operator++();
+            ConstIter operator++(int);
+            bool operator==(const ConstIter& inOther) const;
+            bool operator!=(const ConstIter& inOther) const;
+
+        private:
+            void SeekValid();
+
+            const BasicRuntimeView* view;
+            Internal::ArchetypeList::const_iterator archetypeIter;
+            Internal::ElemIndex elemIndex;
+        };
 
         explicit BasicRuntimeView(R& inRegistry, const RuntimeFilter& inFilter);
         NonCopyable(BasicRuntimeView)
@@ -295,15 +486,12 @@ namespace Runtime {
         ConstIter end() const;
 
     private:
-        using ResultVector = std::vector<std::pair<Entity, std::vector<Mirror::Any>>>;
+        template <typename F, typename ArgTuple, size_t... I> void EachInChunk(F&& inFunc, const Internal::Archetype& inArchetype, size_t inChunkIndex, std::index_sequence<I...>) const;
+        bool Match(const Internal::Archetype& inArchetype) const;
 
-        template <typename F, typename ArgTuple, size_t... I> void InvokeTraverseFuncInternal(F&& inFunc, const std::pair<Entity, std::vector<Mirror::Any>>& inEntityAndComps, std::index_sequence<I...>) const;
-        template <typename C> decltype(auto) GetCompRef(const std::vector<Mirror::Any>& inComps) const;
-        void Evaluate(R& inRegistry, const RuntimeFilter& inFilter);
-
-        std::unordered_map<CompClass, size_t> slotMap;
-        ResultEntitiesVector resultEntities;
-        ResultVector result;
+        const Internal::ArchetypeList& archetypes;
+        std::vector<CompClass> includes;
+        std::vector<CompClass> excludes;
     };
 
     using RuntimeView = BasicRuntimeView<ECRegistry>;
@@ -409,16 +597,39 @@ namespace Runtime {
         Observer removedObserver;
     };
 
-    struct RUNTIME_API EClass() EntityArchive {
-        EClassBody(EntityArchive)
+    struct RUNTIME_API EClass() CompMemberLayout {
+        EClassBody(CompMemberLayout)
+
+        EProperty() std::string name;
+        EProperty() std::string typeName;
+        EProperty() uint64_t offset;
+        EProperty() uint64_t size;
+    };
 
-        EProperty() std::unordered_map<CompClass, std::vector<uint8_t>> comps;
+    struct RUNTIME_API EClass() CompColumnArchive {
+        EClassBody(CompColumnArchive)
+
+        EProperty() CompClass clazz;
+        // not zero if data is raw memory of the whole column, when it matches the component layout hash the column is
+        // copied directly, otherwise the members still existing with the same name and type are copied one by one by
+        // elemSize and members, if zero data is the serialized components one by one
+        EProperty() uint64_t layoutHash;
+        EProperty() uint64_t elemSize;
+        EProperty() std::vector<CompMemberLayout> members;
+        EProperty() std::vector<uint8_t> data;
+    };
+
+    struct RUNTIME_API EClass() ArchetypeArchive {
+        EClassBody(ArchetypeArchive)
+
+        EProperty() std::vector<Entity> entities;
+        EProperty() std::vector<CompColumnArchive> columns;
     };
 
     struct RUNTIME_API EClass() ECArchive {
         EClassBody(ECArchive)
 
-        EProperty() std::unordered_map<Entity, EntityArchive> entities;
+        EProperty() std::vector<ArchetypeArchive> archetypes;
         EProperty() std::unordered_map<GCompClass, std::vector<uint8_t>> globalComps;
     };
 
@@ -481,6 +692,9 @@ namespace Runtime {
         template <typename... C, typename... E> Runtime::View<ECRegistry, Exclude<E...>, C...> View(Exclude<E...> = {});
         template <typename... C, typename... E> Runtime::ConstView<ECRegistry, Exclude<E...>, C...> View(Exclude<E...> = {}) const;
         template <typename... C, typename... E> Runtime::ConstView<ECRegistry, Exclude<E...>, C...> ConstView(Exclude<E...> = {}) const;
+        template <typename... C, typename... E> Runtime::Query<ECRegistry, Exclude<E...>, C...> Query(Exclude<E...> = {});
+        template <typename... C, typename... E> Runtime::ConstQuery<ECRegistry, Exclude<E...>, C...> Query(Exclude<E...> = {}) const;
+        template <typename... C, typename... E> Runtime::ConstQuery<ECRegistry, Exclude<E...>, C...> ConstQuery(Exclude<E...> = {}) const;
         template <typename C> CompEvents& Events();
         template <typename C> EventsObserver<C> EventsObserver();
 
@@ -541,21 +755,95 @@ namespace Runtime {
 
     private:
         template <typename... T> friend class BasicView;
+        template <typename... T> friend class BasicQuery;
         template <ECRegistryOrConst R> friend class BasicRuntimeView;
+        friend class CommandBuffer;
 
         void NotifyConstructedDyn(CompClass inClass, Entity inEntity);
         void NotifyRemoveDyn(CompClass inClass, Entity inEntity);
         void GNotifyConstructedDyn(GCompClass inClass);
         void GNotifyRemoveDyn(CompClass inClass);
+        Internal::ArchetypeIndex FindArchetype(Internal::ArchetypeId inId) const;
+        Internal::ArchetypeIndex EmplaceArchetype(const std::vector<Internal::CompRtti>& inRttiVec);
+        void MoveElem(Entity inEntity, Internal::ArchetypeIndex inDstArchetypeIndex);
+        void EraseElem(Entity inEntity);
 
         Internal::EntityPool entities;
         std::unordered_map<GCompClass, Mirror::Any> globalComps;
-        std::unordered_map<Internal::ArchetypeId, Internal::Archetype> archetypes;
+        Internal::ArchetypeList archetypes;
+        std::unordered_map<Internal::ArchetypeId, Internal::ArchetypeIndex> archetypeIndexMap;
+        // increased each time archetypes are created or replaced, queries rescan archetypes only when it changed
+        uint64_t archetypeVersion;
         // transients, not copy or move
         std::unordered_map<CompClass, CompEvents> compEvents;
         std::unordered_map<GCompClass, GCompEvents> globalCompEvents;
     };
 
+    // records structural changes from any thread (e.g. inside ParallelEach) and applies them when Playback() is called on
+    // the owner thread of registry. playback merges all changes of one entity and groups entities by target archetype, so
+    // each entity is migrated at most once no matter how many components were added or removed. entities returned by
+    // Create() are placeholders only valid for commands of this buffer, use GetCreated() after playback to get the real one
+    class RUNTIME_API CommandBuffer {
+    public:
+        CommandBuffer();
+        ~CommandBuffer();
+
+        NonCopyable(CommandBuffer)
+        NonMovable(CommandBuffer)
+
+        Entity Create();
+        void Destroy(Entity inEntity);
+        template <typename C, typename... Args> void Emplace(Entity inEntity, Args&&... inArgs);
+        template <typename C> void Remove(Entity inEntity);
+        void EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs);
+        void RemoveDyn(CompClass inClass, Entity inEntity);
+        size_t Count() const;
+        bool Empty() const;
+        void Playback(ECRegistry& inRegistry);
+        Entity GetCreated(Entity inPlaceholder) const;
+        void Clear();
+
+    private:
+        static constexpr Entity placeholderBit = 1ull << 63;
+
+        enum class CommandType : uint8_t {
+            create,
+            destroy,
+            emplace,
+            remove,
+            max
+        };
+
+        struct Command {
+            CommandType type;
+            Entity entity;
+            CompClass clazz;
+            Mirror::Any comp;
+        };
+
+        struct EntityChanges {
+            explicit EntityChanges(Entity inEntity);
+
+            Entity entity;
+            bool created;
+            bool destroyed;
+            Internal::ArchetypeIndex srcArchetypeIndex;
+            Internal::ArchetypeId dstArchetypeId;
+            std::vector<std::pair<CompClass, Mirror::Any>> adds;
+            std::vector<CompClass> removes;
+        };
+
+        static bool IsPlaceholder(Entity inEntity);
+        void Record(Command&& inCommand);
+        std::vector<EntityChanges> MergeCommands(ECRegistry& inRegistry, std::vector<Command>& inCommands);
+        static void ApplyChanges(ECRegistry& inRegistry, std::vector<EntityChanges>& inChanges);
+
+        mutable std::mutex mutex;
+        std::vector<Command> commands;
+        Entity placeholderCounter;
+        std::unordered_map<Entity, Entity> createdEntities;
+    };
+
     enum class SystemExecuteStrategy : uint8_t {
         sequential,
         concurrent,
@@ -613,27 +901,56 @@ namespace Runtime {
         std::vector<SystemGroup> systemGroups;
     };
 
-    class SystemPipeline {
+    struct SystemPipelineStats {
+        SystemPipelineStats();
+
+        uint64_t performCount;
+        // wall time of the last whole pipeline perform
+        uint64_t lastWallTimeUs;
+        // longest dependency chain of system execution time in the last perform
+        uint64_t lastCriticalPathTimeUs;
+        // wall time not spent on the critical path, aka dispatch, wake up and join cost
+        uint64_t lastScheduleOverheadUs;
+        uint64_t maxScheduleOverheadUs;
+    };
+
+    // systems of all groups are flattened into one dependency graph by their declaration order, two systems are ordered if:
+    // 1. they are not in the same concurrent group, and
+    // 2. any of them has no access declared, or their declared accesses conflict (write-read or write-write)
+    class RUNTIME_API SystemPipeline {
     public:
         explicit SystemPipeline(const SystemGraph& inGraph);
+        ~SystemPipeline();
+
+        NonCopyable(SystemPipeline)
+        NonMovable(SystemPipeline)
+
+        const SystemPipelineStats& GetStats() const;
+        size_t GetSystemNum() const;
+        size_t GetDependencyNum() const;
 
     private:
         struct SystemContext {
             const Internal::SystemFactory& factory;
             Common::UniquePtr<System> instance;
-        };
-
-        struct SystemGroupContext {
-            std::vector<SystemContext> systems;
-            SystemExecuteStrategy strategy;
+            // indices of systems need to be finished before this one, transitive reduced
+            std::vector<size_t> dependencies;
+            uint64_t lastExecuteTimeUs;
         };
 
         friend class SystemGraphExecutor;
         using ActionFunc = std::function<void(SystemContext&)>;
 
+        void BuildDependencies(const std::vector<std::pair<size_t, SystemExecuteStrategy>>& inSystemGroups);
+        void Compile();
         void ParallelPerformAction(const ActionFunc& inActionFunc);
+        void UpdateStats(uint64_t inWallTimeUs);
 
-        std::vector<SystemGroupContext> systemGraph;
+        std::vector<SystemContext> systems;
+        // compiled once when graph is set, replayed by each perform
+        Common::UniquePtr<tf::Taskflow> taskflow;
+        const ActionFunc* currentAction;
+        SystemPipelineStats stats;
     };
 
     enum class PlayType : uint8_t {
@@ -658,6 +975,7 @@ namespace Runtime {
         NonMovable(SystemGraphExecutor)
 
         void Tick(float inDeltaTimeSeconds);
+        const SystemPipelineStats& GetPipelineStats() const;
 
     private:
         ECRegistry& ecRegistry;
@@ -687,9 +1005,66 @@ namespace Runtime::Internal {
         using ArgsTupleType = std::tuple<Args...>;
     };
 
-    inline auto Archetype::All() const
+    template <typename... C, typename... E>
+    bool StaticArchetypeFilter<Exclude<E...>, C...>::Match(const Archetype& inArchetype)
+    {
+        return (inArchetype.Contains(GetClass<std::decay_t<C>>()) && ...) && !(inArchetype.Contains(GetClass<E>()) || ...);
+    }
+
+    template <typename... C, typename... E>
+    typename StaticArchetypeFilter<Exclude<E...>, C...>::ColumnOffsets StaticArchetypeFilter<Exclude<E...>, C...>::GetColumnOffsets(const Archetype& inArchetype)
+    {
+        return { inArchetype.ColumnOffset(GetClass<std::decay_t<C>>())... };
+    }
+
+    template <typename... C, typename... E>
+    template <typename F>
+    void StaticArchetypeFilter<Exclude<E...>, C...>::EachInArchetype(const Archetype& inArchetype, F&& inFunc)
+    {
+        const auto columnOffsets = GetColumnOffsets(inArchetype);
+        for (auto i = 0; i < inArchetype.ChunkNum(); i++) {
+            EachInChunk(inArchetype, i, columnOffsets, std::forward<F>(inFunc), std::index_sequence_for<C...> {});
+        }
+    }
+
+    template <typename... C, typename... E>
+    template <typename F>
+    void StaticArchetypeFilter<Exclude<E...>, C...>::ParallelEachInBatches(const std::vector<ChunkBatch>& inBatches, F&& inFunc)
+    {
+        ParallelFor(inBatches.size(), [&](size_t inBatchIndex) -> void {
+            const auto& [archetype, chunkIndex] = inBatches[inBatchIndex];
+            EachInChunk(*archetype, chunkIndex, GetColumnOffsets(*archetype), inFunc, std::index_sequence_for<C...> {});
+        });
+    }
+
+    template <typename... C, typename... E>
+    template <typename F, size_t... I>
+    void StaticArchetypeFilter<Exclude<E...>, C...>::EachInChunk(const Archetype& inArchetype, size_t inChunkIndex, const ColumnOffsets& inColumnOffsets, F&& inFunc, std::index_sequence<I...>)
     {
-        return elemMap | std::ranges::views::values;
+        const Entity* entities = inArchetype.ChunkEntities(inChunkIndex);
+        const auto elemCount = inArchetype.ChunkElemCount(inChunkIndex);
+        uint8_t* chunkBegin = inArchetype.ChunkBegin(inChunkIndex);
+        const std::tuple<C*...> columns { reinterpret_cast<C*>(chunkBegin + inColumnOffsets[I])... };
+
+        for (auto i = 0; i < elemCount; i++) {
+            if constexpr (MemberFuncPtrTraits<decltype(&std::decay_t<F>::operator())>::ArgSize == 1) {
+                inFunc(entities[i]);
+            } else {
+                inFunc(entities[i], std::get<I>(columns)[i]...);
+            }
+        }
+    }
+
+    template <typename C>
+    SystemFactory& SystemFactory::Reads()
+    {
+        return ReadsDyn(GetClass<C>());
+    }
+
+    template <typename C>
+    SystemFactory& SystemFactory::Writes()
+    {
+        return WritesDyn(GetClass<C>());
     }
 } // namespace Runtime::Internal
 
@@ -745,47 +1120,133 @@ namespace Runtime {
         return globalCompRef.As<T>();
     }
 
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    BasicView<R, Exclude<E...>, C...>::ConstIter::ConstIter(const BasicView& inView, Internal::ArchetypeList::const_iterator inArchetypeIter)
+        : view(&inView)
+        , archetypeIter(inArchetypeIter)
+        , elemIndex(0)
+        , columnOffsets()
+    {
+        SeekValid();
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    typename BasicView<R, Exclude<E...>, C...>::ValueType BasicView<R, Exclude<E...>, C...>::ConstIter::operator*() const
+    {
+        return Deref(std::index_sequence_for<C...> {});
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    typename BasicView<R, Exclude<E...>, C...>::ConstIter& BasicView<R, Exclude<E...>, C...>::ConstIter::operator++()
+    {
+        if (++elemIndex < archetypeIter->Count()) {
+            return *this;
+        }
+        ++archetypeIter;
+        elemIndex = 0;
+        SeekValid();
+        return *this;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    typename BasicView<R, Exclude<E...>, C...>::ConstIter BasicView<R, Exclude<E...>, C...>::ConstIter::operator++(int)
+    {
+        const auto result = *this;
+        ++*this;
+        return result;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    bool BasicView<R, Exclude<E...>, C...>::ConstIter::operator==(const ConstIter& inOther) const
+    {
+        return archetypeIter == inOther.archetypeIter && elemIndex == inOther.elemIndex;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    bool BasicView<R, Exclude<E...>, C...>::ConstIter::operator!=(const ConstIter& inOther) const
+    {
+        return !(*this == inOther);
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    template <size_t... I>
+    typename BasicView<R, Exclude<E...>, C...>::ValueType BasicView<R, Exclude<E...>, C...>::ConstIter::Deref(std::index_sequence<I...>) const
+    {
+        const auto& archetype = *archetypeIter;
+        const auto chunkIndex = elemIndex / archetype.ChunkCapacity();
+        const auto indexInChunk = elemIndex % archetype.ChunkCapacity();
+        uint8_t* chunkBegin = archetype.ChunkBegin(chunkIndex);
+        return ValueType { archetype.All()[elemIndex], reinterpret_cast<C*>(chunkBegin + columnOffsets[I])[indexInChunk]... };
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    void BasicView<R, Exclude<E...>, C...>::ConstIter::SeekValid()
+    {
+        const auto archetypeEnd = view->archetypes.end();
+        for (; archetypeIter != archetypeEnd; ++archetypeIter) {
+            const auto& archetype = *archetypeIter;
+            if (archetype.Count() > 0 && Filter::Match(archetype)) {
+                columnOffsets = Filter::GetColumnOffsets(archetype);
+                return;
+            }
+        }
+    }
+
     template <ECRegistryOrConst R, typename ... C, typename ... E>
     BasicView<R, Exclude<E...>, C...>::BasicView(R& inRegistry)
+        : archetypes(inRegistry.archetypes)
     {
-        Evaluate(inRegistry);
     }
 
     template <ECRegistryOrConst R, typename... C, typename... E>
     template <typename F>
     void BasicView<R, Exclude<E...>, C...>::Each(F&& inFunc) const
     {
-        for (const auto& entityAndComps : result) {
-            if constexpr (Internal::MemberFuncPtrTraits<decltype(&F::operator())>::ArgSize == 1) {
-                inFunc(std::get<0>(entityAndComps));
-            } else {
-                std::apply(inFunc, entityAndComps);
+        for (const auto& archetype : archetypes) {
+            if (Filter::Match(archetype)) {
+                Filter::EachInArchetype(archetype, std::forward<F>(inFunc));
             }
         }
     }
 
     template <ECRegistryOrConst R, typename... C, typename... E>
-    const typename BasicView<R, Exclude<E...>, C...>::ResultVector& BasicView<R, Exclude<E...>, C...>::All() const
+    template <typename F>
+    void BasicView<R, Exclude<E...>, C...>::ParallelEach(F&& inFunc) const
     {
-        return result;
+        std::vector<Internal::ChunkBatch> batches;
+        for (const auto& archetype : archetypes) {
+            if (!Filter::Match(archetype)) {
+                continue;
+            }
+            for (auto i = 0; i < archetype.ChunkNum(); i++) {
+                batches.emplace_back(Internal::ChunkBatch { &archetype, static_cast<size_t>(i) });
+            }
+        }
+        Filter::ParallelEachInBatches(batches, std::forward<F>(inFunc));
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
     size_t BasicView<R, Exclude<E...>, C...>::Count() const
     {
-        return result.size();
+        size_t result = 0;
+        for (const auto& archetype : archetypes) {
+            if (Filter::Match(archetype)) {
+                result += archetype.Count();
+            }
+        }
+        return result;
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
     typename BasicView<R, Exclude<E...>, C...>::ConstIter BasicView<R, Exclude<E...>, C...>::Begin() const
     {
-        return result.begin();
+        return ConstIter(*this, archetypes.begin());
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
     typename BasicView<R, Exclude<E...>, C...>::ConstIter BasicView<R, Exclude<E...>, C...>::End() const
     {
-        return result.end();
+        return ConstIter(*this, archetypes.end());
     }
 
     template <ECRegistryOrConst R, typename ... C, typename ... E>
@@ -801,36 +1262,140 @@ namespace Runtime {
     }
 
     template <ECRegistryOrConst R, typename... C, typename... E>
-    void BasicView<R, Exclude<E...>, C...>::Evaluate(R& inRegistry)
-    {
-        std::vector<CompClass> includeCompIds;
-        includeCompIds.reserve(sizeof...(C));
-        (void) std::initializer_list<int> { ([&]() -> void {
-            includeCompIds.emplace_back(Internal::GetClass<std::decay_t<C>>());
-        }(), 0)... };
-
-        std::vector<CompClass> excludeCompIds;
-        excludeCompIds.reserve(sizeof...(E));
-        (void) std::initializer_list<int> { ([&]() -> void {
-            excludeCompIds.emplace_back(Internal::GetClass<E>());
-        }(), 0)... };
-
-        for (auto& archetype : inRegistry.archetypes | std::views::values) {
-            if (!archetype.ContainsAll(includeCompIds) || !archetype.NotContainsAny(excludeCompIds)) {
-                continue;
+    BasicQuery<R, Exclude<E...>, C...>::BasicQuery(R& inRegistry)
+        : registry(inRegistry)
+        , archetypeVersion(0)
+    {
+        Rescan();
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    template <typename F>
+    void BasicQuery<R, Exclude<E...>, C...>::Each(F&& inFunc)
+    {
+        Refresh();
+        for (const auto* archetype : archetypes) {
+            Filter::EachInArchetype(*archetype, std::forward<F>(inFunc));
+        }
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    template <typename F>
+    void BasicQuery<R, Exclude<E...>, C...>::ParallelEach(F&& inFunc)
+    {
+        Refresh();
+        std::vector<Internal::ChunkBatch> batches;
+        for (const auto* archetype : archetypes) {
+            for (auto i = 0; i < archetype->ChunkNum(); i++) {
+                batches.emplace_back(Internal::ChunkBatch { archetype, static_cast<size_t>(i) });
             }
+        }
+        Filter::ParallelEachInBatches(batches, std::forward<F>(inFunc));
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    size_t BasicQuery<R, Exclude<E...>, C...>::Count()
+    {
+        Refresh();
+        size_t result = 0;
+        for (const auto* archetype : archetypes) {
+            result += archetype->Count();
+        }
+        return result;
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    size_t BasicQuery<R, Exclude<E...>, C...>::ArchetypeNum()
+    {
+        Refresh();
+        return archetypes.size();
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    void BasicQuery<R, Exclude<E...>, C...>::Refresh()
+    {
+        if (archetypeVersion != registry.archetypeVersion) {
+            Rescan();
+        }
+    }
+
+    template <ECRegistryOrConst R, typename... C, typename... E>
+    void BasicQuery<R, Exclude<E...>, C...>::Rescan()
+    {
+        archetypes.clear();
+        for (const auto& archetype : registry.archetypes) {
+            if (Filter::Match(archetype)) {
+                archetypes.emplace_back(&archetype);
+            }
+        }
+        archetypeVersion = registry.archetypeVersion;
+    }
+
+    template <ECRegistryOrConst R>
+    BasicRuntimeView<R>::ConstIter::ConstIter(const BasicRuntimeView& inView, Internal::ArchetypeList::const_iterator inArchetypeIter)
+        : view(&inView)
+        , archetypeIter(inArchetypeIter)
+        , elemIndex(0)
+    {
+        SeekValid();
+    }
+
+    template <ECRegistryOrConst R>
+    Entity BasicRuntimeView<R>::ConstIter::operator*() const
+    {
+        return archetypeIter->All()[elemIndex];
+    }
+
+    template <ECRegistryOrConst R>
+    typename BasicRuntimeView<R>::ConstIter& BasicRuntimeView<R>::ConstIter::operator++()
+    {
+        if (++elemIndex < archetypeIter->Count()) {
+            return *this;
+        }
+        ++archetypeIter;
+        elemIndex = 0;
+        SeekValid();
+        return *this;
+    }
+
+    template <ECRegistryOrConst R>
+    typename BasicRuntimeView<R>::ConstIter BasicRuntimeView<R>::ConstIter::operator++(int)
+    {
+        const auto result = *this;
+        ++*this;
+        return result;
+    }
 
-            result.reserve(result.size() + archetype.Count());
-            for (auto entity : archetype.All()) {
-                result.emplace_back(entity, inRegistry.template Get<std::decay_t<C>>(entity)...);
+    template <ECRegistryOrConst R>
+    bool BasicRuntimeView<R>::ConstIter::operator==(const ConstIter& inOther) const
+    {
+        return archetypeIter == inOther.archetypeIter && elemIndex == inOther.elemIndex;
+    }
+
+    template <ECRegistryOrConst R>
+    bool BasicRuntimeView<R>::ConstIter::operator!=(const ConstIter& inOther) const
+    {
+        return !(*this == inOther);
+    }
+
+    template <ECRegistryOrConst R>
+    void BasicRuntimeView<R>::ConstIter::SeekValid()
+    {
+        const auto archetypeEnd = view->archetypes.end();
+        for (; archetypeIter != archetypeEnd; ++archetypeIter) {
+            const auto& archetype = *archetypeIter;
+            if (archetype.Count() > 0 && view->Match(archetype)) {
+                return;
             }
         }
     }
 
     template <ECRegistryOrConst R>
     BasicRuntimeView<R>::BasicRuntimeView(R& inRegistry, const RuntimeFilter& inFilter)
+        : archetypes(inRegistry.archetypes)
+        , includes(inFilter.includes.begin(), inFilter.includes.end())
+        , excludes(inFilter.excludes.begin(), inFilter.excludes.end())
     {
-        Evaluate(inRegistry, inFilter);
     }
 
     template <ECRegistryOrConst R>
@@ -839,27 +1404,38 @@ namespace Runtime {
     {
         using Traits = Internal::MemberFuncPtrTraits<decltype(&F::operator())>;
 
-        for (const auto& pair : result) {
-            InvokeTraverseFuncInternal<F, typename Traits::ArgsTupleType>(std::forward<F>(inFunc), pair, std::make_index_sequence<Traits::ArgSize - 1> {});
+        for (const auto& archetype : archetypes) {
+            if (!Match(archetype)) {
+                continue;
+            }
+            for (auto i = 0; i < archetype.ChunkNum(); i++) {
+                EachInChunk<F, typename Traits::ArgsTupleType>(std::forward<F>(inFunc), archetype, i, std::make_index_sequence<Traits::ArgSize - 1> {});
+            }
         }
     }
 
     template <ECRegistryOrConst R>
     size_t BasicRuntimeView<R>::Count() const
     {
-        return resultEntities.size();
+        size_t result = 0;
+        for (const auto& archetype : archetypes) {
+            if (Match(archetype)) {
+                result += archetype.Count();
+            }
+        }
+        return result;
     }
 
     template <ECRegistryOrConst R>
     typename BasicRuntimeView<R>::ConstIter BasicRuntimeView<R>::Begin() const
     {
-        return resultEntities.begin();
+        return ConstIter(*this, archetypes.begin());
     }
 
     template <ECRegistryOrConst R>
     typename BasicRuntimeView<R>::ConstIter BasicRuntimeView<R>::End() const
     {
-        return resultEntities.end();
+        return ConstIter(*this, archetypes.end());
     }
 
     template <ECRegistryOrConst R>
@@ -876,49 +1452,21 @@ namespace Runtime {
 
     template <ECRegistryOrConst R>
     template <typename F, typename ArgTuple, size_t... I>
-    void BasicRuntimeView<R>::InvokeTraverseFuncInternal(F&& inFunc, const std::pair<Entity, std::vector<Mirror::Any>>& inEntityAndComps, std::index_sequence<I...>) const
+    void BasicRuntimeView<R>::EachInChunk(F&& inFunc, const Internal::Archetype& inArchetype, size_t inChunkIndex, std::index_sequence<I...>) const
     {
-        inFunc(inEntityAndComps.first, GetCompRef<std::tuple_element_t<I + 1, ArgTuple>>(inEntityAndComps.second)...);
-    }
+        const Entity* entities = inArchetype.ChunkEntities(inChunkIndex);
+        const auto elemCount = inArchetype.ChunkElemCount(inChunkIndex);
+        const std::tuple columns { static_cast<std::remove_reference_t<std::tuple_element_t<I + 1, ArgTuple>>*>(inArchetype.ChunkColumn(inChunkIndex, Internal::GetClass<std::decay_t<std::tuple_element_t<I + 1, ArgTuple>>>()))... };
 
-    template <ECRegistryOrConst R>
-    template <typename C>
-    decltype(auto) BasicRuntimeView<R>::GetCompRef(const std::vector<Mirror::Any>& inComps) const
-    {
-        static_assert(std::is_reference_v<C>);
-        const auto compIndex = slotMap.at(Internal::GetClass<std::decay_t<C>>());
-        return inComps[compIndex].template As<C>();
+        for (auto i = 0; i < elemCount; i++) {
+            inFunc(entities[i], std::get<I>(columns)[i]...);
+        }
     }
 
     template <ECRegistryOrConst R>
-    void BasicRuntimeView<R>::Evaluate(R& inRegistry, const RuntimeFilter& inFilter)
+    bool BasicRuntimeView<R>::Match(const Internal::Archetype& inArchetype) const
     {
-        const std::vector includes(inFilter.includes.begin(), inFilter.includes.end());
-        const std::vector excludes(inFilter.excludes.begin(), inFilter.excludes.end());
-
-        slotMap.reserve(includes.size());
-        for (auto i = 0; i < includes.size(); i++) {
-            slotMap.emplace(includes[i], i);
-        }
-
-        for (auto& archetype : inRegistry.archetypes | std::views::values) {
-            if (!archetype.ContainsAll(includes) || !archetype.NotContainsAny(excludes)) {
-                continue;
-            }
-
-            resultEntities.reserve(result.size() + archetype.Count());
-            result.reserve(result.size() + archetype.Count());
-            for (const auto entity : archetype.All()) {
-                std::vector<Mirror::Any> comps;
-                comps.reserve(includes.size());
-                for (const auto* clazz : includes) {
-                    comps.emplace_back(archetype.GetComp(entity, clazz));
-                }
-
-                resultEntities.emplace_back(entity);
-                result.emplace_back(entity, std::move(comps));
-            }
-        }
+        return inArchetype.ContainsAll(includes) && inArchetype.NotContainsAny(excludes);
     }
 
     template <typename C>
@@ -1144,6 +1692,24 @@ namespace Runtime {
         return Runtime::ConstView<ECRegistry, Exclude<E...>, C...>(*this);
     }
 
+    template <typename ... C, typename ... E>
+    Runtime::Query<ECRegistry, Exclude<E...>, C...> ECRegistry::Query(Exclude<E...>)
+    {
+        return Runtime::Query<ECRegistry, Exclude<E...>, C...>(*this);
+    }
+
+    template <typename ... C, typename ... E>
+    Runtime::ConstQuery<ECRegistry, Exclude<E...>, C...> ECRegistry::Query(Exclude<E...>) const
+    {
+        return Runtime::ConstQuery<ECRegistry, Exclude<E...>, C...>(*this);
+    }
+
+    template <typename ... C, typename ... E>
+    Runtime::ConstQuery<ECRegistry, Exclude<E...>, C...> ECRegistry::ConstQuery(Exclude<E...>) const
+    {
+        return Runtime::ConstQuery<ECRegistry, Exclude<E...>, C...>(*this);
+    }
+
     template <typename C>
     ECRegistry::CompEvents& ECRegistry::Events()
     {
@@ -1231,6 +1797,18 @@ namespace Runtime {
         GNotifyUpdatedDyn(Internal::GetClass<G>());
     }
 
+    template <typename C, typename... Args>
+    void CommandBuffer::Emplace(Entity inEntity, Args&&... inArgs)
+    {
+        EmplaceDyn(Internal::GetClass<C>(), inEntity, Mirror::ForwardAsArgList(std::forward<Args>(inArgs)...));
+    }
+
+    template <typename C>
+    void CommandBuffer::Remove(Entity inEntity)
+    {
+        RemoveDyn(Internal::GetClass<C>(), inEntity);
+    }
+
     template <typename S>
     Internal::SystemFactory& SystemGroup::EmplaceSystem()
     {
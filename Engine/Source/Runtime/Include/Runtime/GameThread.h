@@ -8,6 +8,8 @@
 #include <queue>
 #include <future>
 
+#include <taskflow/taskflow.hpp>
+
 #include <Common/Debug.h>
 #include <Common/Concurrent.h>
 #include <Core/Thread.h>
@@ -40,13 +42,17 @@ namespace Runtime {
 
         void Start();
         void Stop();
+        bool IsStarted() const;
+        void Run(tf::Taskflow& inTaskflow);
+        size_t ThreadNum() const;
         template <typename F> auto EmplaceTask(F&& inTask);
         template <typename F> void ExecuteTasks(size_t inTaskNum, F&& inTask);
 
     private:
         GameWorkerThreads();
 
-        Common::UniquePtr<Common::ThreadPool> threads;
+        // work-stealing executor, long-lived to avoid spawning workers each frame
+        Common::UniquePtr<tf::Executor> executor;
     };
 }
 
@@ -69,8 +75,8 @@ namespace Runtime {
     {
         using RetType = std::invoke_result_t<F>;
 
-        Assert(threads != nullptr);
-        return threads->EmplaceTask([inTask]() -> RetType {
+        Assert(executor != nullptr);
+        return executor->async([inTask]() -> RetType {
             Core::ScopedThreadTag tag(Core::ThreadTag::gameWorker);
             return inTask();
         });
@@ -79,11 +85,13 @@ namespace Runtime {
     template <typename F>
     void GameWorkerThreads::ExecuteTasks(size_t inTaskNum, F&& inTask)
     {
-        Assert(threads != nullptr);
+        Assert(executor != nullptr);
         auto reboundTask = std::bind(std::forward<F>(inTask), std::placeholders::_1);
-        threads->ExecuteTasks(inTaskNum, [reboundTask](size_t inIndex) -> void {
+        tf::Taskflow taskflow;
+        taskflow.for_each_index(static_cast<size_t>(0), inTaskNum, static_cast<size_t>(1), [reboundTask](size_t inIndex) -> void {
             Core::ScopedThreadTag tag(Core::ThreadTag::gameWorker);
             reboundTask(inIndex);
         });
+        Run(taskflow);
     }
 } // namespace Runtime
@@ -11,5 +11,10 @@ namespace Runtime {
     struct RUNTIME_API MetaPresets {
         static constexpr const auto* globalComp = "globalComp";
         static constexpr const auto* gameReadOnly = "gameReadOnly";
+        // component class full names separated by ';', e.g. EClass(systemReads=Runtime::WorldTransform;Runtime::Camera)
+        static constexpr const auto* systemReads = "systemReads";
+        static constexpr const auto* systemWrites = "systemWrites";
+        // systems creating or destroying entities or adding or removing (global) components, e.g. EClass(systemStructural)
+        static constexpr const auto* systemStructural = "systemStructural";
     };
 }
@@ -37,9 +37,9 @@ namespace Runtime {
     template <typename T>
     Entity PlayerSystem::CreatePlayer()
     {
-        const auto& playerStartQuery = registry.View<PlayerStart, WorldTransform>().All();
-        Assert(playerStartQuery.size() == 1);
-        const auto& [playerStartEntity, playerStart, playerStartTransform] = playerStartQuery[0];
+        const auto playerStartView = registry.View<PlayerStart, WorldTransform>();
+        Assert(playerStartView.Count() == 1);
+        const WorldTransform playerStartTransform = std::get<2>(*playerStartView.Begin());
 
         const auto playerEntity = registry.Create();
         registry.Emplace<Camera>(playerEntity);
@@ -74,7 +74,7 @@ namespace Runtime {
     void PlayerSystem::FinalizePlayer(Entity inEntity)
     {
         auto& player = registry.Get<T>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([viewState = player.viewState]() -> void {
+        renderModule.GetRenderThread().EmplaceDetachedTask([viewState = player.viewState]() -> void {
             delete viewState;
         });
     }
@@ -4,8 +4,6 @@
 
 #pragma once
 
-#include <optional>
-
 #include <Runtime/ECS.h>
 #include <Runtime/Component/Light.h>
 #include <Runtime/Component/Transform.h>
@@ -32,12 +30,15 @@ namespace Runtime {
         template <typename Component, typename SceneProxy> void QueueUpdateSceneProxyContent(Entity inEntity);
         template <typename SceneProxy> void QueueUpdateSceneProxyTransform(Entity inEntity);
         template <typename SceneProxy> void QueueRemoveSceneProxy(Entity inEntity);
+        template <typename SceneProxy> Render::SceneProxyDeltas<SceneProxy>& GetSceneProxyDeltas();
+        void FlushSceneProxyDeltas();
 
         Render::RenderModule& renderModule;
         Observer transformUpdatedObserver;
         EventsObserver<DirectionalLight> directionalLightsObserver;
         EventsObserver<PointLight> pointLightsObserver;
         EventsObserver<SpotLight> spotLightsObserver;
+        Render::SceneProxyDeltas<Render::LightSceneProxy> lightSceneProxyDeltas;
     };
 }
 
@@ -54,10 +55,16 @@ namespace Runtime::Internal {
         outSceneProxy.localToWorld = withScale ? inTransform.localToWorld.GetTransformMatrix() : inTransform.localToWorld.GetTransformMatrixNoScale();
     }
 
-    template <typename T>
-    static std::optional<T> GetOptional(const T* inObj)
+    template <typename Component, typename SceneProxy>
+    static SceneProxy BuildSceneProxy(const ECRegistry& inRegistry, Entity inEntity)
     {
-        return inObj == nullptr ? std::optional<T>() : *inObj;
+        SceneProxy sceneProxy;
+        UpdateSceneProxyContent(sceneProxy, inRegistry.Get<Component>(inEntity));
+        if (const auto* transform = inRegistry.Find<WorldTransform>(inEntity);
+            transform != nullptr) {
+            UpdateSceneProxyWorldTransform(sceneProxy, *transform, false);
+        }
+        return sceneProxy;
     }
 }
 
@@ -92,47 +99,40 @@ namespace Runtime {
     template <typename Component, typename SceneProxy>
     void SceneSystem::QueueCreateSceneProxy(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        const auto& component = registry.Get<Component>(inEntity);
-        const auto* transform = registry.Find<WorldTransform>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene, inEntity, component, transform = Internal::GetOptional(transform)]() -> void {
-            SceneProxy sceneProxy;
-            Internal::UpdateSceneProxyContent(sceneProxy, component);
-            if (transform.has_value()) {
-                Internal::UpdateSceneProxyWorldTransform(sceneProxy, transform.value(), false);
-            }
-            scene->Add<SceneProxy>(inEntity, std::move(sceneProxy));
-        });
+        GetSceneProxyDeltas<SceneProxy>().adds.emplace_back(inEntity, Internal::BuildSceneProxy<Component, SceneProxy>(registry, inEntity));
     }
 
     template <typename Component, typename SceneProxy>
     void SceneSystem::QueueUpdateSceneProxyContent(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        const auto& component = registry.Get<Component>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene, inEntity, component]() -> void {
-            auto& sceneProxy = scene->Get<SceneProxy>(inEntity);
-            Internal::UpdateSceneProxyContent(sceneProxy, component);
-        });
+        // the whole proxy is rebuilt from game-thread data, so render-thread only needs to overwrite it
+        GetSceneProxyDeltas<SceneProxy>().updates.emplace_back(inEntity, Internal::BuildSceneProxy<Component, SceneProxy>(registry, inEntity));
     }
 
     template <typename SceneProxy>
     void SceneSystem::QueueUpdateSceneProxyTransform(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        const auto& transform = registry.Get<WorldTransform>(inEntity);
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene, inEntity, transform]() -> void {
-            auto& sceneProxy = scene->Get<SceneProxy>(inEntity);
-            Internal::UpdateSceneProxyWorldTransform(sceneProxy, transform, false);
-        });
+        SceneProxy sceneProxy;
+        Internal::UpdateSceneProxyWorldTransform(sceneProxy, registry.Get<WorldTransform>(inEntity), false);
+        GetSceneProxyDeltas<SceneProxy>().transformUpdates.emplace_back(inEntity, sceneProxy.localToWorld);
     }
 
     template <typename SceneProxy>
     void SceneSystem::QueueRemoveSceneProxy(Entity inEntity)
     {
-        const auto& sceneHolder = registry.GGet<SceneHolder>();
-        renderModule.GetRenderThread().EmplaceTask([scene = sceneHolder.scene, inEntity]() -> void {
-            scene->Remove<SceneProxy>(inEntity);
-        });
+        GetSceneProxyDeltas<SceneProxy>().removes.emplace_back(inEntity);
+    }
+
+    template <typename SceneProxy>
+    Render::SceneProxyDeltas<SceneProxy>& SceneSystem::GetSceneProxyDeltas()
+    {
+        Unimplement();
+        return *static_cast<Render::SceneProxyDeltas<SceneProxy>*>(nullptr); // NOLINT
+    }
+
+    template <>
+    inline Render::SceneProxyDeltas<Render::LightSceneProxy>& SceneSystem::GetSceneProxyDeltas<Render::LightSceneProxy>()
+    {
+        return lightSceneProxyDeltas;
     }
 }
@@ -2,6 +2,7 @@
 // Created by johnk on 2023/10/10.
 //
 
+#include <Common/Time.h>
 #include <Runtime/Asset/Asset.h>
 
 namespace Runtime {
@@ -14,6 +15,61 @@ namespace Runtime {
 
     Asset::~Asset() = default;
 
+    AssetStreamHandle::AssetStreamHandle() = default;
+
+    AssetStreamHandle::AssetStreamHandle(Common::SharedPtr<AssetStreamRequest> inRequest)
+        : request(std::move(inRequest))
+    {
+    }
+
+    bool AssetStreamHandle::Valid() const
+    {
+        return request != nullptr;
+    }
+
+    AssetStreamState AssetStreamHandle::State() const
+    {
+        Assert(Valid());
+        return request->state.load();
+    }
+
+    void AssetStreamHandle::SetPriority(AssetStreamPriority inPriority) const
+    {
+        Assert(Valid());
+        AssetManager::Get().SetStreamRequestPriority(request, inPriority);
+    }
+
+    bool AssetStreamHandle::Cancel() const
+    {
+        Assert(Valid());
+        return AssetManager::Get().CancelStreamRequest(request);
+    }
+
+    AssetResidency::AssetResidency()
+        : residentSize(0)
+        , loadLatencyUs(0)
+    {
+    }
+
+    AssetStreamingStats::AssetStreamingStats()
+        : budget(std::numeric_limits<size_t>::max())
+        , residentSize(0)
+        , residentNum(0)
+        , pendingNum(0)
+        , loadedNum(0)
+        , cancelledNum(0)
+        , evictedNum(0)
+    {
+    }
+
+    bool AssetManager::StreamRequestCompare::operator()(const Common::SharedPtr<AssetStreamRequest>& lhs, const Common::SharedPtr<AssetStreamRequest>& rhs) const
+    {
+        if (lhs->priority != rhs->priority) {
+            return lhs->priority > rhs->priority;
+        }
+        return lhs->sequence < rhs->sequence;
+    }
+
     AssetManager& AssetManager::Get()
     {
         static AssetManager instance;
@@ -21,10 +77,259 @@ namespace Runtime {
     }
 
     AssetManager::AssetManager()
-        : weakAssetRefs()
+        : cacheShards()
+        , streamSequence(0)
         , threadPool("AssetThreadPool", 4)
     {
     }
 
     AssetManager::~AssetManager() = default;
+
+    std::vector<Common::SharedPtr<AssetManager::LoadTask>>*& AssetManager::CurrentLoadDependencies()
+    {
+        // dependencies collected by the load task deserializing on this thread
+        static thread_local std::vector<Common::SharedPtr<LoadTask>>* dependencies = nullptr;
+        return dependencies;
+    }
+
+    void AssetManager::CheckRequestedClass(const Mirror::Class* assetClass, const Mirror::Class* requestedClass)
+    {
+        AssertWithReason(
+            assetClass == requestedClass || assetClass->IsDerivedFrom(requestedClass),
+            "an asset must be requested as the class it is loaded as or one of its base classes");
+    }
+
+    AssetManager::CacheShard& AssetManager::GetCacheShard(const Core::Uri& uri)
+    {
+        return cacheShards[std::hash<Core::Uri>{}(uri) % cacheShardNum];
+    }
+
+    void AssetManager::RunLoadTask(const Common::SharedPtr<LoadTask>& task)
+    {
+        std::vector<Common::SharedPtr<LoadTask>> dependencies;
+        {
+            auto*& currentDependencies = CurrentLoadDependencies();
+            auto* parentDependencies = std::exchange(currentDependencies, &dependencies);
+            task->residentSize = task->deserializer();
+            currentDependencies = parentDependencies;
+        }
+
+        for (const auto& dependency : dependencies) {
+            if (TryBeginWaitDependency(*task, dependency)) {
+                WaitLoadTask(dependency);
+                EndWaitDependency(*task);
+            }
+        }
+
+        {
+            auto& shard = GetCacheShard(task->uri);
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.cachedAssets.insert_or_assign(task->uri, CachedAsset { WeakAssetPtr<Asset>(task->asset), task->assetClass, task->residentSize });
+            shard.loadTasks.erase(task->uri);
+        }
+        task->deserializer = nullptr;
+        task->promise.set_value();
+    }
+
+    void AssetManager::WaitLoadTask(const Common::SharedPtr<LoadTask>& task)
+    {
+        // a waiter runs a task nobody picked yet itself, so waits never block on queued work and the pool can not starve
+        if (!task->started.exchange(true)) {
+            RunLoadTask(task);
+            return;
+        }
+        task->future.wait();
+    }
+
+    bool AssetManager::TryBeginWaitDependency(LoadTask& task, const Common::SharedPtr<LoadTask>& dependency)
+    {
+        // a dependency already waiting for this task directly or through other tasks is a cycle, every asset of the cycle
+        // is deserialized once it waits, so this task is published without waiting for it instead of deadlocking
+        std::unique_lock<std::mutex> lock(loadWaitMutex);
+        for (const LoadTask* waiting = dependency.Get(); waiting != nullptr; waiting = waiting->waitingOn) {
+            if (waiting == &task) {
+                return false;
+            }
+        }
+        task.waitingOn = dependency.Get();
+        return true;
+    }
+
+    void AssetManager::EndWaitDependency(LoadTask& task)
+    {
+        std::unique_lock<std::mutex> lock(loadWaitMutex);
+        task.waitingOn = nullptr;
+    }
+
+    bool AssetManager::TryDeferLoadDependency(const Common::SharedPtr<LoadTask>& task, bool created)
+    {
+        auto* currentDependencies = CurrentLoadDependencies();
+        if (currentDependencies == nullptr) {
+            return false;
+        }
+
+        currentDependencies->emplace_back(task);
+        if (created) {
+            threadPool.EmplaceDetachedTask([this, task]() -> void {
+                if (!task->started.exchange(true)) {
+                    RunLoadTask(task);
+                }
+            });
+        }
+        return true;
+    }
+
+    size_t AssetManager::GetCachedResidentSize(const Core::Uri& uri)
+    {
+        auto& shard = GetCacheShard(uri);
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        const auto iter = shard.cachedAssets.find(uri);
+        return iter == shard.cachedAssets.end() ? 0 : iter->second.residentSize;
+    }
+
+    AssetStreamHandle AssetManager::SubmitStreamRequest(const Core::Uri& uri, AssetStreamPriority priority, std::function<AssetPtr<Asset>()>&& loader, std::function<void(AssetPtr<Asset>)>&& onLoaded)
+    {
+        Common::SharedPtr<AssetStreamRequest> request = Common::MakeShared<AssetStreamRequest>();
+        request->uri = uri;
+        request->priority = priority;
+        request->requestTimeUs = Common::TimePoint::Now().ToMicroseconds();
+        request->state = AssetStreamState::pending;
+        request->loader = std::move(loader);
+        request->onLoaded = std::move(onLoaded);
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            request->sequence = streamSequence++;
+            pendingStreamRequests.emplace(request);
+        }
+
+        // one pump per request, the pump picks the most prior pending request when it runs instead of the request it was
+        // posted for, so the FIFO pool queue does not decide the streaming order
+        threadPool.EmplaceDetachedTask([this]() -> void {
+            PumpStreamRequest();
+        });
+        return AssetStreamHandle(request);
+    }
+
+    void AssetManager::PumpStreamRequest()
+    {
+        Common::SharedPtr<AssetStreamRequest> request;
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            if (pendingStreamRequests.empty()) {
+                return;
+            }
+            request = *pendingStreamRequests.begin();
+            pendingStreamRequests.erase(pendingStreamRequests.begin());
+            request->state = AssetStreamState::loading;
+        }
+
+        AssetPtr<Asset> asset = request->loader();
+        AssetResidency residency;
+        residency.residentSize = GetCachedResidentSize(request->uri);
+        residency.loadLatencyUs = Common::TimePoint::Now().ToMicroseconds() - request->requestTimeUs;
+
+        std::vector<AssetPtr<Asset>> evicted;
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            if (const auto iter = residentAssets.find(request->uri);
+                iter != residentAssets.end()) {
+                streamingStats.residentSize -= iter->second.residency.residentSize;
+                residentLru.erase(iter->second.lruIter);
+                residentAssets.erase(iter);
+            }
+            residentLru.emplace_front(request->uri);
+            residentAssets.emplace(request->uri, ResidentAsset { asset, residency, residentLru.begin() });
+            streamingStats.residentSize += residency.residentSize;
+            streamingStats.loadedNum++;
+            EvictOverBudget(evicted);
+        }
+        request->state = AssetStreamState::loaded;
+        request->loader = nullptr;
+
+        if (request->onLoaded) {
+            request->onLoaded(asset);
+            request->onLoaded = nullptr;
+        }
+    }
+
+    void AssetManager::SetStreamRequestPriority(const Common::SharedPtr<AssetStreamRequest>& request, AssetStreamPriority priority)
+    {
+        std::unique_lock<std::mutex> lock(streamMutex);
+        if (request->state != AssetStreamState::pending) {
+            return;
+        }
+        // the set is ordered by priority, so the request must be reinserted after the key changed
+        pendingStreamRequests.erase(request);
+        request->priority = priority;
+        pendingStreamRequests.emplace(request);
+    }
+
+    bool AssetManager::CancelStreamRequest(const Common::SharedPtr<AssetStreamRequest>& request)
+    {
+        std::function<AssetPtr<Asset>()> loader;
+        std::function<void(AssetPtr<Asset>)> onLoaded;
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            if (request->state != AssetStreamState::pending) {
+                return false;
+            }
+            pendingStreamRequests.erase(request);
+            request->state = AssetStreamState::cancelled;
+            loader = std::move(request->loader);
+            onLoaded = std::move(request->onLoaded);
+            streamingStats.cancelledNum++;
+        }
+        return true;
+    }
+
+    AssetPtr<Asset> AssetManager::TouchResidentAsset(const Core::Uri& uri)
+    {
+        std::unique_lock<std::mutex> lock(streamMutex);
+        const auto iter = residentAssets.find(uri);
+        if (iter == residentAssets.end()) {
+            return nullptr;
+        }
+        residentLru.splice(residentLru.begin(), residentLru, iter->second.lruIter);
+        return iter->second.asset;
+    }
+
+    void AssetManager::EvictOverBudget(std::vector<AssetPtr<Asset>>& outEvicted)
+    {
+        // the most recently used asset is never evicted, or an asset larger than budget would be dropped once loaded
+        while (streamingStats.residentSize > streamingStats.budget && residentLru.size() > 1) {
+            const auto iter = residentAssets.find(residentLru.back());
+            streamingStats.residentSize -= iter->second.residency.residentSize;
+            streamingStats.evictedNum++;
+            outEvicted.emplace_back(std::move(iter->second.asset));
+            residentAssets.erase(iter);
+            residentLru.pop_back();
+        }
+    }
+
+    void AssetManager::SetStreamingBudget(size_t inBudget)
+    {
+        std::vector<AssetPtr<Asset>> evicted;
+        std::unique_lock<std::mutex> lock(streamMutex);
+        streamingStats.budget = inBudget;
+        EvictOverBudget(evicted);
+    }
+
+    std::optional<AssetResidency> AssetManager::QueryResidency(const Core::Uri& uri) const
+    {
+        std::unique_lock<std::mutex> lock(streamMutex);
+        const auto iter = residentAssets.find(uri);
+        if (iter == residentAssets.end()) {
+            return std::nullopt;
+        }
+        return iter->second.residency;
+    }
+
+    AssetStreamingStats AssetManager::GetStreamingStats() const
+    {
+        std::unique_lock<std::mutex> lock(streamMutex);
+        AssetStreamingStats result = streamingStats;
+        result.residentNum = residentAssets.size();
+        result.pendingNum = pendingStreamRequests.size();
+        return result;
+    }
 }
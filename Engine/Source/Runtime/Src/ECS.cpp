@@ -2,10 +2,16 @@
 // Created by johnk on 2024/10/31.
 //
 
+#include <ranges>
+
 #include <taskflow/taskflow.hpp>
 
+#include <Common/Hash.h>
+#include <Common/String.h>
+#include <Common/Time.h>
 #include <Core/Thread.h>
 #include <Runtime/ECS.h>
+#include <Runtime/GameThread.h>
 
 namespace Runtime {
     System::System(ECRegistry& inRegistry, const SystemSetupContext&)
@@ -24,8 +30,111 @@ namespace Runtime::Internal {
         return inClass->GetMetaBoolOr(MetaPresets::globalComp, false);
     }
 
+    static std::vector<CompClass> ParseCompClassesFromMeta(SystemClass inClass, const std::string& inMetaKey)
+    {
+        std::vector<CompClass> result;
+        if (!inClass->HasMeta(inMetaKey)) {
+            return result;
+        }
+
+        for (const auto& name : Common::StringUtils::Split(inClass->GetMeta(inMetaKey), ";")) {
+            if (name.empty()) {
+                continue;
+            }
+            const auto* clazz = Mirror::Class::Find(name);
+            AssertWithReason(clazz != nullptr, "unknown component class in system access meta");
+            result.emplace_back(clazz);
+        }
+        return result;
+    }
+
+    // components whose memory is exactly their reflected non-pointer member variables can be saved and loaded as raw
+    // column memory, returns false if component must be serialized one by one
+    static bool GetCompMemberLayouts(CompClass inClass, std::vector<CompMemberLayout>& outMembers)
+    {
+        outMembers.clear();
+        if (!inClass->GetTypeInfo()->triviallyCopyable || inClass->GetBaseClass() != nullptr || !inClass->HasDefaultConstructor()) {
+            return false;
+        }
+
+        const auto defaultObject = inClass->GetDefaultObject();
+        const auto* objectBegin = static_cast<const uint8_t*>(defaultObject.Data());
+        outMembers.reserve(inClass->GetMemberVariables().size());
+
+        size_t memberMemorySize = 0;
+        for (const auto& memberVariable : inClass->GetMemberVariables() | std::views::values) {
+            if (memberVariable.IsTransient() || memberVariable.GetTypeInfo()->isPointer) {
+                outMembers.clear();
+                return false;
+            }
+            const auto* memberBegin = static_cast<const uint8_t*>(memberVariable.GetDyn(defaultObject).Data());
+            outMembers.emplace_back(CompMemberLayout {
+                memberVariable.GetName(),
+                std::string(memberVariable.GetTypeInfo()->name),
+                static_cast<uint64_t>(memberBegin - objectBegin),
+                memberVariable.SizeOf()
+            });
+            memberMemorySize += memberVariable.SizeOf();
+        }
+        if (memberMemorySize != inClass->SizeOf()) {
+            outMembers.clear();
+            return false;
+        }
+        std::ranges::sort(outMembers, {}, &CompMemberLayout::offset);
+        return true;
+    }
+
+    // the hash covers class name, size and each member name, type, offset and size, so any layout change invalidates
+    // the raw column memory, returns 0 if component must be serialized one by one
+    static uint64_t GetCompLayoutHash(CompClass inClass, const std::vector<CompMemberLayout>& inMembers)
+    {
+        if (inMembers.empty()) {
+            return 0;
+        }
+
+        std::string layout = std::format("{}:{}", inClass->GetName(), inClass->SizeOf());
+        for (const auto& member : inMembers) {
+            layout += std::format(";{}:{}:{}:{}", member.name, member.typeName, member.offset, member.size);
+        }
+        return Common::HashUtils::CityHash(layout.data(), layout.size());
+    }
+
+    static uint64_t GetCompLayoutHash(CompClass inClass)
+    {
+        std::vector<CompMemberLayout> members;
+        GetCompMemberLayouts(inClass, members);
+        return GetCompLayoutHash(inClass, members);
+    }
+
+    // factory of the system performed by the current thread, nullptr outside of pipeline performing
+    thread_local const SystemFactory* performingSystem = nullptr;
+
+    static void CheckStructuralChangeAllowed()
+    {
+        AssertWithReason(
+            performingSystem == nullptr || !performingSystem->HasAccessDeclared() || performingSystem->HasStructuralWrites(),
+            "systems with declared accesses must declare structural writes, or record structural changes to a CommandBuffer");
+    }
+
+    static bool NeedOrder(const SystemFactory& inBefore, size_t inBeforeGroup, const SystemFactory& inAfter, size_t inAfterGroup, SystemExecuteStrategy inGroupStrategy)
+    {
+        if (inBefore.HasStructuralWrites() || inAfter.HasStructuralWrites()) {
+            return true;
+        }
+        if (inBeforeGroup == inAfterGroup && inGroupStrategy == SystemExecuteStrategy::concurrent) {
+            return false;
+        }
+        if (!inBefore.HasAccessDeclared() || !inAfter.HasAccessDeclared()) {
+            return true;
+        }
+        return inBefore.ConflictsWith(inAfter);
+    }
+
     CompRtti::CompRtti(CompClass inClass)
         : clazz(inClass)
+        , size(inClass->SizeOf())
+        , moveCtor(inClass->FindConstructor(Mirror::IdPresets::moveCtor))
+        , copyCtor(inClass->FindConstructor(Mirror::IdPresets::copyCtor))
         , bound(false)
         , offset(0)
     {
@@ -37,30 +146,37 @@ namespace Runtime::Internal {
         offset = inOffset;
     }
 
-    Mirror::Any CompRtti::MoveConstruct(ElemPtr inElem, const Mirror::Any& inOther) const
+    Mirror::Any CompRtti::MoveConstruct(CompPtr inComp, const Mirror::Any& inOther) const
+    {
+        if (moveCtor != nullptr && inOther.IsNonConstRef()) {
+            return moveCtor->InplaceNewDyn(inComp, { inOther });
+        }
+        return clazz->InplaceNewDyn(inComp, { inOther });
+    }
+
+    Mirror::Any CompRtti::CopyConstruct(CompPtr inComp, const Mirror::Any& inOther) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        return clazz->InplaceNewDyn(compBegin, { inOther });
+        if (copyCtor != nullptr) {
+            return copyCtor->InplaceNewDyn(inComp, { inOther.ConstRef() });
+        }
+        return clazz->InplaceNewDyn(inComp, { inOther.ConstRef() });
     }
 
-    Mirror::Any CompRtti::MoveAssign(ElemPtr inElem, const Mirror::Any& inOther) const
+    Mirror::Any CompRtti::MoveAssign(CompPtr inComp, const Mirror::Any& inOther) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        auto compRef = clazz->InplaceGetObject(compBegin);
+        auto compRef = clazz->InplaceGetObject(inComp);
         compRef.MoveAssign(inOther);
         return compRef;
     }
 
-    void CompRtti::Destruct(ElemPtr inElem) const
+    void CompRtti::Destruct(CompPtr inComp) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        clazz->DestructDyn(clazz->InplaceGetObject(compBegin));
+        clazz->DestructDyn(clazz->InplaceGetObject(inComp));
     }
 
-    Mirror::Any CompRtti::Get(ElemPtr inElem) const
+    Mirror::Any CompRtti::Get(CompPtr inComp) const
     {
-        auto* compBegin = static_cast<uint8_t*>(inElem) + offset;
-        return clazz->InplaceGetObject(compBegin);
+        return clazz->InplaceGetObject(inComp);
     }
 
     CompClass CompRtti::Class() const
@@ -75,35 +191,90 @@ namespace Runtime::Internal {
 
     size_t CompRtti::MemorySize() const
     {
-        return clazz->SizeOf();
+        return size;
     }
 
     Archetype::Archetype(const std::vector<CompRtti>& inRttiVec)
         : id(0)
         , count(0)
-        , elemSize(1)
+        , chunkCapacity(0)
+        , chunkMemorySize(0)
         , rttiVec(inRttiVec)
     {
         rttiMap.reserve(rttiVec.size());
         for (auto i = 0; i < rttiVec.size(); i++) {
-            auto& rtti = rttiVec[i];
-            const auto clazz = rtti.Class();
+            const auto clazz = rttiVec[i].Class();
             rttiMap.emplace(clazz, i);
-
             id += clazz->GetTypeInfo()->id;
-            rtti.Bind(elemSize);
-            elemSize += rtti.MemorySize();
         }
+        BuildLayout();
     }
 
-    bool Archetype::Contains(CompClass inClazz) const
+    Archetype::~Archetype()
     {
-        for (const auto& rtti : rttiVec) {
-            if (rtti.Class() == inClazz) {
-                return true;
-            }
+        DestructAllElems();
+    }
+
+    Archetype::Archetype(const Archetype& inOther)
+        : id(inOther.id)
+        , count(0)
+        , chunkCapacity(inOther.chunkCapacity)
+        , chunkMemorySize(inOther.chunkMemorySize)
+        , rttiVec(inOther.rttiVec)
+        , rttiMap(inOther.rttiMap)
+    {
+        CopyElemsFrom(inOther);
+    }
+
+    Archetype::Archetype(Archetype&& inOther) noexcept
+        : id(inOther.id)
+        , count(inOther.count)
+        , chunkCapacity(inOther.chunkCapacity)
+        , chunkMemorySize(inOther.chunkMemorySize)
+        , rttiVec(std::move(inOther.rttiVec))
+        , rttiMap(std::move(inOther.rttiMap))
+        , entities(std::move(inOther.entities))
+        , chunks(std::move(inOther.chunks))
+    {
+        inOther.count = 0;
+    }
+
+    Archetype& Archetype::operator=(const Archetype& inOther)
+    {
+        if (this == &inOther) {
+            return *this;
         }
-        return false;
+        DestructAllElems();
+        id = inOther.id;
+        chunkCapacity = inOther.chunkCapacity;
+        chunkMemorySize = inOther.chunkMemorySize;
+        rttiVec = inOther.rttiVec;
+        rttiMap = inOther.rttiMap;
+        CopyElemsFrom(inOther);
+        return *this;
+    }
+
+    Archetype& Archetype::operator=(Archetype&& inOther) noexcept
+    {
+        if (this == &inOther) {
+            return *this;
+        }
+        DestructAllElems();
+        id = inOther.id;
+        count = inOther.count;
+        chunkCapacity = inOther.chunkCapacity;
+        chunkMemorySize = inOther.chunkMemorySize;
+        rttiVec = std::move(inOther.rttiVec);
+        rttiMap = std::move(inOther.rttiMap);
+        entities = std::move(inOther.entities);
+        chunks = std::move(inOther.chunks);
+        inOther.count = 0;
+        return *this;
+    }
+
+    bool Archetype::Contains(CompClass inClazz) const
+    {
+        return rttiMap.contains(inClazz);
     }
 
     bool Archetype::ContainsAll(const std::vector<CompClass>& inClasses) const
@@ -126,71 +297,149 @@ namespace Runtime::Internal {
         return true;
     }
 
-    ElemPtr Archetype::EmplaceElem(Entity inEntity)
+    ElemIndex Archetype::EmplaceElem(Entity inEntity)
     {
-        ElemPtr result = AllocateNewElemBack();
-        auto backElem = count - 1;
-        entityMap.emplace(inEntity, backElem);
-        elemMap.emplace(backElem, inEntity);
+        const ElemIndex result = AllocateNewElemBack();
+        entities.emplace_back(inEntity);
         return result;
     }
 
-    ElemPtr Archetype::EmplaceElem(Entity inEntity, ElemPtr inSrcElem, const std::vector<CompRtti>& inSrcRttiVec)
+    ElemIndex Archetype::EmplaceElem(Entity inEntity, Archetype& inSrcArchetype, ElemIndex inSrcElem)
     {
-        ElemPtr newElem = EmplaceElem(inEntity);
-        for (const auto& srcRtti : inSrcRttiVec) {
+        const ElemIndex newElem = EmplaceElem(inEntity);
+        for (const auto& srcRtti : inSrcArchetype.rttiVec) {
             const auto* newRtti = FindCompRtti(srcRtti.Class());
             if (newRtti == nullptr) {
                 continue;
             }
-            newRtti->MoveConstruct(newElem, srcRtti.Get(inSrcElem));
+            newRtti->MoveConstruct(CompAt(*newRtti, newElem), srcRtti.Get(inSrcArchetype.CompAt(srcRtti, inSrcElem)));
         }
         return newElem;
     }
 
-    Mirror::Any Archetype::EmplaceComp(Entity inEntity, CompClass inCompClass, const Mirror::Any& inCompRef) // NOLINT
+    ElemIndex Archetype::EmplaceElems(const std::vector<Entity>& inEntities)
     {
-        ElemPtr elem = ElemAt(entityMap.at(inEntity));
-        return GetCompRtti(inCompClass).MoveConstruct(elem, inCompRef);
+        const ElemIndex result = count;
+        const size_t newCount = count + inEntities.size();
+        chunks.reserve((newCount + chunkCapacity - 1) / chunkCapacity);
+        entities.reserve(newCount);
+        for (const auto entity : inEntities) {
+            AllocateNewElemBack();
+            entities.emplace_back(entity);
+        }
+        return result;
+    }
+
+    void Archetype::ReadColumn(CompClass inCompClass, ElemIndex inBegin, size_t inNum, uint8_t* outData) const
+    {
+        Assert(inBegin + inNum <= count);
+        const auto& rtti = GetCompRtti(inCompClass);
+        for (ElemIndex elem = inBegin; elem < inBegin + inNum;) {
+            const size_t copyNum = std::min(chunkCapacity - elem % chunkCapacity, inBegin + inNum - elem);
+            memcpy(outData, CompAt(rtti, elem), copyNum * rtti.MemorySize());
+            outData += copyNum * rtti.MemorySize();
+            elem += copyNum;
+        }
+    }
+
+    void Archetype::WriteColumn(CompClass inCompClass, ElemIndex inBegin, size_t inNum, const uint8_t* inData)
+    {
+        Assert(inBegin + inNum <= count);
+        const auto& rtti = GetCompRtti(inCompClass);
+        for (ElemIndex elem = inBegin; elem < inBegin + inNum;) {
+            const size_t copyNum = std::min(chunkCapacity - elem % chunkCapacity, inBegin + inNum - elem);
+            memcpy(CompAt(rtti, elem), inData, copyNum * rtti.MemorySize());
+            inData += copyNum * rtti.MemorySize();
+            elem += copyNum;
+        }
+    }
+
+    Mirror::Any Archetype::EmplaceComp(ElemIndex inElem, CompClass inCompClass, const Mirror::Any& inCompRef) // NOLINT
+    {
+        const auto& rtti = GetCompRtti(inCompClass);
+        return rtti.MoveConstruct(CompAt(rtti, inElem), inCompRef);
     }
 
-    void Archetype::EraseElem(Entity inEntity)
+    Entity Archetype::EraseElem(ElemIndex inElem)
     {
-        const auto elemIndex = entityMap.at(inEntity);
-        ElemPtr elem = ElemAt(elemIndex);
+        Assert(inElem < count);
         const auto lastElemIndex = count - 1;
-        const auto entityToLastElem = elemMap.at(lastElemIndex);
-        ElemPtr lastElem = ElemAt(lastElemIndex);
         for (const auto& rtti : rttiVec) {
-            rtti.MoveAssign(elem, rtti.Get(lastElem));
+            CompPtr lastComp = CompAt(rtti, lastElemIndex);
+            if (inElem != lastElemIndex) {
+                rtti.MoveAssign(CompAt(rtti, inElem), rtti.Get(lastComp));
+            }
+            rtti.Destruct(lastComp);
+        }
+
+        Entity movedEntity = entityNull;
+        if (inElem != lastElemIndex) {
+            movedEntity = entities[lastElemIndex];
+            entities[inElem] = movedEntity;
         }
-        entityMap.at(entityToLastElem) = elemIndex;
-        entityMap.erase(inEntity);
-        elemMap.at(elemIndex) = entityToLastElem;
-        elemMap.erase(lastElemIndex);
+        entities.pop_back();
         count--;
+        return movedEntity;
     }
 
-    ElemPtr Archetype::GetElem(Entity inEntity) const
+    Mirror::Any Archetype::GetComp(ElemIndex inElem, CompClass inCompClass)
     {
-        return ElemAt(entityMap.at(inEntity));
+        const auto& rtti = GetCompRtti(inCompClass);
+        return rtti.Get(CompAt(rtti, inElem));
     }
 
-    Mirror::Any Archetype::GetComp(Entity inEntity, CompClass inCompClass)
+    Mirror::Any Archetype::GetComp(ElemIndex inElem, CompClass inCompClass) const
     {
-        ElemPtr element = GetElem(inEntity);
-        return GetCompRtti(inCompClass).Get(element);
+        const auto& rtti = GetCompRtti(inCompClass);
+        return rtti.Get(CompAt(rtti, inElem)).ConstRef();
     }
 
-    Mirror::Any Archetype::GetComp(Entity inEntity, CompClass inCompClass) const
+    size_t Archetype::Count() const
     {
-        ElemPtr element = GetElem(inEntity);
-        return GetCompRtti(inCompClass).Get(element).ConstRef();
+        return count;
     }
 
-    size_t Archetype::Count() const
+    const std::vector<Entity>& Archetype::All() const
     {
-        return count;
+        return entities;
+    }
+
+    size_t Archetype::ChunkNum() const
+    {
+        return (count + chunkCapacity - 1) / chunkCapacity;
+    }
+
+    size_t Archetype::ChunkCapacity() const
+    {
+        return chunkCapacity;
+    }
+
+    size_t Archetype::ChunkElemCount(size_t inChunkIndex) const
+    {
+        Assert(inChunkIndex < ChunkNum());
+        return std::min(chunkCapacity, count - inChunkIndex * chunkCapacity);
+    }
+
+    const Entity* Archetype::ChunkEntities(size_t inChunkIndex) const
+    {
+        Assert(inChunkIndex < ChunkNum());
+        return entities.data() + inChunkIndex * chunkCapacity;
+    }
+
+    uint8_t* Archetype::ChunkBegin(size_t inChunkIndex) const
+    {
+        Assert(inChunkIndex < chunks.size());
+        return const_cast<uint8_t*>(chunks[inChunkIndex].data());
+    }
+
+    size_t Archetype::ColumnOffset(CompClass inCompClass) const
+    {
+        return GetCompRtti(inCompClass).Offset();
+    }
+
+    CompPtr Archetype::ChunkColumn(size_t inChunkIndex, CompClass inCompClass) const
+    {
+        return ChunkBegin(inChunkIndex) + ColumnOffset(inCompClass);
     }
 
     const std::vector<CompRtti>& Archetype::GetRttiVec() const
@@ -231,138 +480,248 @@ namespace Runtime::Internal {
         return rttiVec[rttiMap.at(clazz)];
     }
 
-    ElemPtr Archetype::ElemAt(std::vector<uint8_t>& inMemory, size_t inIndex) const // NOLINT
+    size_t Archetype::ComputeChunkMemorySize(size_t inChunkCapacity) const
+    {
+        size_t result = 0;
+        for (const auto& rtti : rttiVec) {
+            result += Common::AlignUp<columnAlignment>(rtti.MemorySize() * inChunkCapacity);
+        }
+        return result;
+    }
+
+    void Archetype::BuildLayout()
     {
-        return inMemory.data() + (inIndex * elemSize);
+        size_t elemSize = 0;
+        for (const auto& rtti : rttiVec) {
+            elemSize += rtti.MemorySize();
+        }
+
+        // archetype with no component only records entities, use chunk bytes as capacity to keep chunk num small
+        chunkCapacity = elemSize == 0 ? chunkBytes : std::max(chunkBytes / elemSize, static_cast<size_t>(1));
+        while (chunkCapacity > 1 && ComputeChunkMemorySize(chunkCapacity) > chunkBytes) {
+            chunkCapacity--;
+        }
+        chunkMemorySize = ComputeChunkMemorySize(chunkCapacity);
+
+        size_t columnOffset = 0;
+        for (auto& rtti : rttiVec) {
+            rtti.Bind(columnOffset);
+            columnOffset += Common::AlignUp<columnAlignment>(rtti.MemorySize() * chunkCapacity);
+        }
     }
 
-    ElemPtr Archetype::ElemAt(size_t inIndex) const
+    CompPtr Archetype::CompAt(const CompRtti& inRtti, ElemIndex inIndex) const
     {
-        return ElemAt(const_cast<std::vector<uint8_t>&>(memory), inIndex);
+        const auto& chunk = chunks[inIndex / chunkCapacity];
+        const auto indexInChunk = inIndex % chunkCapacity;
+        return const_cast<uint8_t*>(chunk.data()) + inRtti.Offset() + indexInChunk * inRtti.MemorySize();
     }
 
-    size_t Archetype::Capacity() const
+    ElemIndex Archetype::AllocateNewElemBack()
     {
-        return memory.size() / elemSize;
+        if (count == chunks.size() * chunkCapacity) {
+            chunks.emplace_back(chunkMemorySize);
+        }
+        return count++;
     }
 
-    void Archetype::Reserve(float inRatio)
+    void Archetype::CopyElemsFrom(const Archetype& inOther)
     {
-        Assert(inRatio > 1.0f);
-        const size_t newCapacity = static_cast<size_t>(std::ceil(static_cast<float>(std::max(Capacity(), static_cast<size_t>(1))) * inRatio));
-        std::vector<uint8_t> newMemory(newCapacity * elemSize);
+        Assert(count == 0);
+        chunks.clear();
+        entities = inOther.entities;
+        for (auto i = 0; i < inOther.count; i++) {
+            const auto elemIndex = AllocateNewElemBack();
+            for (const auto& rtti : rttiVec) {
+                rtti.CopyConstruct(CompAt(rtti, elemIndex), rtti.Get(inOther.CompAt(rtti, elemIndex)));
+            }
+        }
+    }
 
+    void Archetype::DestructAllElems()
+    {
         for (auto i = 0; i < count; i++) {
             for (const auto& rtti : rttiVec) {
-                void* dstElem = ElemAt(newMemory, i);
-                void* srcElem = ElemAt(i);
-                rtti.MoveConstruct(dstElem, rtti.Get(srcElem));
-                rtti.Destruct(srcElem);
+                rtti.Destruct(CompAt(rtti, i));
             }
         }
-        memory = std::move(newMemory);
+        count = 0;
+        entities.clear();
+        chunks.clear();
     }
 
-    void* Archetype::AllocateNewElemBack()
+    void ParallelFor(size_t inBatchNum, const std::function<void(size_t)>& inTask)
     {
-        if (Count() == Capacity()) {
-            Reserve();
+        auto& workerThreads = GameWorkerThreads::Get();
+        if (inBatchNum <= 1 || !workerThreads.IsStarted()) {
+            for (auto i = 0; i < inBatchNum; i++) {
+                inTask(i);
+            }
+            return;
         }
-        count++;
-        return ElemAt(count - 1);
+        workerThreads.ExecuteTasks(inBatchNum, inTask);
+    }
+
+    uint32_t EntityPool::GetIndex(Entity inEntity)
+    {
+        return static_cast<uint32_t>(inEntity & 0xffffffff);
+    }
+
+    uint32_t EntityPool::GetGeneration(Entity inEntity)
+    {
+        return static_cast<uint32_t>(inEntity >> 32);
+    }
+
+    Entity EntityPool::MakeEntity(uint32_t inIndex, uint32_t inGeneration)
+    {
+        return static_cast<Entity>(inGeneration) << 32 | inIndex;
     }
 
     EntityPool::EntityPool()
-        : counter(1)
     {
+        // slot 0 is reserved for entityNull
+        slots.emplace_back(Slot { 0, aliveIndexNull, 0, 0 });
     }
 
     size_t EntityPool::Count() const
     {
-        return allocated.size();
+        return alive.size();
     }
 
     bool EntityPool::Valid(Entity inEntity) const
     {
-        return allocated.contains(inEntity);
+        const auto index = GetIndex(inEntity);
+        if (index == 0 || index >= slots.size()) {
+            return false;
+        }
+        const auto& slot = slots[index];
+        return slot.aliveIndex != aliveIndexNull && slot.generation == GetGeneration(inEntity);
     }
 
     Entity EntityPool::Allocate()
     {
-        Entity result = entityNull;
-        if (!free.empty()) {
-            result = *free.begin();
-            free.erase(result);
-        } else {
-            result = counter++;
+        while (!freeIndices.empty()) {
+            const auto index = freeIndices.back();
+            freeIndices.pop_back();
+            if (slots[index].aliveIndex == aliveIndexNull) {
+                MarkAlive(index);
+                return alive.back();
+            }
         }
-        allocated.emplace(result);
-        SetArchetype(result, 0);
-        return result;
+
+        const auto index = static_cast<uint32_t>(slots.size());
+        EnsureSlot(index);
+        MarkAlive(index);
+        return alive.back();
     }
 
     void EntityPool::Allocate(Entity inEntity)
     {
-        if (inEntity < counter) {
-            Assert(free.contains(inEntity));
-            free.erase(inEntity);
-        } else {
-            for (uint32_t i = counter; i < inEntity; i++) {
-                free.emplace(i);
+        const auto index = GetIndex(inEntity);
+        const auto generation = GetGeneration(inEntity);
+        Assert(index != 0 && generation <= generationMask);
+
+        if (index >= slots.size()) {
+            for (auto i = static_cast<uint32_t>(slots.size()); i < index; i++) {
+                freeIndices.emplace_back(i);
             }
-            counter = inEntity + 1;
+            EnsureSlot(index);
         }
-        allocated.emplace(inEntity);
-        SetArchetype(inEntity, 0);
+        Assert(slots[index].aliveIndex == aliveIndexNull);
+        slots[index].generation = generation;
+        MarkAlive(index);
     }
 
     void EntityPool::Free(Entity inEntity)
     {
         Assert(Valid(inEntity));
-        allocated.erase(inEntity);
-        free.emplace(inEntity);
-        archetypeMap.erase(inEntity);
+        auto& slot = slots[GetIndex(inEntity)];
+        const auto aliveIndex = slot.aliveIndex;
+        const auto lastAlive = alive.back();
+        alive[aliveIndex] = lastAlive;
+        slots[GetIndex(lastAlive)].aliveIndex = aliveIndex;
+        alive.pop_back();
+
+        slot.generation = (slot.generation + 1) & generationMask;
+        slot.aliveIndex = aliveIndexNull;
+        slot.archetypeIndex = 0;
+        slot.elemIndex = 0;
+        freeIndices.emplace_back(GetIndex(inEntity));
     }
 
     void EntityPool::Clear()
     {
-        counter = 1;
-        free.clear();
-        allocated.clear();
-        archetypeMap.clear();
+        slots.resize(1);
+        freeIndices.clear();
+        alive.clear();
     }
 
     void EntityPool::Each(const EntityTraverseFunc& inFunc) const
     {
-        for (const auto& entity : allocated) {
+        for (const auto& entity : alive) {
             inFunc(entity);
         }
     }
 
-    void EntityPool::SetArchetype(Entity inEntity, ArchetypeId inArchetypeId)
+    void EntityPool::SetLocation(Entity inEntity, ArchetypeIndex inArchetypeIndex, ElemIndex inElemIndex)
     {
-        archetypeMap[inEntity] = inArchetypeId;
+        Assert(Valid(inEntity));
+        auto& slot = slots[GetIndex(inEntity)];
+        slot.archetypeIndex = inArchetypeIndex;
+        slot.elemIndex = inElemIndex;
     }
 
-    ArchetypeId EntityPool::GetArchetype(Entity inEntity) const
+    void EntityPool::SetElem(Entity inEntity, ElemIndex inElemIndex)
     {
-        return archetypeMap.at(inEntity);
+        Assert(Valid(inEntity));
+        slots[GetIndex(inEntity)].elemIndex = inElemIndex;
+    }
+
+    ArchetypeIndex EntityPool::GetArchetype(Entity inEntity) const
+    {
+        Assert(Valid(inEntity));
+        return slots[GetIndex(inEntity)].archetypeIndex;
+    }
+
+    ElemIndex EntityPool::GetElem(Entity inEntity) const
+    {
+        Assert(Valid(inEntity));
+        return slots[GetIndex(inEntity)].elemIndex;
     }
 
     EntityPool::ConstIter EntityPool::Begin() const
     {
-        return allocated.begin();
+        return alive.begin();
     }
 
     EntityPool::ConstIter EntityPool::End() const
     {
-        return allocated.end();
+        return alive.end();
+    }
+
+    void EntityPool::EnsureSlot(uint32_t inIndex)
+    {
+        if (inIndex >= slots.size()) {
+            slots.resize(inIndex + 1, Slot { 0, aliveIndexNull, 0, 0 });
+        }
+    }
+
+    void EntityPool::MarkAlive(uint32_t inIndex)
+    {
+        auto& slot = slots[inIndex];
+        slot.aliveIndex = static_cast<uint32_t>(alive.size());
+        slot.archetypeIndex = 0;
+        slot.elemIndex = 0;
+        alive.emplace_back(MakeEntity(inIndex, slot.generation));
     }
 
     SystemFactory::SystemFactory(SystemClass inClass)
         : clazz(inClass)
+        , accessDeclared(false)
+        , structuralWrites(false)
     {
         BuildArgumentLists();
+        BuildAccessesFromMeta();
     }
 
     Common::UniquePtr<System> SystemFactory::Build(ECRegistry& inRegistry, const SystemSetupContext& inSetupContext) const
@@ -394,6 +753,78 @@ namespace Runtime::Internal {
         return clazz;
     }
 
+    SystemFactory& SystemFactory::ReadsDyn(CompClass inClass)
+    {
+        accessDeclared = true;
+        reads.emplace(inClass);
+        return *this;
+    }
+
+    SystemFactory& SystemFactory::WritesDyn(CompClass inClass)
+    {
+        accessDeclared = true;
+        writes.emplace(inClass);
+        return *this;
+    }
+
+    SystemFactory& SystemFactory::WritesStructure()
+    {
+        accessDeclared = true;
+        structuralWrites = true;
+        return *this;
+    }
+
+    bool SystemFactory::HasAccessDeclared() const
+    {
+        return accessDeclared;
+    }
+
+    bool SystemFactory::HasStructuralWrites() const
+    {
+        return structuralWrites;
+    }
+
+    const std::unordered_set<CompClass>& SystemFactory::GetReads() const
+    {
+        return reads;
+    }
+
+    const std::unordered_set<CompClass>& SystemFactory::GetWrites() const
+    {
+        return writes;
+    }
+
+    bool SystemFactory::ConflictsWith(const SystemFactory& inOther) const
+    {
+        if (structuralWrites || inOther.structuralWrites) {
+            return true;
+        }
+        for (const auto* clazz : writes) {
+            if (inOther.writes.contains(clazz) || inOther.reads.contains(clazz)) {
+                return true;
+            }
+        }
+        for (const auto* clazz : inOther.writes) {
+            if (reads.contains(clazz)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void SystemFactory::BuildAccessesFromMeta()
+    {
+        for (const auto* compClass : ParseCompClassesFromMeta(clazz, MetaPresets::systemReads)) {
+            ReadsDyn(compClass);
+        }
+        for (const auto* compClass : ParseCompClassesFromMeta(clazz, MetaPresets::systemWrites)) {
+            WritesDyn(compClass);
+        }
+        if (clazz->GetMetaBoolOr(MetaPresets::systemStructural, false)) {
+            WritesStructure();
+        }
+    }
+
     void SystemFactory::BuildArgumentLists()
     {
         const auto& memberVariables = clazz->GetMemberVariables();
@@ -630,8 +1061,9 @@ namespace Runtime {
     }
 
     ECRegistry::ECRegistry()
+        : archetypeVersion(0)
     {
-        archetypes.emplace(0, Internal::Archetype({}));
+        EmplaceArchetype({});
     }
 
     ECRegistry::~ECRegistry()
@@ -643,6 +1075,8 @@ namespace Runtime {
         : entities(inOther.entities)
         , globalComps(inOther.globalComps)
         , archetypes(inOther.archetypes)
+        , archetypeIndexMap(inOther.archetypeIndexMap)
+        , archetypeVersion(0)
     {
     }
 
@@ -650,7 +1084,10 @@ namespace Runtime {
         : entities(std::move(inOther.entities))
         , globalComps(std::move(inOther.globalComps))
         , archetypes(std::move(inOther.archetypes))
+        , archetypeIndexMap(std::move(inOther.archetypeIndexMap))
+        , archetypeVersion(0)
     {
+        inOther.archetypeVersion++;
     }
 
     ECRegistry& ECRegistry::operator=(const ECRegistry& inOther)
@@ -658,6 +1095,8 @@ namespace Runtime {
         entities = inOther.entities;
         globalComps = inOther.globalComps;
         archetypes = inOther.archetypes;
+        archetypeIndexMap = inOther.archetypeIndexMap;
+        archetypeVersion++;
         return *this;
     }
 
@@ -666,26 +1105,32 @@ namespace Runtime {
         entities = std::move(inOther.entities);
         globalComps = std::move(inOther.globalComps);
         archetypes = std::move(inOther.archetypes);
+        archetypeIndexMap = std::move(inOther.archetypeIndexMap);
+        archetypeVersion++;
+        inOther.archetypeVersion++;
         return *this;
     }
 
     Entity ECRegistry::Create()
     {
+        Internal::CheckStructuralChangeAllowed();
         const Entity result = entities.Allocate();
-        archetypes.at(entities.GetArchetype(result)).EmplaceElem(result);
+        entities.SetLocation(result, 0, archetypes[0].EmplaceElem(result));
         return result;
     }
 
     void ECRegistry::Create(Entity inEntity)
     {
+        Internal::CheckStructuralChangeAllowed();
         entities.Allocate(inEntity);
-        archetypes.at(entities.GetArchetype(inEntity)).EmplaceElem(inEntity);
+        entities.SetLocation(inEntity, 0, archetypes[0].EmplaceElem(inEntity));
     }
 
     void ECRegistry::Destroy(Entity inEntity)
     {
+        Internal::CheckStructuralChangeAllowed();
         Assert(Valid(inEntity));
-        archetypes.at(entities.GetArchetype(inEntity)).EraseElem(inEntity);
+        EraseElem(inEntity);
         entities.Free(inEntity);
     }
 
@@ -701,10 +1146,13 @@ namespace Runtime {
 
     void ECRegistry::Clear()
     {
+        Internal::CheckStructuralChangeAllowed();
         entities.Clear();
         globalComps.clear();
         archetypes.clear();
-        archetypes.emplace(0, Internal::Archetype({}));
+        archetypeIndexMap.clear();
+        EmplaceArchetype({});
+        archetypeVersion++;
     }
 
     void ECRegistry::Each(const EntityTraverseFunc& inFunc) const
@@ -734,8 +1182,7 @@ namespace Runtime {
 
     void ECRegistry::CompEach(Entity inEntity, const CompTraverseFunc& inFunc) const
     {
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        const Internal::Archetype& archetype = archetypes.at(archetypeId);
+        const Internal::Archetype& archetype = archetypes[entities.GetArchetype(inEntity)];
         for (const auto& compRtti : archetype.GetRttiVec()) {
             inFunc(compRtti.Class());
         }
@@ -743,8 +1190,7 @@ namespace Runtime {
 
     size_t ECRegistry::CompCount(Entity inEntity) const
     {
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        const Internal::Archetype& archetype = archetypes.at(archetypeId);
+        const Internal::Archetype& archetype = archetypes[entities.GetArchetype(inEntity)];
         return archetype.GetRttiVec().size();
     }
 
@@ -803,21 +1249,37 @@ namespace Runtime {
     void ECRegistry::Save(ECArchive& outArchive) const
     {
         outArchive = {};
-        outArchive.entities.reserve(Count());
-        Each([&](Entity entity) -> void {
-            outArchive.entities.emplace(entity, EntityArchive {});
-            auto& comps = outArchive.entities.at(entity).comps;
-            comps.reserve(CompCount(entity));
+        outArchive.archetypes.reserve(archetypes.size());
+        for (const auto& archetype : archetypes) {
+            if (archetype.Count() == 0) {
+                continue;
+            }
 
-            CompEach(entity, [&](CompClass clazz) -> void {
+            auto& archetypeArchive = outArchive.archetypes.emplace_back();
+            archetypeArchive.entities = archetype.All();
+            archetypeArchive.columns.reserve(archetype.GetRttiVec().size());
+            for (const auto& rtti : archetype.GetRttiVec()) {
+                const auto* clazz = rtti.Class();
                 if (clazz->IsTransient()) {
-                    return;
+                    continue;
                 }
-                comps.emplace(clazz, std::vector<uint8_t> {});
-                Common::MemorySerializeStream stream(comps.at(clazz));
-                GetDyn(clazz, entity).Serialize(stream);
-            });
-        });
+
+                auto& column = archetypeArchive.columns.emplace_back();
+                column.clazz = clazz;
+                Internal::GetCompMemberLayouts(clazz, column.members);
+                column.layoutHash = Internal::GetCompLayoutHash(clazz, column.members);
+                column.elemSize = column.layoutHash != 0 ? clazz->SizeOf() : 0;
+                if (column.layoutHash != 0) {
+                    column.data.resize(archetype.Count() * rtti.MemorySize());
+                    archetype.ReadColumn(clazz, 0, archetype.Count(), column.data.data());
+                } else {
+                    Common::MemorySerializeStream stream(column.data);
+                    for (auto i = 0; i < archetype.Count(); i++) {
+                        archetype.GetComp(i, clazz).Serialize(stream);
+                    }
+                }
+            }
+        }
 
         auto& gComps = outArchive.globalComps;
         gComps.reserve(GCompCount());
@@ -835,16 +1297,80 @@ namespace Runtime {
     {
         Clear();
 
-        for (const auto& [entity, entityArchive] : inArchive.entities) {
-            Create(entity);
-            for (const auto& [compClass, compData] : entityArchive.comps) {
-                if (compClass->IsTransient()) {
+        for (const auto& archetypeArchive : inArchive.archetypes) {
+            std::vector<Internal::CompRtti> rttiVec;
+            rttiVec.reserve(archetypeArchive.columns.size());
+            for (const auto& column : archetypeArchive.columns) {
+                if (!column.clazz->IsTransient()) {
+                    rttiVec.emplace_back(column.clazz);
+                }
+            }
+
+            Internal::ArchetypeId archetypeId = 0;
+            for (const auto& rtti : rttiVec) {
+                archetypeId += rtti.Class()->GetTypeInfo()->id;
+            }
+            Internal::ArchetypeIndex archetypeIndex = FindArchetype(archetypeId);
+            if (archetypeIndex == Internal::archetypeIndexNull) {
+                archetypeIndex = EmplaceArchetype(rttiVec);
+            }
+
+            const auto& archetypeEntities = archetypeArchive.entities;
+            auto& archetype = archetypes[archetypeIndex];
+            const Internal::ElemIndex beginElem = archetype.EmplaceElems(archetypeEntities);
+            for (auto i = 0; i < archetypeEntities.size(); i++) {
+                entities.Allocate(archetypeEntities[i]);
+                entities.SetLocation(archetypeEntities[i], archetypeIndex, beginElem + i);
+            }
+
+            for (const auto& column : archetypeArchive.columns) {
+                const auto* clazz = column.clazz;
+                if (clazz->IsTransient()) {
                     continue;
                 }
-                Assert(compClass->HasDefaultConstructor());
-                Mirror::Any compRef = EmplaceDyn(compClass, entity, {});
-                Common::MemoryDeserializeStream stream(compData);
-                compRef.Deserialize(stream);
+                if (column.layoutHash != 0 && column.layoutHash == Internal::GetCompLayoutHash(clazz)) {
+                    Assert(column.data.size() == archetypeEntities.size() * clazz->SizeOf());
+                    archetype.WriteColumn(clazz, beginElem, archetypeEntities.size(), column.data.data());
+                    continue;
+                }
+
+                Assert(clazz->HasDefaultConstructor());
+                const auto defaultObject = clazz->GetDefaultObject();
+                if (column.layoutHash != 0) {
+                    // component layout changed since level saved, copy the members still existing with the same name and type
+                    Assert(column.data.size() == archetypeEntities.size() * column.elemSize);
+                    for (auto i = 0; i < archetypeEntities.size(); i++) {
+                        const Mirror::Any compRef = archetype.EmplaceComp(beginElem + i, clazz, defaultObject);
+                        const uint8_t* elemBegin = column.data.data() + i * column.elemSize;
+                        for (const auto& member : column.members) {
+                            const auto* memberVariable = clazz->FindMemberVariable(member.name);
+                            if (memberVariable == nullptr
+                                || memberVariable->GetTypeInfo()->name != member.typeName
+                                || memberVariable->SizeOf() != member.size
+                                || !memberVariable->GetTypeInfo()->triviallyCopyable) {
+                                continue;
+                            }
+                            memcpy(memberVariable->GetDyn(compRef).Data(), elemBegin + member.offset, member.size);
+                        }
+                    }
+                    continue;
+                }
+
+                Common::MemoryDeserializeStream stream(column.data);
+                for (auto i = 0; i < archetypeEntities.size(); i++) {
+                    archetype.EmplaceComp(beginElem + i, clazz, defaultObject).Deserialize(stream);
+                }
+            }
+        }
+
+        for (const auto& archetypeArchive : inArchive.archetypes) {
+            for (const auto& column : archetypeArchive.columns) {
+                if (column.clazz->IsTransient()) {
+                    continue;
+                }
+                for (const auto entity : archetypeArchive.entities) {
+                    NotifyConstructedDyn(column.clazz, entity);
+                }
             }
         }
 
@@ -874,44 +1400,74 @@ namespace Runtime {
         }
     }
 
-    Mirror::Any ECRegistry::EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs)
+    Internal::ArchetypeIndex ECRegistry::FindArchetype(Internal::ArchetypeId inId) const
     {
-        Assert(Valid(inEntity));
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        Internal::Archetype& archetype = archetypes.at(archetypeId);
+        const auto iter = archetypeIndexMap.find(inId);
+        return iter == archetypeIndexMap.end() ? Internal::archetypeIndexNull : iter->second;
+    }
+
+    Internal::ArchetypeIndex ECRegistry::EmplaceArchetype(const std::vector<Internal::CompRtti>& inRttiVec)
+    {
+        const Internal::ArchetypeIndex result = archetypes.size();
+        const auto& archetype = archetypes.emplace_back(inRttiVec);
+        Assert(!archetypeIndexMap.contains(archetype.Id()));
+        archetypeIndexMap.emplace(archetype.Id(), result);
+        archetypeVersion++;
+        return result;
+    }
+
+    void ECRegistry::MoveElem(Entity inEntity, Internal::ArchetypeIndex inDstArchetypeIndex)
+    {
+        const auto srcArchetypeIndex = entities.GetArchetype(inEntity);
+        if (srcArchetypeIndex == inDstArchetypeIndex) {
+            return;
+        }
+        const auto dstElem = archetypes[inDstArchetypeIndex].EmplaceElem(inEntity, archetypes[srcArchetypeIndex], entities.GetElem(inEntity));
+        EraseElem(inEntity);
+        entities.SetLocation(inEntity, inDstArchetypeIndex, dstElem);
+    }
 
-        const Internal::ArchetypeId newArchetypeId = archetypeId + inClass->GetTypeInfo()->id;
-        entities.SetArchetype(inEntity, newArchetypeId);
+    void ECRegistry::EraseElem(Entity inEntity)
+    {
+        const auto elem = entities.GetElem(inEntity);
+        const auto movedEntity = archetypes[entities.GetArchetype(inEntity)].EraseElem(elem);
+        if (movedEntity != entityNull) {
+            entities.SetElem(movedEntity, elem);
+        }
+    }
+
+    Mirror::Any ECRegistry::EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs)
+    {
+        Internal::CheckStructuralChangeAllowed();
+        Assert(Valid(inEntity) && !HasDyn(inClass, inEntity));
+        const Internal::ArchetypeIndex archetypeIndex = entities.GetArchetype(inEntity);
+        const Internal::ArchetypeId newArchetypeId = archetypes[archetypeIndex].Id() + inClass->GetTypeInfo()->id;
 
-        if (!archetypes.contains(newArchetypeId)) {
-            archetypes.emplace(newArchetypeId, Internal::Archetype(archetype.NewRttiVecByAdd(Internal::CompRtti(inClass))));
+        Internal::ArchetypeIndex newArchetypeIndex = FindArchetype(newArchetypeId);
+        if (newArchetypeIndex == Internal::archetypeIndexNull) {
+            newArchetypeIndex = EmplaceArchetype(archetypes[archetypeIndex].NewRttiVecByAdd(Internal::CompRtti(inClass)));
         }
-        Internal::Archetype& newArchetype = archetypes.at(newArchetypeId);
-        newArchetype.EmplaceElem(inEntity, archetype.GetElem(inEntity), archetype.GetRttiVec());
-        archetype.EraseElem(inEntity);
+        MoveElem(inEntity, newArchetypeIndex);
 
         Mirror::Any tempObj = inClass->ConstructDyn(inArgs);
-        Mirror::Any compRef = newArchetype.EmplaceComp(inEntity, inClass, tempObj.Ref());
+        Mirror::Any compRef = archetypes[newArchetypeIndex].EmplaceComp(entities.GetElem(inEntity), inClass, tempObj.Ref());
         NotifyConstructedDyn(inClass, inEntity);
         return compRef;
     }
 
     void ECRegistry::RemoveDyn(CompClass inClass, Entity inEntity)
     {
+        Internal::CheckStructuralChangeAllowed();
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
-        const Internal::ArchetypeId archetypeId = entities.GetArchetype(inEntity);
-        Internal::Archetype& archetype = archetypes.at(archetypeId);
+        const Internal::ArchetypeIndex archetypeIndex = entities.GetArchetype(inEntity);
+        const Internal::ArchetypeId newArchetypeId = archetypes[archetypeIndex].Id() - inClass->GetTypeInfo()->id;
 
-        const Internal::ArchetypeId newArchetypeId = archetypeId - inClass->GetTypeInfo()->id;
-        entities.SetArchetype(inEntity, newArchetypeId);
-
-        if (!archetypes.contains(newArchetypeId)) {
-            archetypes.emplace(newArchetypeId, Internal::Archetype(archetype.NewRttiVecByRemove(Internal::CompRtti(inClass))));
+        Internal::ArchetypeIndex newArchetypeIndex = FindArchetype(newArchetypeId);
+        if (newArchetypeIndex == Internal::archetypeIndexNull) {
+            newArchetypeIndex = EmplaceArchetype(archetypes[archetypeIndex].NewRttiVecByRemove(Internal::CompRtti(inClass)));
         }
         NotifyRemoveDyn(inClass, inEntity);
-        Internal::Archetype& newArchetype = archetypes.at(newArchetypeId);
-        newArchetype.EmplaceElem(inEntity, archetype.GetElem(inEntity), archetype.GetRttiVec());
-        archetype.EraseElem(inEntity);
+        MoveElem(inEntity, newArchetypeIndex);
     }
 
     void ECRegistry::UpdateDyn(CompClass inClass, Entity inEntity, const DynUpdateFunc& inFunc)
@@ -930,9 +1486,7 @@ namespace Runtime {
     bool ECRegistry::HasDyn(CompClass inClass, Entity inEntity) const
     {
         Assert(Valid(inEntity));
-        return archetypes
-            .at(entities.GetArchetype(inEntity))
-            .Contains(inClass);
+        return archetypes[entities.GetArchetype(inEntity)].Contains(inClass);
     }
 
     Mirror::Any ECRegistry::FindDyn(CompClass inClass, Entity inEntity)
@@ -948,18 +1502,14 @@ namespace Runtime {
     Mirror::Any ECRegistry::GetDyn(CompClass inClass, Entity inEntity)
     {
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
-        Mirror::Any compRef = archetypes
-            .at(entities.GetArchetype(inEntity))
-            .GetComp(inEntity, inClass);
+        Mirror::Any compRef = archetypes[entities.GetArchetype(inEntity)].GetComp(entities.GetElem(inEntity), inClass);
         return compRef;
     }
 
     Mirror::Any ECRegistry::GetDyn(CompClass inClass, Entity inEntity) const
     {
         Assert(Valid(inEntity) && HasDyn(inClass, inEntity));
-        Mirror::Any compRef = archetypes
-            .at(entities.GetArchetype(inEntity))
-            .GetComp(inEntity, inClass);
+        Mirror::Any compRef = archetypes[entities.GetArchetype(inEntity)].GetComp(entities.GetElem(inEntity), inClass);
         return compRef.ConstRef();
     }
 
@@ -997,6 +1547,7 @@ namespace Runtime {
 
     Mirror::Any ECRegistry::GEmplaceDyn(GCompClass inClass, const Mirror::ArgumentList& inArgs)
     {
+        Internal::CheckStructuralChangeAllowed();
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(!GHasDyn(inClass));
         globalComps.emplace(inClass, inClass->ConstructDyn(inArgs));
@@ -1006,6 +1557,7 @@ namespace Runtime {
 
     void ECRegistry::GRemoveDyn(GCompClass inClass)
     {
+        Internal::CheckStructuralChangeAllowed();
         Assert(Internal::IsGlobalCompClass(inClass));
         Assert(GHasDyn(inClass));
         GNotifyRemoveDyn(inClass);
@@ -1077,6 +1629,235 @@ namespace Runtime {
         return globalComps.size();
     }
 
+    CommandBuffer::EntityChanges::EntityChanges(Entity inEntity)
+        : entity(inEntity)
+        , created(false)
+        , destroyed(false)
+        , srcArchetypeIndex(0)
+        , dstArchetypeId(0)
+    {
+    }
+
+    CommandBuffer::CommandBuffer()
+        : placeholderCounter(0)
+    {
+    }
+
+    CommandBuffer::~CommandBuffer()
+    {
+        Assert(commands.empty());
+    }
+
+    Entity CommandBuffer::Create()
+    {
+        std::unique_lock lock(mutex);
+        const Entity placeholder = placeholderBit | ++placeholderCounter;
+        commands.emplace_back(Command { CommandType::create, placeholder, nullptr, Mirror::Any() });
+        return placeholder;
+    }
+
+    void CommandBuffer::Destroy(Entity inEntity)
+    {
+        Record({ CommandType::destroy, inEntity, nullptr, Mirror::Any() });
+    }
+
+    void CommandBuffer::EmplaceDyn(CompClass inClass, Entity inEntity, const Mirror::ArgumentList& inArgs)
+    {
+        // arguments may reference caller stack, so component is constructed at record time and moved in on playback
+        Record({ CommandType::emplace, inEntity, inClass, inClass->ConstructDyn(inArgs) });
+    }
+
+    void CommandBuffer::RemoveDyn(CompClass inClass, Entity inEntity)
+    {
+        Record({ CommandType::remove, inEntity, inClass, Mirror::Any() });
+    }
+
+    size_t CommandBuffer::Count() const
+    {
+        std::unique_lock lock(mutex);
+        return commands.size();
+    }
+
+    bool CommandBuffer::Empty() const
+    {
+        return Count() == 0;
+    }
+
+    void CommandBuffer::Playback(ECRegistry& inRegistry)
+    {
+        Internal::CheckStructuralChangeAllowed();
+        std::vector<Command> commandsToExecute;
+        {
+            std::unique_lock lock(mutex);
+            commandsToExecute.swap(commands);
+            placeholderCounter = 0;
+        }
+
+        auto changes = MergeCommands(inRegistry, commandsToExecute);
+        ApplyChanges(inRegistry, changes);
+    }
+
+    Entity CommandBuffer::GetCreated(Entity inPlaceholder) const
+    {
+        Assert(IsPlaceholder(inPlaceholder));
+        return createdEntities.at(inPlaceholder);
+    }
+
+    void CommandBuffer::Clear()
+    {
+        std::unique_lock lock(mutex);
+        commands.clear();
+        placeholderCounter = 0;
+    }
+
+    bool CommandBuffer::IsPlaceholder(Entity inEntity)
+    {
+        return (inEntity & placeholderBit) != 0;
+    }
+
+    void CommandBuffer::Record(Command&& inCommand)
+    {
+        std::unique_lock lock(mutex);
+        commands.emplace_back(std::move(inCommand));
+    }
+
+    std::vector<CommandBuffer::EntityChanges> CommandBuffer::MergeCommands(ECRegistry& inRegistry, std::vector<Command>& inCommands)
+    {
+        std::vector<EntityChanges> result;
+        std::unordered_map<Entity, size_t> changesIndexMap;
+        createdEntities.clear();
+
+        const auto getChanges = [&](Entity inEntity) -> EntityChanges& {
+            const Entity entity = IsPlaceholder(inEntity) ? createdEntities.at(inEntity) : inEntity;
+            if (const auto iter = changesIndexMap.find(entity); iter != changesIndexMap.end()) {
+                return result[iter->second];
+            }
+            Assert(inRegistry.Valid(entity));
+            changesIndexMap.emplace(entity, result.size());
+            auto& changes = result.emplace_back(entity);
+            changes.srcArchetypeIndex = inRegistry.entities.GetArchetype(entity);
+            changes.dstArchetypeId = inRegistry.archetypes[changes.srcArchetypeIndex].Id();
+            return changes;
+        };
+
+        const auto srcContains = [&](const EntityChanges& inChanges, CompClass inClass) -> bool {
+            return !inChanges.created && inRegistry.archetypes[inChanges.srcArchetypeIndex].Contains(inClass);
+        };
+
+        for (auto& command : inCommands) {
+            if (command.type == CommandType::create) {
+                const Entity entity = inRegistry.entities.Allocate();
+                createdEntities.emplace(command.entity, entity);
+                getChanges(entity).created = true;
+                continue;
+            }
+
+            auto& changes = getChanges(command.entity);
+            Assert(!changes.destroyed);
+            if (command.type == CommandType::destroy) {
+                changes.destroyed = true;
+                changes.adds.clear();
+                changes.removes.clear();
+            } else if (command.type == CommandType::emplace) {
+                const auto iter = std::ranges::find_if(changes.adds, [&](const auto& pair) -> bool { return pair.first == command.clazz; });
+                Assert(iter == changes.adds.end());
+                Assert(!srcContains(changes, command.clazz) || std::ranges::find(changes.removes, command.clazz) != changes.removes.end());
+                changes.adds.emplace_back(command.clazz, std::move(command.comp));
+            } else if (command.type == CommandType::remove) {
+                const auto iter = std::ranges::find_if(changes.adds, [&](const auto& pair) -> bool { return pair.first == command.clazz; });
+                if (iter != changes.adds.end()) {
+                    changes.adds.erase(iter);
+                } else {
+                    Assert(srcContains(changes, command.clazz) && std::ranges::find(changes.removes, command.clazz) == changes.removes.end());
+                    changes.removes.emplace_back(command.clazz);
+                }
+            } else {
+                QuickFail();
+            }
+        }
+
+        for (auto& changes : result) {
+            for (const auto* clazz : changes.removes) {
+                changes.dstArchetypeId -= clazz->GetTypeInfo()->id;
+            }
+            for (const auto& clazz : changes.adds | std::views::keys) {
+                changes.dstArchetypeId += clazz->GetTypeInfo()->id;
+            }
+        }
+        return result;
+    }
+
+    void CommandBuffer::ApplyChanges(ECRegistry& inRegistry, std::vector<EntityChanges>& inChanges)
+    {
+        // same as ECRegistry::RemoveDyn, remove events are fired before components are destructed
+        for (const auto& changes : inChanges) {
+            if (changes.destroyed) {
+                continue;
+            }
+            for (const auto* clazz : changes.removes) {
+                inRegistry.NotifyRemoveDyn(clazz, changes.entity);
+            }
+        }
+
+        std::ranges::sort(inChanges, [](const EntityChanges& lhs, const EntityChanges& rhs) -> bool {
+            return lhs.dstArchetypeId < rhs.dstArchetypeId;
+        });
+
+        Internal::ArchetypeIndex dstArchetypeIndex = Internal::archetypeIndexNull;
+        for (auto& changes : inChanges) {
+            const auto entity = changes.entity;
+            if (changes.destroyed) {
+                if (changes.created) {
+                    inRegistry.entities.Free(entity);
+                } else {
+                    inRegistry.Destroy(entity);
+                }
+                continue;
+            }
+
+            if (dstArchetypeIndex == Internal::archetypeIndexNull || inRegistry.archetypes[dstArchetypeIndex].Id() != changes.dstArchetypeId) {
+                dstArchetypeIndex = inRegistry.FindArchetype(changes.dstArchetypeId);
+                if (dstArchetypeIndex == Internal::archetypeIndexNull) {
+                    auto rttiVec = changes.created ? std::vector<Internal::CompRtti> {} : inRegistry.archetypes[changes.srcArchetypeIndex].GetRttiVec();
+                    std::erase_if(rttiVec, [&](const Internal::CompRtti& rtti) -> bool { return std::ranges::find(changes.removes, rtti.Class()) != changes.removes.end(); });
+                    for (const auto& clazz : changes.adds | std::views::keys) {
+                        if (std::ranges::find_if(rttiVec, [&](const Internal::CompRtti& rtti) -> bool { return rtti.Class() == clazz; }) == rttiVec.end()) {
+                            rttiVec.emplace_back(clazz);
+                        }
+                    }
+                    dstArchetypeIndex = inRegistry.EmplaceArchetype(rttiVec);
+                }
+            }
+
+            if (changes.created) {
+                inRegistry.entities.SetLocation(entity, dstArchetypeIndex, inRegistry.archetypes[dstArchetypeIndex].EmplaceElem(entity));
+            } else {
+                inRegistry.MoveElem(entity, dstArchetypeIndex);
+            }
+
+            auto& dstArchetype = inRegistry.archetypes[dstArchetypeIndex];
+            const auto& srcArchetype = inRegistry.archetypes[changes.srcArchetypeIndex];
+            const auto dstElem = inRegistry.entities.GetElem(entity);
+            for (auto& [clazz, comp] : changes.adds) {
+                // component removed and emplaced again in this buffer is replaced in place
+                if (!changes.created && srcArchetype.Contains(clazz)) {
+                    dstArchetype.GetComp(dstElem, clazz).MoveAssign(comp);
+                } else {
+                    dstArchetype.EmplaceComp(dstElem, clazz, comp.Ref());
+                }
+            }
+        }
+
+        for (const auto& changes : inChanges) {
+            if (changes.destroyed) {
+                continue;
+            }
+            for (const auto& clazz : changes.adds | std::views::keys) {
+                inRegistry.NotifyConstructedDyn(clazz, changes.entity);
+            }
+        }
+    }
+
     SystemGroup::SystemGroup(std::string inName, SystemExecuteStrategy inStrategy)
         : name(std::move(inName))
         , strategy(inStrategy)
@@ -1228,66 +2009,141 @@ namespace Runtime {
         });
     }
 
+    SystemPipelineStats::SystemPipelineStats()
+        : performCount(0)
+        , lastWallTimeUs(0)
+        , lastCriticalPathTimeUs(0)
+        , lastScheduleOverheadUs(0)
+        , maxScheduleOverheadUs(0)
+    {
+    }
+
     SystemPipeline::SystemPipeline(const SystemGraph& inGraph)
+        : currentAction(nullptr)
     {
         const auto& systemGroups = inGraph.GetGroups();
-        systemGraph.reserve(systemGroups.size());
-
+        size_t systemNum = 0;
         for (const auto& group : systemGroups) {
-            auto& [systemContexts, strategy] = systemGraph.emplace_back();
-            const auto& factories = group.GetSystems();
+            systemNum += group.GetSystems().size();
+        }
 
-            strategy = group.GetStrategy();
-            systemContexts.reserve(factories.size());
+        std::vector<std::pair<size_t, SystemExecuteStrategy>> belongGroups;
+        belongGroups.reserve(systemNum);
+        systems.reserve(systemNum);
+        for (auto i = 0; i < systemGroups.size(); i++) {
+            const auto& group = systemGroups[i];
             for (const auto& factory : group.GetSystems()) {
-                systemContexts.emplace_back(factory, nullptr);
+                systems.emplace_back(factory, nullptr, std::vector<size_t> {}, 0);
+                belongGroups.emplace_back(i, group.GetStrategy());
             }
         }
+        BuildDependencies(belongGroups);
+        Compile();
     }
 
-    void SystemPipeline::ParallelPerformAction(const ActionFunc& inActionFunc)
+    SystemPipeline::~SystemPipeline() = default;
+
+    const SystemPipelineStats& SystemPipeline::GetStats() const
     {
-        tf::Taskflow taskFlow;
-        auto lastBarrier = taskFlow.emplace([]() -> void { Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker); });
-
-        for (auto& groupContext : systemGraph) {
-            if (groupContext.strategy == SystemExecuteStrategy::sequential) {
-                tf::Task lastTask = lastBarrier;
-                for (auto& systemContext : groupContext.systems) {
-                    auto task = taskFlow.emplace([&]() -> void {
-                        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
-                        inActionFunc(systemContext);
-                    });
-                    task.succeed(lastTask);
-                    lastTask = task;
+        return stats;
+    }
+
+    size_t SystemPipeline::GetSystemNum() const
+    {
+        return systems.size();
+    }
+
+    size_t SystemPipeline::GetDependencyNum() const
+    {
+        size_t result = 0;
+        for (const auto& systemContext : systems) {
+            result += systemContext.dependencies.size();
+        }
+        return result;
+    }
+
+    void SystemPipeline::BuildDependencies(const std::vector<std::pair<size_t, SystemExecuteStrategy>>& inSystemGroups)
+    {
+        // systems are already in topological order, walk the candidates from the nearest one and skip those already
+        // reachable through a recorded dependency, so only the transitive reduction becomes task edges
+        std::vector<std::vector<bool>> ancestors(systems.size(), std::vector<bool>(systems.size(), false));
+        for (auto after = 0; after < systems.size(); after++) {
+            const auto& [afterGroup, afterStrategy] = inSystemGroups[after];
+            auto& afterAncestors = ancestors[after];
+
+            for (auto before = after; before > 0; before--) {
+                const auto beforeIndex = before - 1;
+                if (afterAncestors[beforeIndex]) {
+                    continue;
                 }
-                lastBarrier = lastTask;
-            } else if (groupContext.strategy == SystemExecuteStrategy::concurrent) {
-                std::vector<tf::Task> tasks;
-                tasks.reserve(groupContext.systems.size());
-
-                for (auto& systemContext : groupContext.systems) {
-                    tasks.emplace_back(taskFlow.emplace([&]() -> void {
-                        Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
-                        inActionFunc(systemContext);
-                    }));
-                    tasks.back().succeed(lastBarrier);
+                const auto beforeGroup = inSystemGroups[beforeIndex].first;
+                if (!Internal::NeedOrder(systems[beforeIndex].factory, beforeGroup, systems[after].factory, afterGroup, afterStrategy)) {
+                    continue;
                 }
 
-                auto barrier = taskFlow.emplace([]() -> void { Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker); });
-                for (const auto& task : tasks) {
-                    barrier.succeed(task);
+                systems[after].dependencies.emplace_back(beforeIndex);
+                afterAncestors[beforeIndex] = true;
+                const auto& beforeAncestors = ancestors[beforeIndex];
+                for (auto i = 0; i < beforeIndex; i++) {
+                    if (beforeAncestors[i]) {
+                        afterAncestors[i] = true;
+                    }
                 }
-                lastBarrier = barrier;
-            } else {
-                QuickFail();
             }
         }
+    }
 
-        tf::Executor executor;
-        executor
-            .run(taskFlow)
-            .wait();
+    void SystemPipeline::Compile()
+    {
+        taskflow = Common::MakeUnique<tf::Taskflow>();
+
+        std::vector<tf::Task> tasks;
+        tasks.reserve(systems.size());
+        for (auto& systemContext : systems) {
+            auto task = taskflow->emplace([this, &systemContext]() -> void {
+                Core::ScopedThreadTag threadTag(Core::ThreadTag::gameWorker);
+                // workers may join nested runs, so the outer performing system is restored
+                const auto* lastPerformingSystem = Internal::performingSystem;
+                Internal::performingSystem = &systemContext.factory;
+                const auto beginTime = Common::TimePoint::Now().ToMicroseconds();
+                (*currentAction)(systemContext);
+                systemContext.lastExecuteTimeUs = Common::TimePoint::Now().ToMicroseconds() - beginTime;
+                Internal::performingSystem = lastPerformingSystem;
+            });
+            for (const auto dependency : systemContext.dependencies) {
+                task.succeed(tasks[dependency]);
+            }
+            tasks.emplace_back(task);
+        }
+    }
+
+    void SystemPipeline::ParallelPerformAction(const ActionFunc& inActionFunc)
+    {
+        const auto beginTime = Common::TimePoint::Now().ToMicroseconds();
+        currentAction = &inActionFunc;
+        GameWorkerThreads::Get().Run(*taskflow);
+        currentAction = nullptr;
+        UpdateStats(Common::TimePoint::Now().ToMicroseconds() - beginTime);
+    }
+
+    void SystemPipeline::UpdateStats(uint64_t inWallTimeUs)
+    {
+        uint64_t criticalPathTimeUs = 0;
+        std::vector<uint64_t> finishTimes(systems.size(), 0);
+        for (auto i = 0; i < systems.size(); i++) {
+            uint64_t startTimeUs = 0;
+            for (const auto dependency : systems[i].dependencies) {
+                startTimeUs = std::max(startTimeUs, finishTimes[dependency]);
+            }
+            finishTimes[i] = startTimeUs + systems[i].lastExecuteTimeUs;
+            criticalPathTimeUs = std::max(criticalPathTimeUs, finishTimes[i]);
+        }
+
+        stats.performCount++;
+        stats.lastWallTimeUs = inWallTimeUs;
+        stats.lastCriticalPathTimeUs = criticalPathTimeUs;
+        stats.lastScheduleOverheadUs = inWallTimeUs > criticalPathTimeUs ? inWallTimeUs - criticalPathTimeUs : 0;
+        stats.maxScheduleOverheadUs = std::max(stats.maxScheduleOverheadUs, stats.lastScheduleOverheadUs);
     }
 
     SystemSetupContext::SystemSetupContext()
@@ -1299,18 +2155,20 @@ namespace Runtime {
     SystemGraphExecutor::SystemGraphExecutor(ECRegistry& inEcRegistry, const SystemGraph& inSystemGraph, const SystemSetupContext& inSetupContext)
         : ecRegistry(inEcRegistry)
         , systemGraph(inSystemGraph)
-        , pipeline(inSystemGraph)
+        , pipeline(systemGraph)
     {
-        pipeline.ParallelPerformAction([&](SystemPipeline::SystemContext& context) -> void {
+        // systems are built and destroyed sequentially outside of the pipeline, so constructors and destructors may
+        // make structural changes whatever accesses the systems declare for ticking
+        for (auto& context : pipeline.systems) {
             context.instance = context.factory.Build(inEcRegistry, inSetupContext);
-        });
+        }
     }
 
     SystemGraphExecutor::~SystemGraphExecutor()
     {
-        pipeline.ParallelPerformAction([](SystemPipeline::SystemContext& context) -> void {
+        for (auto& context : std::ranges::reverse_view(pipeline.systems)) {
             context.instance = nullptr;
-        });
+        }
         ecRegistry.CheckEventsUnbound();
     }
 
@@ -1320,4 +2178,9 @@ namespace Runtime {
             context.instance->Tick(inDeltaTimeSeconds);
         });
     }
+
+    const SystemPipelineStats& SystemGraphExecutor::GetPipelineStats() const
+    {
+        return pipeline.GetStats();
+    }
 } // namespace Runtime
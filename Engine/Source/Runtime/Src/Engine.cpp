@@ -39,6 +39,7 @@ namespace Runtime {
         ::Core::ModuleManager::Get().Unload("Render");
 
         GameWorkerThreads::Get().Stop();
+        Core::Logger::Get().Stop();
     }
 
     void Engine::MountWorld(World* inWorld)
@@ -66,9 +67,10 @@ namespace Runtime {
         Core::ThreadContext::IncFrameNumber();
 
         auto& renderThread = renderModule->GetRenderThread();
-        renderThread.EmplaceTask([]() -> void {
+        renderThread.EmplaceDetachedTask([renderModule = renderModule]() -> void {
             Core::ThreadContext::IncFrameNumber();
             Core::Console::Get().PerformRenderThreadSettingsCopy();
+            renderModule->ForfeitCaches();
         });
 
         for (auto* world : worlds) {
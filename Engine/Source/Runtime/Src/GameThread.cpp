@@ -4,6 +4,19 @@
 
 #include <Runtime/GameThread.h>
 
+namespace Runtime::Internal {
+    // names executor workers like the workers of Common::ThreadPool, profilers and debuggers group threads by name
+    class GameWorkerInterface final : public tf::WorkerInterface {
+    public:
+        void scheduler_prologue(tf::Worker& inWorker) override
+        {
+            Common::NamedThread::SetCurrentThreadName("GameWorkers-" + std::to_string(inWorker.id()));
+        }
+
+        void scheduler_epilogue(tf::Worker& inWorker, std::exception_ptr inException) override {}
+    };
+}
+
 namespace Runtime {
     GameThread& GameThread::Get()
     {
@@ -38,20 +51,43 @@ namespace Runtime {
         return instance;
     }
 
-
     GameWorkerThreads::GameWorkerThreads() = default;
 
     GameWorkerThreads::~GameWorkerThreads() = default;
 
     void GameWorkerThreads::Start()
     {
-        Assert(threads == nullptr);
-        threads = Common::MakeUnique<Common::ThreadPool>("GameWorkers", 8);
+        Assert(executor == nullptr);
+        executor = Common::MakeUnique<tf::Executor>(8, std::make_shared<Internal::GameWorkerInterface>());
     }
 
     void GameWorkerThreads::Stop()
     {
-        Assert(threads != nullptr);
-        threads = nullptr;
+        Assert(executor != nullptr);
+        executor->wait_for_all();
+        executor = nullptr;
+    }
+
+    bool GameWorkerThreads::IsStarted() const
+    {
+        return executor != nullptr;
+    }
+
+    void GameWorkerThreads::Run(tf::Taskflow& inTaskflow)
+    {
+        Assert(executor != nullptr);
+        // blocking wait on a worker would starve the pool when runs are nested (e.g. ParallelEach inside a system task),
+        // so workers join the execution instead
+        if (executor->this_worker_id() >= 0) {
+            executor->run_and_wait(inTaskflow);
+        } else {
+            executor->run(inTaskflow).wait();
+        }
+    }
+
+    size_t GameWorkerThreads::ThreadNum() const
+    {
+        Assert(executor != nullptr);
+        return executor->num_workers();
     }
 } // namespace Runtime
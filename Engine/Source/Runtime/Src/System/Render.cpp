@@ -20,7 +20,7 @@ namespace Runtime {
 
     RenderSystem::~RenderSystem() // NOLINT
     {
-        renderModule.GetRenderThread().EmplaceTask([fence = lastFrameFence]() -> void {
+        renderModule.GetRenderThread().EmplaceDetachedTask([fence = lastFrameFence]() -> void {
             fence->Wait();
             delete fence;
         });
@@ -29,7 +29,7 @@ namespace Runtime {
     void RenderSystem::Tick(float inDeltaTimeSeconds)
     {
         auto& clientViewport = client->GetViewport();
-        renderModule.GetRenderThread().EmplaceTask(
+        renderModule.GetRenderThread().EmplaceDetachedTask(
             [
                 fence = lastFrameFence,
                 views = BuildViews(),
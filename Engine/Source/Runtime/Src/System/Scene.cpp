@@ -27,7 +27,7 @@ namespace Runtime {
     SceneSystem::~SceneSystem() // NOLINT
     {
         auto& sceneHolder = registry.GGet<SceneHolder>();
-        renderModule.GetRenderThread().EmplaceTask([scene = std::exchange(sceneHolder.scene, nullptr)]() -> void {
+        renderModule.GetRenderThread().EmplaceDetachedTask([scene = std::exchange(sceneHolder.scene, nullptr)]() -> void {
             delete scene;
         });
     }
@@ -54,5 +54,19 @@ namespace Runtime {
         directionalLightsObserver.Clear();
         pointLightsObserver.Clear();
         spotLightsObserver.Clear();
+
+        FlushSceneProxyDeltas();
+    }
+
+    void SceneSystem::FlushSceneProxyDeltas()
+    {
+        if (lightSceneProxyDeltas.Empty()) {
+            return;
+        }
+
+        const auto& sceneHolder = registry.GGet<SceneHolder>();
+        renderModule.GetRenderThread().EmplaceDetachedTask([scene = sceneHolder.scene, lightDeltas = std::exchange(lightSceneProxyDeltas, {})]() mutable -> void {
+            scene->Apply(std::move(lightDeltas));
+        });
     }
 }
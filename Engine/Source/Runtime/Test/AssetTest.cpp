@@ -2,6 +2,8 @@
 // Created by johnk on 2023/10/16.
 //
 
+#include <latch>
+
 #include <Test/Test.h>
 
 #include <AssetTest.h>
@@ -66,3 +68,201 @@ TEST(AssetTest, AsyncLoadTest)
         ASSERT_EQ(restore->b, "hello");
     });
 }
+
+TEST(AssetTest, AsyncLoadDeduplicateTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.AsyncLoadDeduplicateTest");
+    {
+        AssetPtr<TestAsset> asset = MakeShared<TestAsset>(uri, 2, "world");
+        AssetManager::Get().Save(asset);
+    }
+
+    constexpr size_t requestNum = 16;
+    const uint32_t loadConstructedNum = TestAsset::loadConstructedNum;
+    std::latch latch(requestNum);
+    std::mutex mutex;
+    std::vector<AssetPtr<TestAsset>> results;
+    for (auto i = 0; i < requestNum; i++) {
+        AssetManager::Get().AsyncLoad<TestAsset>(uri, [&](AssetPtr<TestAsset> restore) -> void {
+            {
+                std::unique_lock lock(mutex);
+                results.emplace_back(restore);
+            }
+            latch.count_down();
+        });
+    }
+    latch.wait();
+
+    // requests of the same uri share one load task, so the asset is deserialized once
+    ASSERT_EQ(TestAsset::loadConstructedNum - loadConstructedNum, 1);
+    for (const auto& result : results) {
+        ASSERT_EQ(result.Get(), results[0].Get());
+        ASSERT_EQ(result->a, 2);
+        ASSERT_EQ(result->b, "world");
+    }
+}
+
+TEST(AssetTest, DependencyLoadTest)
+{
+    static Core::Uri uri("asset://Engine/Test/Generated/Runtime/AssetTest.DependencyLoadTest");
+    constexpr uint32_t memberNum = 32;
+    constexpr uint32_t distinctMemberNum = 20;
+    {
+        AssetPtr<TestAssetGroup> group = MakeShared<TestAssetGroup>(uri);
+        for (auto i = 0; i < memberNum; i++) {
+            const auto index = i % distinctMemberNum;
+            AssetPtr<TestAsset> member = MakeShared<TestAsset>(
+                Core::Uri(std::format("asset://Engine/Test/Generated/Runtime/AssetTest.DependencyLoadTest.Member{}", index)),
+                index, std::to_string(index));
+            AssetManager::Get().Save(member);
+            group->members.emplace_back(member);
+        }
+        AssetManager::Get().Save(group);
+    }
+
+    const AssetPtr<TestAssetGroup> restore = AssetManager::Get().SyncLoad<TestAssetGroup>(uri);
+    ASSERT_EQ(restore->members.size(), memberNum);
+    for (auto i = 0; i < memberNum; i++) {
+        const auto index = i % distinctMemberNum;
+        ASSERT_EQ(restore->members[i]->a, index);
+        ASSERT_EQ(restore->members[i]->b, std::to_string(index));
+        ASSERT_EQ(restore->members[i].Get(), restore->members[index].Get());
+    }
+}
+
+TEST(AssetTest, CycleDependencyLoadTest)
+{
+    constexpr uint32_t cycleNum = 16;
+    const auto getUri = [](uint32_t inCycle, uint32_t inIndex) -> Core::Uri {
+        return Core::Uri(std::format("asset://Engine/Test/Generated/Runtime/AssetTest.CycleDependencyLoadTest.Cycle{}.Asset{}", inCycle, inIndex));
+    };
+    for (auto i = 0; i < cycleNum; i++) {
+        AssetPtr<TestCycleAsset> asset0 = MakeShared<TestCycleAsset>(getUri(i, 0), 0);
+        AssetPtr<TestCycleAsset> asset1 = MakeShared<TestCycleAsset>(getUri(i, 1), 1);
+        asset0->links.emplace_back(TestCycleAssetLink { asset1 });
+        asset1->links.emplace_back(TestCycleAssetLink { asset0 });
+        AssetManager::Get().Save(asset0);
+        AssetManager::Get().Save(asset1);
+        asset0->links.clear();
+    }
+
+    const auto checkCycle = [](const AssetPtr<TestCycleAsset>& asset0) -> void {
+        ASSERT_EQ(asset0->a, 0);
+        ASSERT_EQ(asset0->links.size(), 1);
+        const auto& asset1 = asset0->links[0].asset;
+        ASSERT_EQ(asset1->a, 1);
+        ASSERT_EQ(asset1->links.size(), 1);
+        ASSERT_EQ(asset1->links[0].asset.Get(), asset0.Get());
+        // break the ref cycle so the assets can be released
+        asset0->links.clear();
+    };
+
+    checkCycle(AssetManager::Get().SyncLoad<TestCycleAsset>(getUri(0, 0)));
+
+    // both ends of a cycle loaded from different threads at once
+    for (auto i = 1; i < cycleNum; i++) {
+        std::latch latch(2);
+        AssetPtr<TestCycleAsset> restore0;
+        AssetPtr<TestCycleAsset> restore1;
+        AssetManager::Get().AsyncLoad<TestCycleAsset>(getUri(i, 0), [&](AssetPtr<TestCycleAsset> restore) -> void {
+            restore0 = restore;
+            latch.count_down();
+        });
+        AssetManager::Get().AsyncLoad<TestCycleAsset>(getUri(i, 1), [&](AssetPtr<TestCycleAsset> restore) -> void {
+            restore1 = restore;
+            latch.count_down();
+        });
+        latch.wait();
+
+        ASSERT_EQ(restore0->links[0].asset.Get(), restore1.Get());
+        checkCycle(restore0);
+    }
+}
+
+TEST(AssetTest, StreamingCancelTest)
+{
+    static Core::Uri blockerUri("asset://Engine/Test/Generated/Runtime/AssetTest.StreamingCancelTest.Blocker");
+    static Core::Uri uri0("asset://Engine/Test/Generated/Runtime/AssetTest.StreamingCancelTest.0");
+    static Core::Uri uri1("asset://Engine/Test/Generated/Runtime/AssetTest.StreamingCancelTest.1");
+    {
+        AssetManager::Get().Save(AssetPtr<TestAsset>(MakeShared<TestAsset>(blockerUri, 0, "blocker")));
+        AssetManager::Get().Save(AssetPtr<TestAsset>(MakeShared<TestAsset>(uri0, 0, "0")));
+        AssetManager::Get().Save(AssetPtr<TestAsset>(MakeShared<TestAsset>(uri1, 1, "1")));
+    }
+
+    // occupy all asset workers so the stream requests below stay pending
+    constexpr size_t assetWorkerNum = 4;
+    std::latch blockersStarted(assetWorkerNum);
+    std::promise<void> releaseBlockers;
+    std::shared_future<void> blockersReleased = releaseBlockers.get_future().share();
+    for (auto i = 0; i < assetWorkerNum; i++) {
+        AssetManager::Get().AsyncLoad<TestAsset>(blockerUri, [&, blockersReleased](AssetPtr<TestAsset>) -> void {
+            blockersStarted.count_down();
+            blockersReleased.wait();
+        });
+    }
+    blockersStarted.wait();
+
+    const auto cancelledNum = AssetManager::Get().GetStreamingStats().cancelledNum;
+    std::atomic<bool> cancelledCallbackInvoked = false;
+    std::latch streamed(1);
+    const AssetStreamHandle handle0 = AssetManager::Get().StreamSoft<TestAsset>(SoftAssetPtr<TestAsset>(uri0), 0, [&](AssetPtr<TestAsset>) -> void {
+        cancelledCallbackInvoked = true;
+    });
+    const AssetStreamHandle handle1 = AssetManager::Get().StreamSoft<TestAsset>(SoftAssetPtr<TestAsset>(uri1), 0, [&](AssetPtr<TestAsset> asset) -> void {
+        ASSERT_EQ(asset->a, 1);
+        streamed.count_down();
+    });
+    handle1.SetPriority(10);
+    ASSERT_EQ(handle0.State(), AssetStreamState::pending);
+    ASSERT_TRUE(handle0.Cancel());
+    ASSERT_EQ(handle0.State(), AssetStreamState::cancelled);
+    ASSERT_FALSE(handle0.Cancel());
+
+    releaseBlockers.set_value();
+    streamed.wait();
+    ASSERT_FALSE(cancelledCallbackInvoked);
+    ASSERT_FALSE(handle1.Cancel());
+    ASSERT_EQ(AssetManager::Get().GetStreamingStats().cancelledNum, cancelledNum + 1);
+    ASSERT_EQ(AssetManager::Get().GetStreamed(SoftAssetPtr<TestAsset>(uri0)), nullptr);
+}
+
+TEST(AssetTest, StreamingBudgetTest)
+{
+    std::vector<SoftAssetPtr<TestAsset>> softAssets;
+    for (auto i = 0; i < 3; i++) {
+        AssetPtr<TestAsset> asset = MakeShared<TestAsset>(Core::Uri(std::format("asset://Engine/Test/Generated/Runtime/AssetTest.StreamingBudgetTest.{}", i)), i, "streaming");
+        AssetManager::Get().Save(asset);
+        softAssets.emplace_back(asset.Uri());
+    }
+
+    const auto stream = [](const SoftAssetPtr<TestAsset>& softAsset) -> void {
+        std::latch streamed(1);
+        AssetManager::Get().StreamSoft<TestAsset>(softAsset, 0, [&](AssetPtr<TestAsset>) -> void {
+            streamed.count_down();
+        });
+        streamed.wait();
+    };
+
+    AssetManager::Get().SetStreamingBudget(std::numeric_limits<size_t>::max());
+    stream(softAssets[0]);
+    const std::optional<AssetResidency> residency = AssetManager::Get().QueryResidency(softAssets[0].Uri());
+    ASSERT_TRUE(residency.has_value());
+    ASSERT_GT(residency->residentSize, 0);
+
+    // every asset has the same serialized size, so the budget holds two of them, assets streamed by other tests are
+    // older in LRU order and are evicted first
+    const auto evictedNum = AssetManager::Get().GetStreamingStats().evictedNum;
+    AssetManager::Get().SetStreamingBudget(residency->residentSize * 2);
+    stream(softAssets[1]);
+    ASSERT_NE(AssetManager::Get().GetStreamed(softAssets[0]), nullptr);
+    stream(softAssets[2]);
+
+    const AssetStreamingStats stats = AssetManager::Get().GetStreamingStats();
+    ASSERT_LE(stats.residentSize, stats.budget);
+    ASSERT_GT(stats.evictedNum, evictedNum);
+    ASSERT_EQ(AssetManager::Get().GetStreamed(softAssets[1]), nullptr);
+    ASSERT_EQ(AssetManager::Get().GetStreamed(softAssets[0])->a, 0);
+    ASSERT_EQ(AssetManager::Get().GetStreamed(softAssets[2])->a, 2);
+    AssetManager::Get().SetStreamingBudget(std::numeric_limits<size_t>::max());
+}
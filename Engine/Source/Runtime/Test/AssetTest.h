@@ -12,11 +12,15 @@ using namespace Runtime;
 struct EClass() TestAsset : public Asset {
     EClassBody(TestAsset)
 
+    // counts the assets created by asset manager for loading
+    static inline std::atomic<uint32_t> loadConstructedNum = 0;
+
     explicit TestAsset(Core::Uri uri)
         : Asset(std::move(uri))
         , a(0)
         , b()
     {
+        loadConstructedNum++;
     }
 
     TestAsset(Core::Uri inUri, uint32_t inA, std::string inB)
@@ -32,3 +36,47 @@ struct EClass() TestAsset : public Asset {
     EProperty()
     std::string b;
 };
+
+struct EClass() TestAssetGroup : public Asset {
+    EClassBody(TestAssetGroup)
+
+    explicit TestAssetGroup(Core::Uri uri)
+        : Asset(std::move(uri))
+    {
+    }
+
+    EProperty()
+    std::vector<AssetPtr<TestAsset>> members;
+};
+
+struct TestCycleAssetLink;
+
+struct EClass() TestCycleAsset : public Asset {
+    EClassBody(TestCycleAsset)
+
+    explicit TestCycleAsset(Core::Uri uri)
+        : Asset(std::move(uri))
+        , a(0)
+    {
+    }
+
+    TestCycleAsset(Core::Uri inUri, uint32_t inA)
+        : Asset(std::move(inUri))
+        , a(inA)
+    {
+    }
+
+    EProperty()
+    uint32_t a;
+
+    // an asset class can not refer to itself by AssetPtr before it is complete, so the refs are wrapped in links
+    EProperty()
+    std::vector<TestCycleAssetLink> links;
+};
+
+struct EClass() TestCycleAssetLink {
+    EClassBody(TestCycleAssetLink)
+
+    EProperty()
+    AssetPtr<TestCycleAsset> asset;
+};
@@ -4,6 +4,7 @@
 
 #include <ECSTest.h>
 #include <Test/Test.h>
+#include <Runtime/GameThread.h>
 
 TEST(ECSTest, EntityTest)
 {
@@ -31,6 +32,50 @@ TEST(ECSTest, EntityTest)
     });
 }
 
+TEST(ECSTest, EntityGenerationTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    registry.Destroy(entity0);
+    ASSERT_FALSE(registry.Valid(entity0));
+
+    const auto entity1 = registry.Create();
+    ASSERT_NE(entity0, entity1);
+    ASSERT_TRUE(registry.Valid(entity1));
+    ASSERT_FALSE(registry.Valid(entity0));
+    ASSERT_FALSE(registry.Has<CompA>(entity1));
+    ASSERT_EQ(registry.Count(), 1);
+}
+
+TEST(ECSTest, EntityChurnTest)
+{
+    constexpr size_t entityNum = 64;
+    constexpr size_t roundNum = 4;
+
+    // slots are recycled with generation increased, so handles of destroyed entities never become valid again
+    ECRegistry registry;
+    std::vector<Entity> entities;
+    std::vector<Entity> destroyedEntities;
+    entities.reserve(entityNum);
+    for (size_t i = 0; i < roundNum; i++) {
+        for (size_t j = 0; j < entityNum; j++) {
+            const auto entity = registry.Create();
+            registry.Emplace<CompA>(entity, static_cast<int>(j));
+            entities.emplace_back(entity);
+        }
+        for (const auto entity : entities) {
+            registry.Destroy(entity);
+            destroyedEntities.emplace_back(entity);
+        }
+        entities.clear();
+        for (const auto entity : destroyedEntities) {
+            ASSERT_FALSE(registry.Valid(entity));
+        }
+    }
+    ASSERT_EQ(registry.Count(), 0);
+}
+
 TEST(ECSTest, ComponentStaticTest)
 {
     ECRegistry registry;
@@ -183,6 +228,173 @@ TEST(ECSTest, ComponentDynamicTest)
     });
 }
 
+TEST(ECSTest, ComponentChunkTest)
+{
+    constexpr int entityNum = 5000;
+
+    ECRegistry registry;
+    std::vector<Entity> entities;
+    entities.reserve(entityNum);
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, i);
+        registry.Emplace<CompB>(entity, static_cast<float>(i));
+        entities.emplace_back(entity);
+    }
+
+    for (auto i = 0; i < entityNum; i += 2) {
+        registry.Remove<CompB>(entities[i]);
+    }
+    for (auto i = 1; i < entityNum; i += 2) {
+        ASSERT_EQ(registry.Get<CompA>(entities[i]).value, i);
+        ASSERT_EQ(registry.Get<CompB>(entities[i]).value, static_cast<float>(i));
+    }
+    for (auto i = 0; i < entityNum; i += 2) {
+        ASSERT_EQ(registry.Get<CompA>(entities[i]).value, i);
+        ASSERT_FALSE(registry.Has<CompB>(entities[i]));
+    }
+    ASSERT_EQ(registry.View<CompA>().Count(), entityNum);
+    ASSERT_EQ(registry.View<CompA>(Exclude<CompB> {}).Count(), entityNum / 2);
+
+    // growing an archetype allocates new chunks and never relocates existing components
+    const auto* compA = registry.Find<CompA>(entities[0]);
+    for (auto i = 0; i < entityNum; i++) {
+        registry.Emplace<CompA>(registry.Create(), i);
+    }
+    ASSERT_EQ(registry.Find<CompA>(entities[0]), compA);
+    ASSERT_EQ(compA->value, 0);
+}
+
+TEST(ECSTest, QueryTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    const auto entity1 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    registry.Emplace<CompA>(entity1, 2);
+
+    auto query = registry.Query<CompA>();
+    ASSERT_EQ(query.ArchetypeNum(), 1);
+    ASSERT_EQ(query.Count(), 2);
+
+    registry.Emplace<CompB>(entity1, 3.0f);
+    ASSERT_EQ(query.ArchetypeNum(), 2);
+    ASSERT_EQ(query.Count(), 2);
+
+    int sum = 0;
+    query.Each([&](Entity e, CompA& compA) -> void {
+        compA.value *= 2;
+        sum += compA.value;
+    });
+    ASSERT_EQ(sum, 6);
+    ASSERT_EQ(registry.Get<CompA>(entity1).value, 4);
+
+    const ECRegistry& constRegistry = registry;
+    auto constQuery = constRegistry.ConstQuery<CompA>(Exclude<CompB> {});
+    std::unordered_set expected = { entity0 };
+    ASSERT_EQ(constQuery.Count(), 1);
+    constQuery.Each([&](Entity e, const CompA& compA) -> void {
+        ASSERT_TRUE(expected.contains(e));
+        ASSERT_EQ(compA.value, 2);
+    });
+
+    registry.Clear();
+    ASSERT_EQ(query.Count(), 0);
+    ASSERT_EQ(constQuery.ArchetypeNum(), 0);
+}
+
+TEST(ECSTest, ParallelEachTest)
+{
+    constexpr int entityNum = 10000;
+
+    ECRegistry registry;
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = registry.Create();
+        registry.Emplace<CompA>(entity, i);
+        if (i % 2 == 0) {
+            registry.Emplace<CompB>(entity, 0.0f);
+        }
+    }
+
+    // chunks are spread over the game workers, each entity must be visited exactly once
+    auto& workerThreads = GameWorkerThreads::Get();
+    workerThreads.Start();
+    std::vector<std::atomic<uint32_t>> visitCounts(entityNum);
+    std::atomic<uint32_t> workerVisitCount = 0;
+
+    const auto view = registry.View<CompA, CompB>();
+    CommandBuffer commandBuffer;
+    view.ParallelEach([&](Entity e, CompA& compA, CompB& compB) -> void {
+        visitCounts[compA.value]++;
+        if (Core::ThreadContext::IsGameWorkerThread()) {
+            workerVisitCount++;
+        }
+        compB.value = static_cast<float>(compA.value);
+        commandBuffer.Remove<CompA>(e);
+    });
+    for (auto i = 0; i < entityNum; i++) {
+        ASSERT_EQ(visitCounts[i], i % 2 == 0 ? 1 : 0);
+    }
+    ASSERT_EQ(workerVisitCount, entityNum / 2);
+    ASSERT_EQ(commandBuffer.Count(), entityNum / 2);
+    ASSERT_EQ(view.Count(), entityNum / 2);
+
+    commandBuffer.Playback(registry);
+    ASSERT_TRUE(commandBuffer.Empty());
+    ASSERT_EQ(view.Count(), 0);
+    ASSERT_EQ(registry.View<CompA>().Count(), entityNum / 2);
+
+    auto query = registry.ConstQuery<CompB>();
+    query.ParallelEach([&](Entity e, const CompB& compB) -> void {
+        ASSERT_FALSE(registry.Has<CompA>(e));
+        ASSERT_EQ(static_cast<int>(compB.value) % 2, 0);
+    });
+    workerThreads.Stop();
+}
+
+TEST(ECSTest, CommandBufferTest)
+{
+    ECRegistry registry;
+    const auto entity0 = registry.Create();
+    const auto entity1 = registry.Create();
+    registry.Emplace<CompA>(entity0, 1);
+    registry.Emplace<CompA>(entity1, 2);
+
+    EventCounts count;
+    const auto constructedCallback = registry.Events<CompB>().onConstructed.BindLambda([&](ECRegistry&, Entity) -> void { count.onConstructed++; });
+    const auto removeCallback = registry.Events<CompA>().onRemove.BindLambda([&](ECRegistry&, Entity) -> void { count.onRemove++; });
+
+    CommandBuffer commandBuffer;
+    const auto placeholder = commandBuffer.Create();
+    commandBuffer.Emplace<CompA>(placeholder, 3);
+    commandBuffer.Emplace<CompB>(placeholder, 4.0f);
+    commandBuffer.Emplace<CompB>(entity0, 5.0f);
+    commandBuffer.Remove<CompA>(entity0);
+    commandBuffer.Emplace<CompA>(entity0, 6);
+    commandBuffer.Remove<CompA>(entity1);
+    const auto temp = commandBuffer.Create();
+    commandBuffer.Emplace<CompA>(temp, 7);
+    commandBuffer.Destroy(temp);
+    ASSERT_EQ(commandBuffer.Count(), 10);
+
+    commandBuffer.Playback(registry);
+    ASSERT_TRUE(commandBuffer.Empty());
+    ASSERT_EQ(registry.Count(), 3);
+
+    const auto entity2 = commandBuffer.GetCreated(placeholder);
+    ASSERT_TRUE(registry.Valid(entity2));
+    ASSERT_EQ(registry.Get<CompA>(entity2).value, 3);
+    ASSERT_EQ(registry.Get<CompB>(entity2).value, 4.0f);
+    ASSERT_EQ(registry.Get<CompA>(entity0).value, 6);
+    ASSERT_EQ(registry.Get<CompB>(entity0).value, 5.0f);
+    ASSERT_FALSE(registry.Has<CompA>(entity1));
+    ASSERT_EQ(registry.CompCount(entity1), 0);
+    ASSERT_EQ(count, EventCounts(2, 0, 2));
+
+    registry.Events<CompB>().onConstructed.Unbind(constructedCallback);
+    registry.Events<CompA>().onRemove.Unbind(removeCallback);
+}
+
 TEST(ECSTest, GlobalComponentStaticTest)
 {
     ECRegistry registry;
@@ -447,3 +659,96 @@ TEST(ECSTest, ECSRegistrySaveLoadTest)
         ASSERT_EQ(registry.GCompCount(), 2);
     }
 }
+
+TEST(ECSTest, ECSRegistryColumnSaveLoadTest)
+{
+    constexpr int entityNum = 5000;
+
+    ECArchive archive;
+    std::vector<Entity> entities;
+    entities.reserve(entityNum);
+    {
+        ECRegistry registry;
+        for (auto i = 0; i < entityNum; i++) {
+            const auto entity = registry.Create();
+            registry.Emplace<CompA>(entity, i);
+            if (i % 2 == 0) {
+                registry.Emplace<CompB>(entity, static_cast<float>(i));
+            }
+            if (i % 3 == 0) {
+                registry.Emplace<CompC>(entity, std::to_string(i));
+            }
+            entities.emplace_back(entity);
+        }
+        registry.Save(archive);
+    }
+    ASSERT_EQ(archive.archetypes.size(), 4);
+
+    ECRegistry registry;
+    uint32_t constructedCount = 0;
+    const auto handle = registry.Events<CompC>().onConstructed.BindLambda([&](ECRegistry&, Entity) -> void { constructedCount++; });
+    registry.Load(archive);
+    registry.Events<CompC>().onConstructed.Unbind(handle);
+
+    ASSERT_EQ(registry.Count(), entityNum);
+    ASSERT_EQ(constructedCount, (entityNum + 2) / 3);
+    for (auto i = 0; i < entityNum; i++) {
+        const auto entity = entities[i];
+        ASSERT_EQ(registry.Get<CompA>(entity).value, i);
+        ASSERT_EQ(registry.Has<CompB>(entity), i % 2 == 0);
+        ASSERT_EQ(registry.Has<CompC>(entity), i % 3 == 0);
+        if (i % 2 == 0) {
+            ASSERT_EQ(registry.Get<CompB>(entity).value, static_cast<float>(i));
+        }
+        if (i % 3 == 0) {
+            ASSERT_EQ(registry.Get<CompC>(entity).name, std::to_string(i));
+        }
+    }
+}
+
+TEST(ECSTest, ECSRegistryColumnLayoutChangedLoadTest)
+{
+    constexpr int entityNum = 16;
+
+    ECArchive archive;
+    std::vector<Entity> entities;
+    entities.reserve(entityNum);
+    {
+        ECRegistry registry;
+        for (auto i = 0; i < entityNum; i++) {
+            const auto entity = registry.Create();
+            registry.Emplace<CompA>(entity, i);
+            entities.emplace_back(entity);
+        }
+        registry.Save(archive);
+    }
+    ASSERT_EQ(archive.archetypes.size(), 1);
+    ASSERT_EQ(archive.archetypes[0].columns.size(), 1);
+
+    // pretend CompA was saved by an old layout with a removed member placed before value
+    auto& column = archive.archetypes[0].columns[0];
+    ASSERT_NE(column.layoutHash, 0);
+    ASSERT_EQ(column.members.size(), 1);
+    const CompMemberLayout valueLayout = column.members[0];
+    std::vector<uint8_t> oldData(entityNum * (sizeof(int) + valueLayout.size));
+    for (auto i = 0; i < entityNum; i++) {
+        uint8_t* elemBegin = oldData.data() + i * (sizeof(int) + valueLayout.size);
+        const int removed = -1;
+        memcpy(elemBegin, &removed, sizeof(int));
+        memcpy(elemBegin + sizeof(int), column.data.data() + i * column.elemSize + valueLayout.offset, valueLayout.size);
+    }
+    column.layoutHash = column.layoutHash + 1;
+    column.elemSize = sizeof(int) + valueLayout.size;
+    column.members = {
+        CompMemberLayout { "removed", valueLayout.typeName, 0, sizeof(int) },
+        CompMemberLayout { valueLayout.name, valueLayout.typeName, sizeof(int), valueLayout.size }
+    };
+    column.data = std::move(oldData);
+
+    ECRegistry registry;
+    registry.Load(archive);
+    ASSERT_EQ(registry.Count(), entityNum);
+    for (auto i = 0; i < entityNum; i++) {
+        ASSERT_EQ(registry.Get<CompA>(entities[i]).value, i);
+    }
+}
@@ -40,6 +40,19 @@ struct EClass() CompB {
     EProperty() float value;
 };
 
+struct EClass() CompC {
+    EClassBody(CompC)
+
+    CompC() = default;
+
+    explicit CompC(std::string inName)
+        : name(std::move(inName))
+    {
+    }
+
+    EProperty() std::string name;
+};
+
 struct EClass(globalComp) GCompA {
     EClassBody(GCompA)
 
@@ -5,6 +5,10 @@
 #include <WorldTest.h>
 #include <Test/Test.h>
 #include <Runtime/World.h>
+#include <Runtime/Component/Light.h>
+#include <Runtime/Component/Transform.h>
+#include <Runtime/Component/Scene.h>
+#include <Runtime/System/Scene.h>
 using namespace Runtime;
 
 struct WorldTest : testing::Test {
@@ -178,3 +182,174 @@ TEST_F(WorldTest, ConcurrentTest)
     }
     world.Stop();
 }
+
+AccessTest_WriteASystem::AccessTest_WriteASystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+}
+
+AccessTest_WriteASystem::~AccessTest_WriteASystem() = default;
+
+void AccessTest_WriteASystem::Tick(float inDeltaTimeSeconds)
+{
+    registry.GGet<GAccessTest_A>().value++;
+}
+
+AccessTest_WriteBSystem::AccessTest_WriteBSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+{
+}
+
+AccessTest_WriteBSystem::~AccessTest_WriteBSystem() = default;
+
+void AccessTest_WriteBSystem::Tick(float inDeltaTimeSeconds)
+{
+    registry.GGet<GAccessTest_B>().value++;
+}
+
+AccessTest_VerifySystem::AccessTest_VerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+    , tickCount(0)
+{
+    registry.GEmplace<GAccessTest_A>().value = 0;
+    registry.GEmplace<GAccessTest_B>().value = 0;
+}
+
+AccessTest_VerifySystem::~AccessTest_VerifySystem() = default;
+
+void AccessTest_VerifySystem::Tick(float inDeltaTimeSeconds)
+{
+    tickCount++;
+    ASSERT_EQ(registry.GGet<GAccessTest_A>().value, tickCount);
+    ASSERT_EQ(registry.GGet<GAccessTest_B>().value, tickCount);
+}
+
+TEST_F(WorldTest, AccessDeclarationTest)
+{
+    const auto& writeAClass = AccessTest_WriteASystem::GetStaticClass();
+    const auto& writeBClass = AccessTest_WriteBSystem::GetStaticClass();
+    const auto& verifyClass = AccessTest_VerifySystem::GetStaticClass();
+
+    SystemGraph systemGraph;
+    auto& writeGroup = systemGraph.AddGroup("WriteGroup", SystemExecuteStrategy::sequential);
+    writeGroup.EmplaceSystemDyn(&writeAClass);
+    writeGroup.EmplaceSystemDyn(&writeBClass);
+    auto& verifyGroup = systemGraph.AddGroup("VerifyGroup", SystemExecuteStrategy::sequential);
+    verifyGroup.EmplaceSystemDyn(&verifyClass);
+
+    const auto& writeAFactory = systemGraph.GetGroup("WriteGroup").GetSystemDyn(&writeAClass);
+    const auto& writeBFactory = systemGraph.GetGroup("WriteGroup").GetSystemDyn(&writeBClass);
+    const auto& verifyFactory = systemGraph.GetGroup("VerifyGroup").GetSystemDyn(&verifyClass);
+    ASSERT_TRUE(writeAFactory.HasAccessDeclared());
+    ASSERT_FALSE(writeAFactory.ConflictsWith(writeBFactory));
+    ASSERT_TRUE(writeAFactory.ConflictsWith(verifyFactory));
+    ASSERT_TRUE(writeBFactory.ConflictsWith(verifyFactory));
+    ASSERT_FALSE(writeAFactory.HasStructuralWrites());
+    ASSERT_FALSE(verifyFactory.HasStructuralWrites());
+
+    // write systems are independent, verify system depends on both of them by reading what they write, the verify
+    // system emplaces globals in its constructor, which runs outside of the access checked pipeline
+    const SystemPipeline pipeline(systemGraph);
+    ASSERT_EQ(pipeline.GetSystemNum(), 3);
+    ASSERT_EQ(pipeline.GetDependencyNum(), 2);
+
+    World world("TestWorld", nullptr, PlayType::game);
+    world.SetSystemGraph(systemGraph);
+    world.Play();
+    for (auto i = 0; i < 5; i++) {
+        engine->Tick(0.0167f);
+    }
+    world.Stop();
+}
+
+TEST_F(WorldTest, StructuralWritesOrderTest)
+{
+    SystemGraph systemGraph;
+    auto& concurrentGroup = systemGraph.AddGroup("ConcurrentGroup", SystemExecuteStrategy::concurrent);
+    concurrentGroup.EmplaceSystem<AccessTest_WriteASystem>();
+    concurrentGroup.EmplaceSystem<AccessTest_WriteBSystem>();
+    const SystemPipeline independentPipeline(systemGraph);
+    ASSERT_EQ(independentPipeline.GetDependencyNum(), 0);
+
+    // a system making structural changes is ordered even against systems of a concurrent group
+    concurrentGroup.GetSystem<AccessTest_WriteBSystem>().WritesStructure();
+    const SystemPipeline structuralPipeline(systemGraph);
+    ASSERT_EQ(structuralPipeline.GetDependencyNum(), 1);
+}
+
+static Render::Scene* sceneDeltaTestScene = nullptr;
+static std::vector<Entity> sceneDeltaTestLights;
+
+SceneDeltaTest_SpawnSystem::SceneDeltaTest_SpawnSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext)
+    : System(inRegistry, inContext)
+    , tickCount(0)
+{
+}
+
+SceneDeltaTest_SpawnSystem::~SceneDeltaTest_SpawnSystem() = default;
+
+void SceneDeltaTest_SpawnSystem::Tick(float inDeltaTimeSeconds)
+{
+    sceneDeltaTestScene = registry.GGet<SceneHolder>().scene;
+    if (tickCount == 0) {
+        sceneDeltaTestLights = { registry.Create(), registry.Create(), registry.Create() };
+        registry.Emplace<DirectionalLight>(sceneDeltaTestLights[0]);
+        registry.Emplace<PointLight>(sceneDeltaTestLights[1]);
+        registry.Emplace<SpotLight>(sceneDeltaTestLights[2]);
+        for (const auto entity : sceneDeltaTestLights) {
+            registry.Emplace<WorldTransform>(entity);
+        }
+    } else if (tickCount == 1) {
+        registry.Update<WorldTransform>(sceneDeltaTestLights[0], [](WorldTransform& transform) -> void {
+            transform.localToWorld = Common::FTransform(Common::FQuatConsts::identity, Common::FVec3(1.0f, 2.0f, 3.0f));
+        });
+        registry.Update<PointLight>(sceneDeltaTestLights[1], [](PointLight& light) -> void {
+            light.intensity = 2.0f;
+        });
+        registry.Remove<SpotLight>(sceneDeltaTestLights[2]);
+    }
+    tickCount++;
+}
+
+TEST_F(WorldTest, SceneDeltaFlushTest)
+{
+    SystemGraph systemGraph;
+    auto& spawnGroup = systemGraph.AddGroup("SpawnGroup", SystemExecuteStrategy::sequential);
+    spawnGroup.EmplaceSystem<SceneDeltaTest_SpawnSystem>();
+    auto& sceneGroup = systemGraph.AddGroup("SceneGroup", SystemExecuteStrategy::sequential);
+    sceneGroup.EmplaceSystem<SceneSystem>();
+
+    // reads the render scene on render thread, after the deltas flushed by the last tick are applied
+    auto& renderThread = engine->GetRenderModule().GetRenderThread();
+    const auto querySceneAppliedDeltasNum = [&]() -> uint64_t {
+        return renderThread.EmplaceTask([]() -> uint64_t { return sceneDeltaTestScene->GetAppliedDeltasNum(); }).get();
+    };
+
+    World world("TestWorld", nullptr, PlayType::game);
+    world.SetSystemGraph(systemGraph);
+    world.Play();
+
+    // all changes of one tick reach render thread in one batch
+    engine->Tick(0.0167f);
+    ASSERT_EQ(querySceneAppliedDeltasNum(), 1);
+    renderThread.EmplaceTask([]() -> void {
+        ASSERT_EQ(sceneDeltaTestScene->GetSceneProxies<Render::LightSceneProxy>().Count(), 3);
+    }).get();
+
+    engine->Tick(0.0167f);
+    ASSERT_EQ(querySceneAppliedDeltasNum(), 2);
+    renderThread.EmplaceTask([]() -> void {
+        const auto expectedLocalToWorld = WorldTransform(Common::FTransform(Common::FQuatConsts::identity, Common::FVec3(1.0f, 2.0f, 3.0f))).localToWorld.GetTransformMatrixNoScale();
+        ASSERT_EQ(sceneDeltaTestScene->GetSceneProxies<Render::LightSceneProxy>().Count(), 2);
+        ASSERT_EQ(sceneDeltaTestScene->Get<Render::LightSceneProxy>(sceneDeltaTestLights[0]).localToWorld, expectedLocalToWorld);
+        ASSERT_EQ(sceneDeltaTestScene->Get<Render::LightSceneProxy>(sceneDeltaTestLights[1]).intensity, 2.0f);
+    }).get();
+
+    // nothing changed, so nothing is flushed
+    engine->Tick(0.0167f);
+    ASSERT_EQ(querySceneAppliedDeltasNum(), 2);
+
+    world.Stop();
+    sceneDeltaTestScene = nullptr;
+    sceneDeltaTestLights.clear();
+}
@@ -84,3 +84,55 @@ struct EClass() ConcurrentTest_VerifySystem : public Runtime::System {
 
     void Tick(float inDeltaTimeSeconds) override;
 };
+
+struct EClass(globalComp) GAccessTest_A {
+    EClassBody(GAccessTest_A)
+
+    uint32_t value;
+};
+
+struct EClass(globalComp) GAccessTest_B {
+    EClassBody(GAccessTest_B)
+
+    uint32_t value;
+};
+
+struct EClass(systemWrites=GAccessTest_A) AccessTest_WriteASystem : public Runtime::System {
+    EPolyClassBody(AccessTest_WriteASystem)
+
+    explicit AccessTest_WriteASystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AccessTest_WriteASystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+struct EClass(systemWrites=GAccessTest_B) AccessTest_WriteBSystem : public Runtime::System {
+    EPolyClassBody(AccessTest_WriteBSystem)
+
+    explicit AccessTest_WriteBSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AccessTest_WriteBSystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+};
+
+struct EClass(systemReads=GAccessTest_A;GAccessTest_B) AccessTest_VerifySystem : public Runtime::System {
+    EPolyClassBody(AccessTest_VerifySystem)
+
+    explicit AccessTest_VerifySystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~AccessTest_VerifySystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+
+    uint32_t tickCount;
+};
+
+struct EClass() SceneDeltaTest_SpawnSystem : public Runtime::System {
+    EPolyClassBody(SceneDeltaTest_SpawnSystem)
+
+    explicit SceneDeltaTest_SpawnSystem(Runtime::ECRegistry& inRegistry, const Runtime::SystemSetupContext& inContext);
+    ~SceneDeltaTest_SpawnSystem() override;
+
+    void Tick(float inDeltaTimeSeconds) override;
+
+    uint32_t tickCount;
+};
@@ -102,7 +102,8 @@ void TriangleApplication::OnDrawFrame()
     frameFence->Reset();
     const auto backTextureIndex = swapChain->AcquireBackTexture(imageReadySemaphore.Get());
 
-    auto* pso = PipelineCache::Get(*device).GetOrCreate(
+    // the pipeline is compiled on render worker threads, frames before it is ready only clear the back buffer
+    auto* pso = PipelineCache::Get(*device).GetOrCreateAsync(
         RasterPipelineStateDesc()
             .SetVertexShader(triangleVS)
             .SetPixelShader(trianglePS)
@@ -118,31 +119,31 @@ void TriangleApplication::OnDrawFrame()
     RGBuilder builder(*device);
     auto* backTexture = builder.ImportTexture(swapChainTextures[backTextureIndex], TextureState::present);
     auto* backTextureView = builder.CreateTextureView(backTexture, RGTextureViewDesc(TextureViewType::colorAttachment, TextureViewDimension::tv2D));
-    auto* vertexBuffer = builder.ImportBuffer(triangleVertexBuffer.Get(), BufferState::shaderReadOnly);
-    auto* vertexBufferView = builder.CreateBufferView(vertexBuffer, RGBufferViewDesc(BufferViewType::vertex, vertexBuffer->GetDesc().size, 0, VertexBufferViewInfo(sizeof(Vertex))));
-    auto* psUniformBuffer = builder.CreateBuffer(RGBufferDesc(sizeof(PsUniform), BufferUsageBits::uniform | BufferUsageBits::mapWrite, BufferState::staging, "psUniform"));
-    auto* psUniformBufferView = builder.CreateBufferView(psUniformBuffer, RGBufferViewDesc(BufferViewType::uniformBinding, sizeof(PsUniform)));
 
-    auto* bindGroup = builder.AllocateBindGroup(
-        RGBindGroupDesc::Create(pso->GetPipelineLayout()->GetBindGroupLayout(0))
-            .UniformBuffer("psUniform", psUniformBufferView));
-
-    PsUniform psUniform {};
-    psUniform.pixelColor = FVec3(
-        (std::sin(GetCurrentTimeSeconds()) + 1) / 2,
-        (std::cos(GetCurrentTimeSeconds()) + 1) / 2,
-        std::abs(std::sin(GetCurrentTimeSeconds())));
-
-    builder.QueueBufferUpload(
-        psUniformBuffer,
-        RGBufferUploadInfo(&psUniform, sizeof(PsUniform)));
-
-    builder.AddRasterPass(
-        "BasePass",
-        RGRasterPassDesc()
-            .AddColorAttachment(RGColorAttachment(backTextureView, LoadOp::clear, StoreOp::store)),
-        { bindGroup },
-        [pso, vertexBufferView, bindGroup, viewportWidth = GetWindowWidth(), viewportHeight = GetWindowHeight()](const RGBuilder& rg, RasterPassCommandRecorder& recorder) -> void {
+    std::vector<RGBindGroupRef> bindGroups;
+    RGRasterPassExecuteFunc drawFunc = [](const RGBuilder&, RasterPassCommandRecorder&) -> void {};
+    if (pso != nullptr) {
+        auto* vertexBuffer = builder.ImportBuffer(triangleVertexBuffer.Get(), BufferState::shaderReadOnly);
+        auto* vertexBufferView = builder.CreateBufferView(vertexBuffer, RGBufferViewDesc(BufferViewType::vertex, vertexBuffer->GetDesc().size, 0, VertexBufferViewInfo(sizeof(Vertex))));
+        auto* psUniformBuffer = builder.CreateBuffer(RGBufferDesc(sizeof(PsUniform), BufferUsageBits::uniform | BufferUsageBits::mapWrite, BufferState::staging, "psUniform"));
+        auto* psUniformBufferView = builder.CreateBufferView(psUniformBuffer, RGBufferViewDesc(BufferViewType::uniformBinding, sizeof(PsUniform)));
+
+        auto* bindGroup = builder.AllocateBindGroup(
+            RGBindGroupDesc::Create(pso->GetPipelineLayout()->GetBindGroupLayout(0))
+                .UniformBuffer("psUniform", psUniformBufferView));
+
+        PsUniform psUniform {};
+        psUniform.pixelColor = FVec3(
+            (std::sin(GetCurrentTimeSeconds()) + 1) / 2,
+            (std::cos(GetCurrentTimeSeconds()) + 1) / 2,
+            std::abs(std::sin(GetCurrentTimeSeconds())));
+
+        builder.QueueBufferUpload(
+            psUniformBuffer,
+            RGBufferUploadInfo(&psUniform, sizeof(PsUniform)));
+
+        bindGroups.emplace_back(bindGroup);
+        drawFunc = [pso, vertexBufferView, bindGroup, viewportWidth = GetWindowWidth(), viewportHeight = GetWindowHeight()](const RGBuilder& rg, RasterPassCommandRecorder& recorder) -> void {
             recorder.SetPipeline(pso->GetRHI());
             recorder.SetScissor(0, 0, viewportWidth, viewportHeight);
             recorder.SetViewport(0, 0, static_cast<float>(viewportWidth), static_cast<float>(viewportHeight), 0, 1);
@@ -150,7 +151,15 @@ void TriangleApplication::OnDrawFrame()
             recorder.SetPrimitiveTopology(PrimitiveTopology::triangleList);
             recorder.SetBindGroup(0, rg.GetRHI(bindGroup));
             recorder.Draw(3, 1, 0, 0);
-        },
+        };
+    }
+
+    builder.AddRasterPass(
+        "BasePass",
+        RGRasterPassDesc()
+            .AddColorAttachment(RGColorAttachment(backTextureView, LoadOp::clear, StoreOp::store)),
+        bindGroups,
+        drawFunc,
         {},
         [backTexture](const RGBuilder& rg, CommandRecorder& recorder) -> void {
             recorder.ResourceBarrier(Barrier::Transition(rg.GetRHI(backTexture), TextureState::renderTarget, TextureState::present));